@@ -98,7 +98,7 @@ void PIO_Initialize ( void )
    PIOA_REGS->PIO_CODR = 0x1f00000U;
 
  /* Port B Peripheral function A configuration */
-   PIOB_REGS->PIO_MSKR = 0x600U;
+   PIOB_REGS->PIO_MSKR = 0x2600U;
    PIOB_REGS->PIO_CFGR = 0x1U;
 
  /* Port B Peripheral function GPIO configuration */
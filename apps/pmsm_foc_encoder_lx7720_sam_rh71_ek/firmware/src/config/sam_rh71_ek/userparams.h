@@ -45,6 +45,19 @@
 #define MOTOR_2_CUSTOM_MOTOR                             (2U)    /* Custom Motor 2 */
 #define MOTOR_3_HURST_DMA0204024B101                     (3U)    /* Long Hurst Motor */
 
+#define BEMF_OBSERVER_OFF                                (0U)    /* Encoder angle only */
+#define BEMF_OBSERVER_SHADOW                             (1U)    /* Observer cross-checks the encoder */
+#define BEMF_OBSERVER_PRIMARY                            (2U)    /* Observer angle drives the FOC */
+
+#define POSITION_SENSOR_ENCODER                          (0U)    /* Quadrature encoder on TC1 */
+#define POSITION_SENSOR_RESOLVER                         (1U)    /* Resolver through the LX7720 */
+
+#define SPEED_LOOP_RATE_MEDIUM                           (0U)    /* Speed loop in the medium rate task */
+#define SPEED_LOOP_RATE_SLOW                             (1U)    /* Speed loop in the slow rate task */
+
+#define SPEED_RAMP_LINEAR                                (0U)    /* Constant acceleration, steps at the ends */
+#define SPEED_RAMP_SCURVE                                (1U)    /* Jerk limited, acceleration ramps in and out */
+
 /***********************************************************************************************/
 /* USER CONFIGURABLE PARAMETERS - START                                                        */
 /***********************************************************************************************/
@@ -55,6 +68,93 @@
 
 #define TORQUE_MODE                                      (0U)  /* If enabled - torque control */
                                                                /* If disabled (default) - speed control*/
+#define POSITION_MODE                                    (0U)  /* If enabled - position control: jerk limited trajectory and */
+                                                               /* position loop feeding the speed loop. TORQUE_MODE must be disabled */
+#define SINCOS_METHOD                                    (MCLIB_SINCOS_LUT)  /* MCLIB_SINCOS_LUT (default) - interpolated table */
+                                                               /* MCLIB_SINCOS_POLY - minimax polynomial */
+                                                               /* MCLIB_SINCOS_CORDIC - fixed iteration CORDIC */
+#define SINCOS_BENCHMARK                                 (0U)  /* If enabled - sine/cosine cycles and error are */
+                                                               /* measured at power up, see gSinCosBenchmark */
+#define SVPWM_METHOD                                     (MCLIB_SVPWM_SECTOR)  /* MCLIB_SVPWM_SECTOR (default) - six sector tree */
+                                                               /* MCLIB_SVPWM_MINMAX - min/max injection, constant time */
+#define ENABLE_SPEED_MT                                  (0U)  /* If enabled - M/T encoder speed measurement at fast loop rate, */
+                                                               /* the speed loop uses the M/T speed. Disable ENABLE_ANGLE_PLL */
+                                                               /* If disabled - position difference over the slow loop */
+#define ENABLE_ANGLE_PLL                                 (1U)  /* If enabled - encoder angle tracking PLL at fast loop rate, */
+                                                               /* the speed loop uses the PLL speed */
+#define ANGLE_PLL_FOC_ANGLE                              (0U)  /* If enabled - FOC uses the interpolated PLL angle */
+                                                               /* If disabled - FOC uses the encoder count angle */
+#define ENABLE_INDEX_ALIGNMENT                           (1U)  /* If enabled - encoder index (Z) pulse sets the angle offset, */
+                                                               /* the long startup lock is skipped once the offset is known. */
+                                                               /* Z is read on TC1_TIOB4 (PB13) */
+#define ENABLE_ENCODER_CALIBRATION                       (0U)  /* If enabled - the first start after power up spins the motor open loop */
+                                                               /* one revolution each way instead of the lock: fits the encoder offset */
+                                                               /* and direction, checks the pole pairs. Skipped once */
+                                                               /* ENCODER_INDEX_OFFSET_COUNT is set */
+#define ENABLE_LOCK_SETTLE_DETECTION                     (0U)  /* If enabled - the startup lock ramps the current in and ends each */
+                                                               /* step once the encoder shows the rotor still, LOCK_TIME_IN_SEC */
+                                                               /* is the timeout. If disabled - fixed LOCK_TIME_IN_SEC steps */
+#define ENABLE_INITIAL_POSITION_DETECTION                (0U)  /* If enabled - the first start after power up finds the rotor angle */
+                                                               /* from inductance saliency pulses instead of the lock, without */
+                                                               /* moving the rotor. Falls back to the lock on a motor without enough */
+                                                               /* saliency. Disable ENABLE_ENCODER_CALIBRATION */
+#define ENABLE_FLYING_START                              (0U)  /* If enabled - a restart catches a still spinning rotor: the encoder */
+                                                               /* speed is measured before the PWM starts, the speed ramp, speed */
+                                                               /* estimators and current integrators start from it. The first */
+                                                               /* start after power up still aligns. POSITION_MODE must be disabled */
+#define POSITION_SENSOR                                  (POSITION_SENSOR_ENCODER)  /* POSITION_SENSOR_ENCODER (default) - TC1 quadrature encoder */
+                                                               /* POSITION_SENSOR_RESOLVER - software resolver to digital converter, */
+                                                               /* disable ENABLE_SPEED_MT, ENABLE_ANGLE_PLL, ENABLE_INDEX_ALIGNMENT, */
+                                                               /* ENABLE_ENCODER_CALIBRATION, ENABLE_LOCK_SETTLE_DETECTION, */
+                                                               /* ENABLE_INITIAL_POSITION_DETECTION, ENABLE_FLYING_START */
+                                                               /* and POSITION_MODE */
+#define BEMF_OBSERVER_MODE                               (BEMF_OBSERVER_OFF)  /* BEMF_OBSERVER_OFF (default) - no observer */
+                                                               /* BEMF_OBSERVER_SHADOW - back EMF observer checks the encoder */
+                                                               /* angle, and replaces it once the encoder is found faulty */
+                                                               /* BEMF_OBSERVER_PRIMARY - observer angle above its min speed, */
+                                                               /* encoder angle at startup and low speed */
+#define ENABLE_Q31_CURRENT_LOOP                          (0U)  /* If enabled - fast current loop runs on the Q31 */
+                                                               /* fixed point library (mclib_generic_q31) */
+#define Q31_BENCHMARK                                    (0U)  /* If enabled - cycles of the float and the Q31 current */
+                                                               /* loop are measured at power up, see gQ31Benchmark */
+#define ENABLE_OFFSET_TRACKING                           (1U)  /* If enabled - current sense offsets are measured at power up */
+                                                               /* and follow their drift while the bridge is off */
+                                                               /* If disabled - offsets are measured before each start */
+#define ENABLE_RATE_INTERRUPTS                           (1U)  /* If enabled - medium and slow rate tasks run in their own */
+                                                               /* software interrupts, released by the fast loop */
+                                                               /* If disabled - rate tasks polled by MCAPP_Tasks */
+#define ENABLE_IDLE_SLEEP                                (1U)  /* If enabled - the background sleeps (WFI) until an interrupt */
+                                                               /* posts an event. If disabled - it polls its events: */
+                                                               /* for debug probes which lose the core in sleep */
+#define SPEED_LOOP_RATE                                  (SPEED_LOOP_RATE_SLOW)  /* SPEED_LOOP_RATE_SLOW (default) - speed ramp and */
+                                                               /* speed loop at SLOW_LOOP_TIME_SEC */
+                                                               /* SPEED_LOOP_RATE_MEDIUM - at MEDIUM_LOOP_TIME_SEC; the speed PI */
+                                                               /* gains are per sample: retune SPEEDCNTR_ITERM and CTERM */
+
+#if((POSITION_MODE == true) && (TORQUE_MODE == true))
+#error "POSITION_MODE needs the speed loop: disable TORQUE_MODE"
+#endif
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+#if((ENABLE_SPEED_MT == true) || (ENABLE_ANGLE_PLL == true) || (ENABLE_INDEX_ALIGNMENT == true) || (POSITION_MODE == true))
+#error "The resolver has its own tracking loop: disable ENABLE_SPEED_MT, ENABLE_ANGLE_PLL, ENABLE_INDEX_ALIGNMENT and POSITION_MODE"
+#endif
+#if((ENABLE_ENCODER_CALIBRATION == true) || (ENABLE_LOCK_SETTLE_DETECTION == true))
+#error "ENABLE_ENCODER_CALIBRATION and ENABLE_LOCK_SETTLE_DETECTION need the quadrature encoder"
+#endif
+#if((ENABLE_INITIAL_POSITION_DETECTION == true) || (ENABLE_FLYING_START == true))
+#error "ENABLE_INITIAL_POSITION_DETECTION and ENABLE_FLYING_START need the quadrature encoder"
+#endif
+#endif
+#if((ENABLE_SPEED_MT == true) && (ENABLE_ANGLE_PLL == true))
+#error "ENABLE_SPEED_MT and ENABLE_ANGLE_PLL both measure the encoder speed for the speed loop: enable one"
+#endif
+#if((ENABLE_INITIAL_POSITION_DETECTION == true) && (ENABLE_ENCODER_CALIBRATION == true))
+#error "ENABLE_INITIAL_POSITION_DETECTION and ENABLE_ENCODER_CALIBRATION both replace the first lock: enable one"
+#endif
+#if((ENABLE_FLYING_START == true) && (POSITION_MODE == true))
+#error "ENABLE_FLYING_START restarts the speed loop: disable POSITION_MODE"
+#endif
+
 /***********************************************************************************************/
 /* Motor Configuration Parameters */
 /***********************************************************************************************/
@@ -67,29 +167,29 @@
 #define MOTOR_PER_PHASE_RESISTANCE                          ((float)0.9)
 #define MOTOR_PER_PHASE_INDUCTANCE                          ((float)0.0012)
 #define MOTOR_BEMF_CONST_V_PEAK_LL_KRPM_MECH                ((float)3.6)
-#define NUM_POLE_PAIRS                                      ((float)4)
-#define RATED_SPEED_RPM                                     ((float)4000)
-#define MAX_SPEED_RPM                                       ((float)4000)
-#define ENCODER_PULSES_PER_REV                              ((float)1024)
+#define NUM_POLE_PAIRS                                      (4U)
+#define RATED_SPEED_RPM                                     (4000U)
+#define MAX_SPEED_RPM                                       (4000U)
+#define ENCODER_PULSES_PER_REV                              (1024U)
 
 #elif(MOTOR == MOTOR_2_CUSTOM_MOTOR)
 
 #define MOTOR_PER_PHASE_RESISTANCE                          ((float)2.10)
 #define MOTOR_PER_PHASE_INDUCTANCE                          ((float)0.00192)
 #define MOTOR_BEMF_CONST_V_PEAK_LL_KRPM_MECH                ((float)7.24)
-#define NUM_POLE_PAIRS                                      ((float)5)
-#define RATED_SPEED_RPM                                     ((float)2054)
-#define MAX_SPEED_RPM                                       ((float)4000)
+#define NUM_POLE_PAIRS                                      (5U)
+#define RATED_SPEED_RPM                                     (2054U)
+#define MAX_SPEED_RPM                                       (4000U)
 
 #elif(MOTOR == MOTOR_3_HURST_DMA0204024B101)
 /* Hurst motor part number - DMB0224C10002 */
 #define MOTOR_PER_PHASE_RESISTANCE                          ((float)0.285)
 #define MOTOR_PER_PHASE_INDUCTANCE                          ((float)0.00032)
 #define MOTOR_BEMF_CONST_V_PEAK_LL_KRPM_MECH                ((float)13.57)
-#define NUM_POLE_PAIRS                                      ((float)5)
-#define RATED_SPEED_RPM                                     ((float)2804)
-#define MAX_SPEED_RPM                                       ((float)3644)
-#define ENCODER_PULSES_PER_REV                              ((float)1000)
+#define NUM_POLE_PAIRS                                      (5U)
+#define RATED_SPEED_RPM                                     (2804U)
+#define MAX_SPEED_RPM                                       (3644U)
+#define ENCODER_PULSES_PER_REV                              (1000U)
 
 #endif 
 
@@ -158,6 +258,28 @@
 
 #endif
 
+/******************************************************************************/
+/* PI gain scheduling -                                                       */
+/* Gains are interpolated from a table indexed by the electrical speed and    */
+/* scaled by a second table indexed by the q-axis current reference.          */
+/* Default table entries equal the fixed gains above, so the tables only      */
+/* change the behavior once they are tuned (at runtime through X2Cscope).     */
+#define ENABLE_GAIN_SCHEDULING                           (1U)  /* If enabled - gains follow the tables */
+                                                               /* If disabled - fixed gains above */
+#define GAIN_SCHED_SPEED_POINTS                          (4U)  /* Number of speed breakpoints */
+#define GAIN_SCHED_IQ_POINTS                             (3U)  /* Number of iq breakpoints */
+
+/* Speed breakpoints in electrical rad/s, must be increasing */
+#define GAIN_SCHED_SPEED_0                               (0.0f)
+#define GAIN_SCHED_SPEED_1                               (300.0f)
+#define GAIN_SCHED_SPEED_2                               (600.0f)
+#define GAIN_SCHED_SPEED_3                               (900.0f)
+
+/* iq breakpoints in Amps, must be increasing */
+#define GAIN_SCHED_IQ_0                                  (0.0f)
+#define GAIN_SCHED_IQ_1                                  (0.5f * MAX_CURRENT)
+#define GAIN_SCHED_IQ_2                                  (MAX_CURRENT)
+
 /* First order low pass Filter constants used inside the project  */
 
 #define KFILTER_ESDQ                   (float)((float)200/(float)32767)
@@ -176,6 +298,7 @@
  * (x * 0.025 * 15) + 1.65V = 3.3V
  * x = 4.4Amps */
 #define MAX_CURRENT                                         ((float)(0.6)) /* Max current as per above calculations */
+#define Q31_CURRENT_BASE                                    ((float)(4.0f * MAX_CURRENT)) /* Current of 1.0 per unit in the Q31 loop */
 #define MAX_ADC_COUNT                                       (float)4095     /* 12-bit ADC */
 #define MAX_ADC_INPUT_VOLTAGE                               (float)3.3      /* volts */
 
@@ -195,6 +318,18 @@
 #define PWM_FREQUENCY                                       (20000U)
 /** Phase Current Offset calibration samples */
 #define CURRENTS_OFFSET_SAMPLES                             (128U)
+/** Phase Current Offset calibration: sinc3 samples dropped first, the filter settles */
+#define CURRENTS_OFFSET_SKIP_SAMPLES                        (10U)
+/** Sigma delta current and resolver sense: TC0 channel 1 period, max count of a sinc1 sample */
+#define SIGMA_DELTA_SINC1_PERIOD_COUNT                      (200U)
+/** Sigma delta: sinc1 samples per sinc3 sample */
+#define SIGMA_DELTA_SINC3_DECIMATION                        (5U)
+#define SIGMA_DELTA_SINC3_FREQUENCY   (MASTER_CLK_FREQUENCY / (SIGMA_DELTA_SINC1_PERIOD_COUNT * SIGMA_DELTA_SINC3_DECIMATION))
+#define SIGMA_DELTA_SINC3_FULL_SCALE  (SIGMA_DELTA_SINC1_PERIOD_COUNT * SIGMA_DELTA_SINC3_DECIMATION * SIGMA_DELTA_SINC3_DECIMATION * SIGMA_DELTA_SINC3_DECIMATION)
+
+#if(((MASTER_CLK_FREQUENCY % (2U * PWM_FREQUENCY)) != 0U) || ((MASTER_CLK_FREQUENCY / (2U * PWM_FREQUENCY)) > 0xFFFFU))
+#error "PWM_PERIOD_COUNT must be a whole number of counts of the 16 bit PWM timer"
+#endif
 /**********************************************************************************************/
 
 /*******************************************************************************/
@@ -207,13 +342,184 @@
 
 #define MAX_DUTY                        (PWM_PERIOD_COUNT)
 #define FAST_LOOP_TIME_SEC              (float)(1.0f/(float)PWM_FREQUENCY) /* Always runs in sync with PWM */
-#define SLOW_LOOP_TIME_SEC              (float)(FAST_LOOP_TIME_SEC * 100.0f) /* 100 times slower than Fast Loop */
+#define MEDIUM_LOOP_TIME_PWM_COUNT      (10U)  /* 10 times slower than Fast Loop */
+#define SLOW_LOOP_TIME_PWM_COUNT        (100U) /* 100 times slower than Fast Loop */
+#define MEDIUM_LOOP_TIME_SEC            (float)(FAST_LOOP_TIME_SEC * (float)MEDIUM_LOOP_TIME_PWM_COUNT)
+#define SLOW_LOOP_TIME_SEC              (float)(FAST_LOOP_TIME_SEC * (float)SLOW_LOOP_TIME_PWM_COUNT)
+#if((MEDIUM_LOOP_TIME_PWM_COUNT == 0U) || (MEDIUM_LOOP_TIME_PWM_COUNT > SLOW_LOOP_TIME_PWM_COUNT))
+#error "Rates must be ordered: fast, medium, slow"
+#endif
+
+/* M/T speed measurement: a window closes on the first encoder edge after the min time */
+#define SPEED_MT_MIN_WINDOW_MS          (5U)     /* Min window: shorter - more bandwidth, less resolution at high speed */
+#define SPEED_MT_MAX_WINDOW_MS          (20U)    /* No edge in this time - speed is zero */
+#if(((SPEED_MT_MIN_WINDOW_MS * PWM_FREQUENCY) < 1000U) || (SPEED_MT_MIN_WINDOW_MS >= SPEED_MT_MAX_WINDOW_MS))
+#error "M/T speed windows must be ordered and at least one fast loop long"
+#endif
+
+/* Encoder angle tracking PLL: type II loop, critically damped */
+#define ANGLE_PLL_BANDWIDTH_HZ          (100.0f) /* Higher - less lag, more speed noise */
+#define ANGLE_PLL_DAMPING               (1.0f)
+
+/* Back EMF observer: alpha/beta back EMF from the motor model, angle and speed from a PLL on it.
+   Phase voltages are the PWM references scaled by DC_BUS_VOLTAGE */
+#define BEMF_OBSERVER_MIN_SPEED_RPM     (300.0f) /* Below this the back EMF is too small, the encoder angle is used */
+#define BEMF_OBSERVER_FILTER_RATIO      (2U)     /* Esd/Esq filter corner in times the electrical speed */
+#define BEMF_OBSERVER_FAULT_ANGLE_DEG   (30.0f)  /* Observer to encoder angle error seen as an encoder fault... */
+#define BEMF_OBSERVER_FAULT_TIME_MS     (20U)    /* ...once it lasts this long */
+/* Filter corner below the fast loop rate at MAX_SPEED_RPM: 2*PI taken as 44/7, from above */
+#if((BEMF_OBSERVER_FILTER_RATIO * MAX_SPEED_RPM * NUM_POLE_PAIRS * 44U) >= (420U * PWM_FREQUENCY))
+#error "Back EMF observer filter must be slower than the fast loop at MAX_SPEED_RPM"
+#endif
+#if((BEMF_OBSERVER_FAULT_TIME_MS * PWM_FREQUENCY) < 1000U)
+#error "Back EMF observer fault time must be at least one fast loop"
+#endif
+
+/* Resolver to digital conversion. The LX7720 excitation input is driven by PWM0 channel 3 (PWMH3),
+   the sine and cosine sense bitstreams gate TC2 channel 0 and 1 through XC0 and XC1 (TCLK6, TCLK7) */
+#define RESOLVER_POLE_PAIRS             (1U)      /* Resolver electrical cycles per mechanical revolution */
+#define RESOLVER_CARRIER_FREQUENCY      (10000U)  /* Hz, a whole number of sinc3 samples per carrier period */
+#define RESOLVER_CARRIER_PHASE_DEG      (0.0f)    /* Phase of the sensed to the driven carrier, negative - delay. */
+                                                  /* Commissioning: add gResolver.carrierPhaseError * 180 / PI */
+#define RESOLVER_PLL_BANDWIDTH_HZ       (200U)    /* Tracking loop, higher - less lag, more speed noise */
+#define RESOLVER_PLL_DAMPING            (1.0f)
+#define RESOLVER_MIN_AMPLITUDE          (0.05f)   /* Envelope below this fraction of the sense full scale - signal lost */
+#define RESOLVER_REF_SCALE              (4096U)   /* Demodulation reference amplitude */
+#if((NUM_POLE_PAIRS % RESOLVER_POLE_PAIRS) != 0U)
+#error "NUM_POLE_PAIRS must be a multiple of RESOLVER_POLE_PAIRS"
+#endif
+#if(((SIGMA_DELTA_SINC3_FREQUENCY % RESOLVER_CARRIER_FREQUENCY) != 0U) || ((SIGMA_DELTA_SINC3_FREQUENCY / RESOLVER_CARRIER_FREQUENCY) < 3U))
+#error "Resolver carrier period must be a whole number, at least 3, of sinc3 samples"
+#endif
+#if((MASTER_CLK_FREQUENCY % (2U * RESOLVER_CARRIER_FREQUENCY)) != 0U)
+#error "RESOLVER_CARRIER_PERIOD_COUNT must be a whole number of PWM counts"
+#endif
+#if((SIGMA_DELTA_SINC3_FULL_SCALE * RESOLVER_REF_SCALE * (SIGMA_DELTA_SINC3_FREQUENCY / RESOLVER_CARRIER_FREQUENCY)) >= 0x80000000U)
+#error "Resolver demodulation sums must fit 32 bits"
+#endif
+#if((RESOLVER_PLL_BANDWIDTH_HZ * 10U) > RESOLVER_CARRIER_FREQUENCY)
+#error "Resolver tracking loop must be well below the carrier frequency"
+#endif
+
+/* Encoder index alignment. The Z signal goes to the index input of the TC1 quadrature decoder (TIOB4, PB13).
+   Commissioning: leave the offset unknown, start the motor once and read gIndexAlign.offset */
+#define ENCODER_INDEX_OFFSET_UNKNOWN    (0xFFFFFFFFU)
+#define ENCODER_INDEX_OFFSET_COUNT      (ENCODER_INDEX_OFFSET_UNKNOWN) /* Mechanical encoder count of the index from the aligned d-axis */
+#define INDEX_ROUGH_LOCK_TIME_MS        (50U)   /* Startup - Rough alignment time when the offset is known */
+#define INDEX_CORRECTION_TOLERANCE      (2U)    /* Index errors up to this many counts are sampling jitter */
+#if((ENCODER_INDEX_OFFSET_COUNT != ENCODER_INDEX_OFFSET_UNKNOWN) && (ENCODER_INDEX_OFFSET_COUNT >= ENCODER_PULSES_PER_REV))
+#error "ENCODER_INDEX_OFFSET_COUNT must be below one mechanical revolution"
+#endif
+#if((INDEX_ROUGH_LOCK_TIME_MS * PWM_FREQUENCY) < 1000U)
+#error "Rough index alignment must be at least one fast loop long"
+#endif
+
+/* Encoder calibration. Commissioning: copy gIndexAlign.offset to ENCODER_INDEX_OFFSET_COUNT and
+   set ENCODER_REVERSED if gEncoderCalib.direction is negative */
+#define ENCODER_REVERSED                (0U)    /* If enabled - the decoder swaps A and B: the count rises in the forward direction */
+#define ENCODER_CALIB_CURRENT           ((float)0.4) /* d-axis current pulling the rotor along (A) */
+#define ENCODER_CALIB_ALIGN_TIME_MS     (500U)  /* Rotor alignment before the sweeps */
+#define ENCODER_CALIB_SPEED_RPM         (60U)   /* Sweep speed, one mechanical revolution each way */
+#define ENCODER_CALIB_POLE_PAIR_TOLERANCE (0.2f) /* Measured pole pairs further than this from NUM_POLE_PAIRS - calibration fails */
+#if(((ENCODER_CALIB_ALIGN_TIME_MS * PWM_FREQUENCY) < 1000U) || (ENCODER_CALIB_SPEED_RPM == 0U) || (ENCODER_CALIB_SPEED_RPM > (60U * PWM_FREQUENCY)))
+#error "Encoder calibration times must be at least one fast loop"
+#endif
+
+/* Position control mode. Trajectory limits, mechanical */
+#define POSITION_MAX_SPEED_RPM          (1000U)
+#define POSITION_MAX_ACCEL_RPM_PER_SEC  (5000U)
+#define POSITION_MAX_JERK_RPM_PER_SEC2  (100000U)
+#define POSITION_STEP_REV               (1.0f)   /* Target step of the speed up/down switches, revolutions */
+#define POSITION_LOAD_INERTIA_KGM2      (0.0f)   /* Rotor and load inertia for the torque feed forward, 0 - none */
+#if((POSITION_MAX_SPEED_RPM == 0U) || (POSITION_MAX_ACCEL_RPM_PER_SEC == 0U) || (POSITION_MAX_JERK_RPM_PER_SEC2 == 0U))
+#error "Position trajectory limits must be positive"
+#endif
+
+/* Speed ramp of the speed mode, mechanical. Defaults of gSpeedRamp, which X2Cscope can change on the fly */
+#define SPEED_RAMP_PROFILE              (SPEED_RAMP_SCURVE) /* SPEED_RAMP_LINEAR or SPEED_RAMP_SCURVE */
+#define SPEED_RAMP_ACCEL_RPM_PER_SEC    (500U)    /* Speeding up, either direction */
+#define SPEED_RAMP_DECEL_RPM_PER_SEC    (500U)    /* Slowing down towards standstill */
+#define SPEED_RAMP_JERK_RPM_PER_SEC2    (5000U)   /* Rate of change of the acceleration, SPEED_RAMP_SCURVE only */
+#if((SPEED_RAMP_ACCEL_RPM_PER_SEC == 0U) || (SPEED_RAMP_DECEL_RPM_PER_SEC == 0U) || (SPEED_RAMP_JERK_RPM_PER_SEC2 == 0U))
+#error "Speed ramp limits must be positive"
+#endif
+
+/* Position loop: speed correction in counts/s per count of position error */
+#define POSCNTR_PTERM                   (20.0f)
+#define POSCNTR_ITERM                   (0.0f)   /* 0 - proportional loop */
+#define POSCNTR_CTERM                   (0.5f)
+#define POSCNTR_OUTMAX                  (2000.0f) /* counts/s */
 
 /* Motor Start-up configuration parameters */
 #define LOCK_TIME_IN_SEC                (2)   /* Startup - Rotor alignment time */
 #define OPEN_LOOP_END_SPEED_RPM         (100) /* Startup - Control loop switches to close loop at this speed */
 #define OPEN_LOOP_RAMP_TIME_IN_SEC      (5)   /* Startup - Time to reach OPEN_LOOP_END_SPEED_RPM in seconds */
 #define Q_CURRENT_REF_OPENLOOP          ((float)0.2) /* Startup - Motor start to ramp up in current control mode */
+#if(INDEX_ROUGH_LOCK_TIME_MS > (LOCK_TIME_IN_SEC * 1000U))
+#error "Rough index alignment must not be longer than the lock time"
+#endif
+
+/* Startup lock settle detection */
+#define LOCK_CURRENT_RAMP_TIME_MS       (50U)   /* Startup - Lock current ramp from 0 to Q_CURRENT_REF_OPENLOOP */
+#define LOCK_ANGLE_RAMP_TIME_MS         (50U)   /* Startup - Turn of the lock angle to the second step */
+#define LOCK_SETTLE_SPEED_RPM           (6U)    /* Startup - Rotor below this speed is still */
+#define LOCK_SETTLE_WINDOW_MS           (10U)   /* Startup - Speed measurement window */
+#define LOCK_SETTLE_TIME_MS             (50U)   /* Startup - Rotor still for this long ends the lock step */
+#if(((LOCK_CURRENT_RAMP_TIME_MS * PWM_FREQUENCY) < 1000U) || ((LOCK_ANGLE_RAMP_TIME_MS * PWM_FREQUENCY) < 1000U))
+#error "Lock ramps must be at least one fast loop long"
+#endif
+#if(((LOCK_SETTLE_WINDOW_MS * PWM_FREQUENCY) < 1000U) || (LOCK_SETTLE_TIME_MS < LOCK_SETTLE_WINDOW_MS) || (LOCK_SETTLE_TIME_MS >= (LOCK_TIME_IN_SEC * 1000U)))
+#error "Lock settle time must be at least one window and below the lock time"
+#endif
+
+/* Initial position detection. Voltage pulses along IPD_PULSE_ANGLES angles, taken in pairs of opposite
+   angles, find the d-axis; a pair of longer pulses along it finds the magnet polarity */
+#define IPD_PULSE_VOLTAGE               (0.15f)    /* Pulse voltage, per unit of the inverter output as Vd */
+#define IPD_PULSE_TIME_US               (150U)     /* Pulse, then the same reversed: the current goes back to zero. */
+                                                   /* Polarity pulses well below half the motor L/R */
+#define IPD_REST_TIME_US                (200U)     /* Zero voltage after the pulses, the response settles in the filters */
+#define IPD_PULSE_ANGLES                (12U)      /* Angles over one electrical revolution, even */
+#define IPD_POLARITY_PULSE_SCALE        (2U)       /* Polarity pulses are this many times longer: more saturation */
+#define IPD_MIN_SALIENCY                (0.005f)   /* Response ratio of the d-axis to the mean below this - lock start */
+#define IPD_MIN_POLARITY                (0.003f)   /* Response ratio of the polarity pulses below this - lock start */
+#if(((IPD_PULSE_TIME_US * PWM_FREQUENCY) < 500000U) || ((IPD_REST_TIME_US * PWM_FREQUENCY) < 500000U) || (IPD_POLARITY_PULSE_SCALE == 0U))
+#error "Initial position detection pulses must be at least one fast loop long"
+#endif
+#if(((IPD_PULSE_ANGLES % 2U) != 0U) || (IPD_PULSE_ANGLES < 6U))
+#error "IPD_PULSE_ANGLES must be even, at least 6"
+#endif
+
+/* Flying start. The encoder count of the coasting rotor is followed while the motor is stopped */
+#define FLYING_START_WINDOW_MS          (10U)    /* Restart - encoder speed measurement window, repeated while stopped */
+#define FLYING_START_MIN_SPEED_RPM      (60U)    /* Restart - below this the rotor is taken as still */
+#if((FLYING_START_MIN_SPEED_RPM * ENCODER_PULSES_PER_REV * FLYING_START_WINDOW_MS) < 120000U)
+#error "Flying start window too short to resolve FLYING_START_MIN_SPEED_RPM: 2 counts at least"
+#endif
+#if((FLYING_START_WINDOW_MS * (CPU_FREQUENCY / 1000U)) >= 0x80000000U)
+#error "Flying start window too long for the DWT cycle counter"
+#endif
+
+/* Phase current offset tracking, bridge off: exponential average of the sense output */
+#define OFFSET_TRACK_PERIOD_MS          (1U)     /* Update period, on the sinc3 sample count */
+#define OFFSET_TRACK_TIME_CONSTANT_MS   (2000U)  /* Average time constant: longer - less noise, slower drift tracking */
+#define OFFSET_TRACK_HOLDOFF_MS         (50U)    /* No update for this long after the bridge turns off: phase currents decay */
+#if(((OFFSET_TRACK_PERIOD_MS * SIGMA_DELTA_SINC3_FREQUENCY) < 1000U) || (OFFSET_TRACK_PERIOD_MS >= OFFSET_TRACK_TIME_CONSTANT_MS))
+#error "Offset tracking period must be at least one sinc3 sample, below the time constant"
+#endif
+
+/* Background tasks. Run on events of the interrupts, the SysTick tick paces the switches */
+#define BACKGROUND_TICK_MS              (1U)     /* SysTick period: switch debounce and state machine */
+#define SWITCH_DEBOUNCE_TIME_MS         (20U)    /* Switch level held this long - pressed */
+#define LOAD_METER_WINDOW_MS            (100U)   /* CPU load meter averaging window, see gLoadMeter */
+#if((BACKGROUND_TICK_MS == 0U) || ((BACKGROUND_TICK_MS * (CPU_FREQUENCY / 1000U)) > 0x1000000U))
+#error "Background tick must fit the 24 bit SysTick counter"
+#endif
+#if((SWITCH_DEBOUNCE_TIME_MS < BACKGROUND_TICK_MS) || (LOAD_METER_WINDOW_MS < BACKGROUND_TICK_MS))
+#error "Switch debounce and load meter window must be at least one background tick"
+#endif
+#if((LOAD_METER_WINDOW_MS * (CPU_FREQUENCY / 1000U)) > 0xFFFFFFFFU)
+#error "Load meter window must fit the 32 bit DWT cycle counter"
+#endif
 
 /***********************************************************************************************/
 /* USER CONFIGURABLE PARAMETERS - END                                                          */
@@ -226,15 +532,47 @@
 #define ADC_CURRENT_SCALE             ((float)(MAX_CURRENT/(float)(2048)))
 #define DCBUS_SENSE_RATIO             (float)(DCBUS_SENSE_BOTTOM_RESISTOR/(DCBUS_SENSE_BOTTOM_RESISTOR + DCBUS_SENSE_TOP_RESISTOR))
 #define VOLTAGE_ADC_TO_PHY_RATIO      (float)(MAX_ADC_INPUT_VOLTAGE/(MAX_ADC_COUNT * DCBUS_SENSE_RATIO))
-#define SLOW_LOOP_TIME_PWM_COUNT      (uint32_t)(SLOW_LOOP_TIME_SEC / FAST_LOOP_TIME_SEC) /* 100 times slower than Fast Loop */
+#if(SPEED_LOOP_RATE == SPEED_LOOP_RATE_MEDIUM)
+#define SPEED_LOOP_TIME_SEC           (float)((float)MEDIUM_LOOP_TIME_PWM_COUNT * FAST_LOOP_TIME_SEC)
+#else
+#define SPEED_LOOP_TIME_SEC           (float)((float)SLOW_LOOP_TIME_PWM_COUNT * FAST_LOOP_TIME_SEC)
+#endif
+#define SPEED_MT_MIN_WINDOW_TICKS     ((SPEED_MT_MIN_WINDOW_MS * PWM_FREQUENCY) / 1000U)
+#define SPEED_MT_MAX_WINDOW_TICKS     ((SPEED_MT_MAX_WINDOW_MS * PWM_FREQUENCY) / 1000U)
+#define ANGLE_PLL_OMEGA_N             (float)(2.0f * PI * ANGLE_PLL_BANDWIDTH_HZ)
+#define ANGLE_PLL_KP                  (float)(2.0f * ANGLE_PLL_DAMPING * ANGLE_PLL_OMEGA_N)
+#define ANGLE_PLL_KI_TS               (float)(ANGLE_PLL_OMEGA_N * ANGLE_PLL_OMEGA_N * FAST_LOOP_TIME_SEC)
 #define LOCK_COUNT_FOR_LOCK_TIME      (float)((float)LOCK_TIME_IN_SEC/(float)FAST_LOOP_TIME_SEC)
+#define INDEX_ROUGH_LOCK_COUNT        (float)((INDEX_ROUGH_LOCK_TIME_MS * PWM_FREQUENCY) / 1000U)
+#define LOCK_CURRENT_RAMP_STEP        (float)(FAST_LOOP_TIME_SEC * 1000.0f / (float)LOCK_CURRENT_RAMP_TIME_MS)
+#define LOCK_ANGLE_RAMP_STEP          (float)(FAST_LOOP_TIME_SEC * 1000.0f / (float)LOCK_ANGLE_RAMP_TIME_MS)
+#define LOCK_SETTLE_WINDOW_TICKS      ((LOCK_SETTLE_WINDOW_MS * PWM_FREQUENCY) / 1000U)
+#define LOCK_SETTLE_WINDOW_COUNT      (int32_t)((LOCK_SETTLE_SPEED_RPM * ENCODER_PULSES_PER_REV * LOCK_SETTLE_WINDOW_MS) / 60000U)
+#define LOCK_SETTLE_WINDOWS           (LOCK_SETTLE_TIME_MS / LOCK_SETTLE_WINDOW_MS)
+#define IPD_PULSE_TICKS               (((IPD_PULSE_TIME_US * PWM_FREQUENCY) + 500000U) / 1000000U)
+#define IPD_REST_TICKS                (((IPD_REST_TIME_US * PWM_FREQUENCY) + 500000U) / 1000000U)
+#define IPD_REVERSE_DROP_PER_TICK     (float)(MOTOR_PER_PHASE_RESISTANCE * FAST_LOOP_TIME_SEC / MOTOR_PER_PHASE_INDUCTANCE)
+#define FLYING_START_WINDOW_CYCLES    (FLYING_START_WINDOW_MS * (CPU_FREQUENCY / 1000U))
+#define OFFSET_TRACK_PERIOD_SAMPLES   (((OFFSET_TRACK_PERIOD_MS * SIGMA_DELTA_SINC3_FREQUENCY) + 500U) / 1000U)
+#define OFFSET_TRACK_HOLDOFF_SAMPLES  (((OFFSET_TRACK_HOLDOFF_MS * SIGMA_DELTA_SINC3_FREQUENCY) + 500U) / 1000U)
+#define OFFSET_TRACK_GAIN             (float)((float)OFFSET_TRACK_PERIOD_MS / (float)OFFSET_TRACK_TIME_CONSTANT_MS)
+#define BACKGROUND_TICK_CYCLES        (BACKGROUND_TICK_MS * (CPU_FREQUENCY / 1000U))
+#define SWITCH_DEBOUNCE_TICKS         ((SWITCH_DEBOUNCE_TIME_MS + (BACKGROUND_TICK_MS / 2U)) / BACKGROUND_TICK_MS)
+#define LOAD_METER_WINDOW_TICKS       ((LOAD_METER_WINDOW_MS + (BACKGROUND_TICK_MS / 2U)) / BACKGROUND_TICK_MS)
+#define ENCODER_CALIB_ALIGN_TICKS     ((ENCODER_CALIB_ALIGN_TIME_MS * PWM_FREQUENCY) / 1000U)
+#define ENCODER_CALIB_SWEEP_TICKS     ((60U * PWM_FREQUENCY) / ENCODER_CALIB_SPEED_RPM)
+#define RESOLVER_SAMPLES_PER_CARRIER  (SIGMA_DELTA_SINC3_FREQUENCY / RESOLVER_CARRIER_FREQUENCY)
+#define RESOLVER_CARRIER_PERIOD_COUNT (MASTER_CLK_FREQUENCY / (2U * RESOLVER_CARRIER_FREQUENCY)) /* Center aligned */
+#define RESOLVER_ENVELOPE_TO_UNIT     (float)(4.0f / ((float)SIGMA_DELTA_SINC3_FULL_SCALE * (float)RESOLVER_REF_SCALE * (float)RESOLVER_SAMPLES_PER_CARRIER))
+#define RESOLVER_PLL_OMEGA_N          (float)(2.0f * PI * (float)RESOLVER_PLL_BANDWIDTH_HZ)
+#define RESOLVER_PLL_KP               (float)(2.0f * RESOLVER_PLL_DAMPING * RESOLVER_PLL_OMEGA_N)
+#define RESOLVER_PLL_KI_TS            (float)(RESOLVER_PLL_OMEGA_N * RESOLVER_PLL_OMEGA_N * FAST_LOOP_TIME_SEC)
+#define BEMF_OBSERVER_FILTER_PER_SPEED (float)(BEMF_OBSERVER_FILTER_RATIO * FAST_LOOP_TIME_SEC)
+#define BEMF_OBSERVER_FAULT_ANGLE     (float)(BEMF_OBSERVER_FAULT_ANGLE_DEG * PI / 180.0f)
+#define BEMF_OBSERVER_FAULT_COUNT     ((BEMF_OBSERVER_FAULT_TIME_MS * PWM_FREQUENCY) / 1000U)
 #define OPEN_LOOP_END_SPEED_RPS       ((float)OPEN_LOOP_END_SPEED_RPM/60.0f)
 
-/* Rated speed of the motor in RPM */
-#define RATED_SPEED_RAD_PER_SEC_ELEC                     (float)(RATED_SPEED_RPM *(2.0*(float)M_PI/60.0f) * NUM_POLE_PAIRS)
-#define CLOSE_LOOP_RAMP_RATE                              (500.0f) /* RPM per sec */
-#define RAMP_RAD_PER_SEC_ELEC                             (float)(CLOSE_LOOP_RAMP_RATE * NUM_POLE_PAIRS * PI/30.0f)
-#define SPEED_RAMP_INC_SLOW_LOOP                          (float)(RAMP_RAD_PER_SEC_ELEC*SLOW_LOOP_TIME_SEC)
+/* Rated speed, speed ramp and encoder scaling are single precision constants of "mc_motor_profile.h" */
 
 /* Open loop end speed conversions */
 #define SINGLE_ELEC_ROT_RADS_PER_SEC                      ((float)((float)(2.0f) * (float)M_PI))
@@ -248,15 +586,14 @@
 #define BEMF_CNST_Vpk_PH_RDPS_MECH   (float)(BEMF_CNST_Vpk_PH_PER_RPM_MECH * (float)(2.0f * (float)M_PI/60.0f))
 #define BEMF_CNST_Vpk_PH_RDPS_ELEC   (float)(BEMF_CNST_Vpk_PH_RDPS_MECH * NUM_POLE_PAIRS)
 
-#define ENCODER_PULSES_PER_EREV                          (uint16_t)((uint16_t)ENCODER_PULSES_PER_REV/(uint16_t)NUM_POLE_PAIRS)
+#define ENCODER_PULSES_PER_MREV                          ((int32_t)ENCODER_PULSES_PER_REV)
 
 #define MAX_SPEED_RDPS_ELEC          (float)(((RATED_SPEED_RPM/60.0f)*2.0f*(float)M_PI)*NUM_POLE_PAIRS)
 
 #define MAX_STATOR_VOLT_SQUARE              (float)(0.98f * 0.98f)
 #define POT_ADC_COUNT_FW_SPEED_RATIO        (float)(MAX_SPEED_RDPS_ELEC/MAX_ADC_COUNT)
 #define QDEC_RC 65535u              
-#define QDEC_UPPER_THRESHOLD 49151u   
-#define QDEC_LOWER_THRESHOLD 16384u  
-#define QDEC_OVERFLOW  (uint16_t)(QDEC_RC % ENCODER_PULSES_PER_EREV) 
-#define QDEC_UNDERFLOW  (uint16_t)(ENCODER_PULSES_PER_EREV - QDEC_OVERFLOW)
+/* QDEC counter positions: the RC compare resets the counter to 0 */
+#define QDEC_COUNTER_MODULUS          ((int32_t)QDEC_RC)
+#define QDEC_HALF_MODULUS             (QDEC_COUNTER_MODULUS / 2)
 #endif
\ No newline at end of file
@@ -64,6 +64,8 @@
 
 int main ( void )
 {
+    uint32_t events;
+
     /* Initialize all modules */
     SYS_Initialize ( NULL );
 
@@ -75,8 +77,17 @@ int main ( void )
 
     while ( true )
     {
-        MCAPP_Tasks();
-        X2Cscope_Communicate();
+        /* Sleeps until an interrupt posts an event */
+        events = MCAPP_EventWait();
+
+        MCAPP_Tasks(events);
+
+        /* UART events, and the tick for anything X2Cscope still has to send */
+        if ((events & (MCAPP_EVENT_UART | MCAPP_EVENT_TICK)) != 0U)
+        {
+            X2Cscope_Communicate();
+            MCAPP_UartEventEnable();
+        }
     }
 
     /* Execution should not come here during normal operation */
@@ -0,0 +1,121 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_angle_pll.c
+
+  Summary:
+    This file contains the encoder angle tracking PLL.
+
+  Description:
+    This file contains the type II tracking loop which interpolates the
+    encoder angle and estimates the speed, at the fast loop rate.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_angle_pll.h"
+#include "mc_motor_profile.h"
+
+#if(ENABLE_ANGLE_PLL == true)
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_ANGLE_PLL gAnglePLL;
+
+/******************************************************************************/
+/* Function name: MCAPP_AnglePLLReset                                         */
+/* Function parameters: angle - present encoder angle (rad)                   */
+/* Function return: None                                                      */
+/* Description: Locks the angle tracking PLL on the encoder at standstill.    */
+/******************************************************************************/
+void MCAPP_AnglePLLReset(float angle)
+{
+    gAnglePLL.angle = angle;
+    gAnglePLL.speed = 0.0f;
+    gAnglePLL.error = 0.0f;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_AnglePLLUpdate                                        */
+/* Function parameters: angle - encoder electrical angle (rad), 0 to 2*PI     */
+/* Function return: None                                                      */
+/* Description: Type II angle tracking loop, called every fast loop. The      */
+/*              speed integrates the angle error, the angle integrates the    */
+/*              speed plus the proportional term.                             */
+/******************************************************************************/
+void MCAPP_AnglePLLUpdate(float angle)
+{
+    float error;
+
+    /* Shortest angle error, -PI to PI */
+    error = angle - gAnglePLL.angle;
+    if(error > PI)
+    {
+        error -= 2.0f * PI;
+    }
+    else if(error < -PI)
+    {
+        error += 2.0f * PI;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+    gAnglePLL.error = error;
+
+    gAnglePLL.speed += ANGLE_PLL_KI_TS * error;
+    gAnglePLL.angle += (gAnglePLL.speed + (ANGLE_PLL_KP * error)) * FAST_LOOP_TIME_SEC;
+
+    /* Keep the angle in 0 to 2*PI for the sine table */
+    if(gAnglePLL.angle >= (2.0f * PI))
+    {
+        gAnglePLL.angle -= 2.0f * PI;
+    }
+    else if(gAnglePLL.angle < 0.0f)
+    {
+        gAnglePLL.angle += 2.0f * PI;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,118 @@
+/*******************************************************************************
+ Angle tracking PLL interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_angle_pll.h
+
+  Summary:
+    Continuous angle and speed from the encoder count
+
+  Description:
+    This file contains the data structure and function prototypes of the
+    encoder angle tracking PLL, run by the fast control loop of mc_app.c.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_ANGLE_PLL_H    // Guards against multiple inclusion
+#define MC_ANGLE_PLL_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include "userparams.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Encoder angle tracking PLL
+
+  Summary:
+    Type II tracking loop on the encoder electrical angle
+
+  Description:
+    Interpolates the encoder count staircase into a continuous angle and
+    gives the speed every fast loop. The integrator is the speed estimate.
+
+  Remarks:
+    Bandwidth and damping are set in "userparams.h".
+*/
+typedef struct
+{
+    float angle;            /* Estimated electrical angle (rad), 0 to 2*PI */
+    float speed;            /* Estimated electrical speed (rad/s) */
+    float error;            /* Encoder angle - estimated angle (rad) */
+} MCAPP_ANGLE_PLL;
+
+#if(ENABLE_ANGLE_PLL == true)
+/* Tracked angle and speed, read through X2Cscope */
+extern MCAPP_ANGLE_PLL gAnglePLL;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_AnglePLLReset(float angle);
+void MCAPP_AnglePLLUpdate(float angle);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_ANGLE_PLL_H
+
+/**
+ End of File
+*/
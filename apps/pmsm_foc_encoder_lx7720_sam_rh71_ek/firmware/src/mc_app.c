@@ -57,23 +57,55 @@
 /* Defines                                                                    */
 /******************************************************************************/
 /* Define the number of slow loop to wait before stopping the motor if there was no activity */
-#define MOTOR_ACTIVITY_SLOW_LOOP_COUNT_60_SEC  (12000U)
+#define MOTOR_ACTIVITY_SLOW_LOOP_COUNT_60_SEC  (uint32_t)((60.0f / SLOW_LOOP_TIME_SEC) + 0.5f)
 #define NOP() asm("NOP");
+
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+/* Phase current of the weighted sinc3 sum in Q31 per unit */
+#define CURRENT_SUM_TO_Q31          ((int32_t)((CURRENT_SUM_TO_AMPS / Q31_CURRENT_BASE) * Q31_ONE_FLOAT))
+#define ONE_BY_Q31_CURRENT_BASE     ((float)(1.0f / Q31_CURRENT_BASE))
+#endif
 /******************************************************************************/
 /* Local Function Prototype                                                   */
 /******************************************************************************/
 __STATIC_INLINE void MCAPP_MotorAngleCalc(void);
 __STATIC_INLINE void MCAPP_MotorCurrentControl( void );
-static void MCAPP_ADCOffsetCalibration(void);
+__STATIC_INLINE void MCAPP_CurrentPIControl(void);
+static void MCAPP_OffsetCalibStart(MC_APP_STATE nextState);
+__STATIC_INLINE void MCAPP_OffsetApply(void);
+#if(ENABLE_OFFSET_TRACKING == true)
+static void MCAPP_OffsetTrack(void);
+#endif
 static void MCAPP_MotorControlParamInit(void);
-__STATIC_INLINE bool MCAPP_SlowLoopTimeIsFinished(void);
-__STATIC_INLINE void MCAPP_SlowControlLoop(void);
+__STATIC_INLINE void MCAPP_SpeedControlLoop(void);
+static void MCAPP_MediumLoopTasks(void);
+static void MCAPP_SlowLoopTasks(void);
+static void MCAPP_CycleCounterInit(void);
+static void MCAPP_SetpointPost(int32_t speedSteps, int32_t positionStep);
+static void MCAPP_SetpointApply(void);
 static void MCAPP_SwitchStartDebounce(MC_APP_STATE state);
 static void MCAPP_SwitchDecrDebounce(void);
 static void MCAPP_SwitchIncrDebounce(void);
 
-#if(TORQUE_MODE == false)
-__STATIC_INLINE void MCAPP_SpeedRamp(void);
+#if(POSITION_MODE == true)
+__STATIC_INLINE void MCAPP_PositionControl(void);
+#endif
+
+#if(ENABLE_INDEX_ALIGNMENT == true)
+__STATIC_INLINE void MCAPP_IndexAlign(uint32_t qdecStatus);
+#endif
+
+#if(ENABLE_INITIAL_POSITION_DETECTION == true)
+__STATIC_INLINE void MCAPP_IPDPulseApply(void);
+#endif
+
+#if(ENABLE_FLYING_START == true)
+static void MCAPP_EncoderTrack(void);
+static void MCAPP_FlyingStart(void);
+#endif
+
+#if(ENABLE_GAIN_SCHEDULING == true)
+__STATIC_INLINE void MCAPP_PIGainsApply(void);
 #endif
 
 /******************************************************************************/
@@ -84,13 +116,17 @@ static MCAPP_CONTROL_PARAM gCtrlParam;
 static MCAPP_FOC_PARAM gfocParam;
 static MCAPP_DATA gMCAPPData;
 static MCAPP_POSITION_CALC gPositionCalc;
+#if(POSITION_MODE == true)
+static MCLIB_PI gPIParmPos;         /* Position P/PI controller */
+#endif
 
 /******************************************************************************/
 /*                   Global Variables                                         */
 /******************************************************************************/
 static float speed_ref_filtered = 0.0f;
-static uint32_t phaseCurrentUOffset;
+static uint32_t phaseCurrentUOffset;    /* Tenths of a sinc3 count */
 static uint32_t phaseCurrentVOffset;
+static MC_APP_STATE offsetCalibNextState;
 
 /* Global variables for Decimation Filters for channel U and V */
 static volatile __attribute__ ((tcm)) MCAPP_SINC3 gCurrentU = {0};
@@ -100,16 +136,45 @@ static volatile __attribute__ ((tcm)) uint32_t currentUActive = 0;
 static volatile __attribute__ ((tcm)) uint32_t currentVActive = 0;
 static volatile uint32_t sinc3_out_sample_count = 0U;
 
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+/* Decimation filters of the resolver sine and cosine channels */
+static volatile __attribute__ ((tcm)) MCAPP_SINC3 gResolverSin = {0};
+static volatile __attribute__ ((tcm)) MCAPP_SINC3 gResolverCos = {0};
+#endif
+
 /* Encoder last measure of speed in electrical rad per sec */
 static volatile float speed_elec_rad_per_sec;
 
 /* Motor speed target in electrical rad per sec */
 static float motor_speed_target_elec_rad_per_sec = 400.0f;
 
-/* Count of slow loop since last user activity */
-static uint32_t motor_activity_count = 0U;
+/* Scheduler table: fast rate is the control loop interrupt, run by the PWM */
+static const MCAPP_RATE_CONFIG gRateConfig[MCAPP_RATE_COUNT] =
+{
+    {1U,                         1U, TC0_CH0_IRQn, NULL},
+    {MEDIUM_LOOP_TIME_PWM_COUNT, 6U, TC3_CH2_IRQn, MCAPP_MediumLoopTasks},
+    {SLOW_LOOP_TIME_PWM_COUNT,   7U, PendSV_IRQn,  MCAPP_SlowLoopTasks}
+};
+
+/* Setpoint requests written by the buttons and taken by the slow loop */
+static MCAPP_SETPOINT_REQUEST gSetpointRequest;
+static volatile bool gSetpointPending = false;
+
+/* Count of slow loop since last user activity, written by the slow loop only */
+static volatile uint32_t motor_activity_count = 0U;
 
 static uintptr_t dummyforMisra;
+
+#if(SINCOS_BENCHMARK == true)
+/* Sine/cosine benchmark results, read through X2Cscope */
+MCLIB_SINCOS_BENCHMARK gSinCosBenchmark;
+#endif
+
+#if(Q31_BENCHMARK == true)
+/* Float and Q31 current loop cycles, read through X2Cscope */
+MCLIB_Q31_BENCHMARK gQ31Benchmark;
+#endif
+
 /*****************ISR Functions *******************************/
 
 /******************************************************************************/
@@ -150,19 +215,31 @@ __STATIC_INLINE void MCAPP_MotorCurrentControl( void )
          * for maximum startup torque, set the q current to maximum acceptable
          * value represents the maximum peak value 	 */
 
+#if(ENABLE_ENCODER_CALIBRATION == true)
+        if(gEncoderCalib.step != ENCODER_CALIB_DONE)
+        {
+            /* Encoder calibration: the d-axis current pulls the rotor onto the forced angle */
+            gCtrlParam.iqRef = 0.0f;
+            if(gEncoderCalib.step == ENCODER_CALIB_FAILED)
+            {
+                gCtrlParam.idRef = 0.0f;
+            }
+            else
+            {
+                gCtrlParam.idRef = ENCODER_CALIB_CURRENT;
+            }
+        }
+        else
+        {
+            gCtrlParam.iqRef = Q_CURRENT_REF_OPENLOOP*(float)gCtrlParam.direction;
+        }
+#else
         gCtrlParam.iqRef = Q_CURRENT_REF_OPENLOOP*(float)gCtrlParam.direction;
-
-        /* PI control for Iq torque control loop */
-        gPIParmQ.inMeas = gMCLIBCurrentDQ.iq;
-        gPIParmQ.inRef  = gCtrlParam.iqRef;
-        MCLIB_PIControl(&gPIParmQ);
-        gMCLIBVoltageDQ.vq    = gPIParmQ.out;
-
-        /* PI control for Id flux control loop */
-        gPIParmD.inMeas = gMCLIBCurrentDQ.id;
-        gPIParmD.inRef  = gCtrlParam.idRef;
-        MCLIB_PIControl(&gPIParmD);
-        gMCLIBVoltageDQ.vd = gPIParmD.out;
+#endif
+#if(ENABLE_LOCK_SETTLE_DETECTION == true)
+        /* Lock current ramps in from zero */
+        gCtrlParam.iqRef *= gLockSettle.currentRamp;
+#endif
     }
     else
     {
@@ -175,7 +252,7 @@ __STATIC_INLINE void MCAPP_MotorCurrentControl( void )
             gPIParmQref.dSum = 0.0f;
             gPIParmD.inRef = 0.0f;
             gCtrlParam.idRef = 0.0f;
-            gCtrlParam.sync_cnt = 0U;
+            MCAPP_SchedulerSync();
 
             // Set default target speed rad/sec
             motor_speed_target_elec_rad_per_sec = 400.0f;
@@ -186,23 +263,98 @@ __STATIC_INLINE void MCAPP_MotorCurrentControl( void )
         gCtrlParam.iqRef = Q_CURRENT_REF_OPENLOOP*gCtrlParam.direction;
 #endif
 
-        /* PI control for Id flux control loop */
-        gPIParmD.inMeas = gMCLIBCurrentDQ.id;          /* This is in Amps */
-        gPIParmD.inRef  = gCtrlParam.idRef;       /* This is in Amps */
-        MCLIB_PIControl(&gPIParmD);
-
         gfocParam.lastVd = gMCLIBVoltageDQ.vd;
-        gMCLIBVoltageDQ.vd    = gPIParmD.out;          /* This is in %. It should be converted to volts, multiply with (DC/sqrt(3)) */
-
-        /* PI control for Iq torque control */
-        gPIParmQ.inMeas = gMCLIBCurrentDQ.iq;          /* This is in Amps */
-        gPIParmQ.inRef  = gCtrlParam.iqRef;       /* This is in Amps */
-        MCLIB_PIControl(&gPIParmQ);
-        /* This is in %. If should be converted to volts, multiply with (VDC/sqrt(3))  */
-        gMCLIBVoltageDQ.vq    = gPIParmQ.out;
     }
+
+    /* PI control for Id flux and Iq torque control loops */
+    MCAPP_CurrentPIControl();
+#if(ENABLE_INITIAL_POSITION_DETECTION == true)
+    if((gIPD.step == IPD_PULSES) || (gIPD.step == IPD_POLARITY))
+    {
+        MCAPP_IPDPulseApply();
+    }
+#endif
 }
 
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+/******************************************************************************/
+/* Function name: MCAPP_CurrentPIControl                                      */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Executes the Id and Iq PI controllers with the Q31 library.   */
+/*              References are converted to per unit; the float dq voltages   */
+/*              are kept up to date for the rest of the application.          */
+/******************************************************************************/
+__STATIC_INLINE void MCAPP_CurrentPIControl(void)
+{
+    /* PI control for Id flux control loop */
+    gPIParmDQ31.inMeas = gMCLIBCurrentDQQ31.id;
+    gPIParmDQ31.inRef  = MCLIB_FloatToQ31(gCtrlParam.idRef * ONE_BY_Q31_CURRENT_BASE);
+    MCLIB_PIControl_Q31(&gPIParmDQ31);
+    gMCLIBVoltageDQQ31.vd = gPIParmDQ31.out;
+
+    /* PI control for Iq torque control loop */
+    gPIParmQQ31.inMeas = gMCLIBCurrentDQQ31.iq;
+    gPIParmQQ31.inRef  = MCLIB_FloatToQ31(gCtrlParam.iqRef * ONE_BY_Q31_CURRENT_BASE);
+    MCLIB_PIControl_Q31(&gPIParmQQ31);
+    gMCLIBVoltageDQQ31.vq = gPIParmQQ31.out;
+
+    gMCLIBVoltageDQ.vd = MCLIB_Q31ToFloat(gMCLIBVoltageDQQ31.vd);
+    gMCLIBVoltageDQ.vq = MCLIB_Q31ToFloat(gMCLIBVoltageDQQ31.vq);
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_PhaseCurrentQ31                                       */
+/* Function parameters: pCurrent - decimation filter of the phase,            */
+/*                      offset - phase current offset                         */
+/* Function return: Phase current in Q31 per unit of Q31_CURRENT_BASE         */
+/* Description: Scales the offset removed weighted sinc3 sum to Q31.        */
+/******************************************************************************/
+__STATIC_INLINE int32_t MCAPP_PhaseCurrentQ31(volatile MCAPP_SINC3 *pCurrent, uint32_t offset)
+{
+    int64_t current;
+
+    current = (int64_t)MCAPP_PhaseCurrentSum(pCurrent, offset) * CURRENT_SUM_TO_Q31;
+
+    /* Saturate: currents above Q31_CURRENT_BASE are out of range */
+    if(current > (int64_t)Q31_MAX)
+    {
+        current = (int64_t)Q31_MAX;
+    }
+    else if(current < (int64_t)Q31_MIN)
+    {
+        current = (int64_t)Q31_MIN;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+    return (int32_t)current;
+}
+#else
+/******************************************************************************/
+/* Function name: MCAPP_CurrentPIControl                                      */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Executes the Id and Iq PI controllers.                        */
+/******************************************************************************/
+__STATIC_INLINE void MCAPP_CurrentPIControl(void)
+{
+    /* PI control for Id flux control loop */
+    gPIParmD.inMeas = gMCLIBCurrentDQ.id;          /* This is in Amps */
+    gPIParmD.inRef  = gCtrlParam.idRef;       /* This is in Amps */
+    MCLIB_PIControl(&gPIParmD);
+    gMCLIBVoltageDQ.vd    = gPIParmD.out;          /* This is in %. It should be converted to volts, multiply with (DC/sqrt(3)) */
+
+    /* PI control for Iq torque control */
+    gPIParmQ.inMeas = gMCLIBCurrentDQ.iq;          /* This is in Amps */
+    gPIParmQ.inRef  = gCtrlParam.iqRef;       /* This is in Amps */
+    MCLIB_PIControl(&gPIParmQ);
+    /* This is in %. If should be converted to volts, multiply with (VDC/sqrt(3))  */
+    gMCLIBVoltageDQ.vq    = gPIParmQ.out;
+}
+#endif
+
 /******************************************************************************/
 /* Function name: MCAPP_MotorAngleCalc                                        */
 /* Function parameters: None                                                  */
@@ -212,21 +364,66 @@ __STATIC_INLINE void MCAPP_MotorCurrentControl( void )
 /******************************************************************************/
 __STATIC_INLINE void MCAPP_MotorAngleCalc(void)
 {
-    
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+    uint32_t resolverAngle;
+
+    /* Tracks in open loop as well: converged by the end of the lock */
+    MCAPP_ResolverUpdate();
+#else
+    int32_t countDelta;
+#endif
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+    bool sensorAngle = false;
+#endif
+#if((ENABLE_INDEX_ALIGNMENT == true) || (ENABLE_ENCODER_CALIBRATION == true))
+    uint32_t qdecStatus;
+
+    /* Reading the QDEC status clears it: one read per fast loop for all its users */
+    qdecStatus = TC1_QuadratureStatusGet();
+#endif
+
     if(gCtrlParam.openLoop == true)
     {
+#if(ENABLE_INDEX_ALIGNMENT == true)
+        /* Offset known: only the end of the second lock step, the index corrects the rest */
+        if((gIndexAlign.offset != ENCODER_INDEX_OFFSET_UNKNOWN)
+                && (gCtrlParam.startup_lock_count < (uint32_t)LOCK_COUNT_FOR_LOCK_TIME))
+        {
+#if(ENABLE_LOCK_SETTLE_DETECTION == true)
+            /* The second step ends as soon as it settles */
+            gCtrlParam.startup_lock_count = (uint32_t)LOCK_COUNT_FOR_LOCK_TIME;
+#else
+            gCtrlParam.startup_lock_count = (2U*(uint32_t)LOCK_COUNT_FOR_LOCK_TIME) - (uint32_t)INDEX_ROUGH_LOCK_COUNT;
+#endif
+        }
+#endif
         /* begin with the lock sequence, for field alignment */
         if (gCtrlParam.startup_lock_count < (uint32_t)LOCK_COUNT_FOR_LOCK_TIME)
         {
             gCtrlParam.startup_lock_count++;
             gPositionCalc.rotor_angle_rad_per_sec = (float)(M_PI);
+#if(ENABLE_LOCK_SETTLE_DETECTION == true)
+            if(MCAPP_LockSettleUpdate(0U) == true)
+            {
+                gCtrlParam.startup_lock_count = (uint32_t)LOCK_COUNT_FOR_LOCK_TIME;
+            }
+#endif
         }
         else
         {
             if(gCtrlParam.startup_lock_count < 2U*(uint32_t)LOCK_COUNT_FOR_LOCK_TIME)
             {
                 gCtrlParam.startup_lock_count++;
+#if(ENABLE_LOCK_SETTLE_DETECTION == true)
+                if(MCAPP_LockSettleUpdate(1U) == true)
+                {
+                    gCtrlParam.startup_lock_count = 2U*(uint32_t)LOCK_COUNT_FOR_LOCK_TIME;
+                }
+                /* Turned over, not jumped: no kick on the rotor */
+                gPositionCalc.rotor_angle_rad_per_sec = ((float)M_PI + ((float)M_PI_2 * (float)gCtrlParam.direction * gLockSettle.angleRamp));
+#else
                 gPositionCalc.rotor_angle_rad_per_sec = ((float)M_PI + ((float)M_PI_2 * (float)gCtrlParam.direction));
+#endif
             }
             else
             {
@@ -236,37 +433,124 @@ __STATIC_INLINE void MCAPP_MotorAngleCalc(void)
                 /* switch to close loop */
                 gCtrlParam.changeMode = true;
                 gCtrlParam.openLoop = false;
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+                /* Rotor locked at electrical angle 0: offset of the resolver to the motor angle */
+                gResolver.offsetQ32 = 0U - (gResolver.angleQ32 * MOTOR_RESOLVER_TO_ANGLE_Q32);
+#else
                 /* Start QDEC timer */
                 TC1_QuadratureStart();
                 gPositionCalc.QDECcntZ = 0u;
-                gPositionCalc.prev_position_count=0;
-                gPositionCalc.posCompensation = 0u;
+                gPositionCalc.prev_position_count=0U;
+                gPositionCalc.posCnt = 0U;
+                gPositionCalc.position = 0;
+#if(ENABLE_ENCODER_CALIBRATION == true)
+                /* Rotor count from the calibration fit, 0 after a lock */
+                gPositionCalc.posCnt = gEncoderCalib.startCount;
+#endif
+#if(ENABLE_INITIAL_POSITION_DETECTION == true)
+                if(gIPD.step == IPD_DONE)
+                {
+                    gPositionCalc.posCnt = gIPD.startCount;
+                }
+#endif
+#endif
+#if(ENABLE_SPEED_MT == true)
+                MCAPP_SpeedMTReset(0U);
+#endif
+#if(ENABLE_ANGLE_PLL == true)
+                MCAPP_AnglePLLReset(0.0f);
+#endif
+#if(BEMF_OBSERVER_MODE != BEMF_OBSERVER_OFF)
+                MCAPP_BemfObserverReset(&gMCLIBCurrentAlphaBeta, 0.0f);
+#endif
                 speed_ref_filtered=0.0f;
                 /* the angle set after alignment */
                 gPositionCalc.rotor_angle_rad_per_sec = 0.0f;
                 gCtrlParam.open_loop_stab_counter = 0U;
             }
         }
+#if(ENABLE_ENCODER_CALIBRATION == true)
+        if(gEncoderCalib.step != ENCODER_CALIB_DONE)
+        {
+            gPositionCalc.rotor_angle_rad_per_sec = MCAPP_EncoderCalibUpdate(qdecStatus);
+            if(gEncoderCalib.step == ENCODER_CALIB_DONE)
+            {
+#if(ENABLE_INDEX_ALIGNMENT == true)
+                if(gEncoderCalib.indexSeen == true)
+                {
+                    gIndexAlign.offset = gEncoderCalib.indexOffset;
+                }
+#endif
+                /* Lock sequence over: closed loop from the next fast loop */
+                gCtrlParam.startup_lock_count = 2U*(uint32_t)LOCK_COUNT_FOR_LOCK_TIME;
+            }
+            else
+            {
+                /* Lock sequence held at its start while the calibration runs */
+                gCtrlParam.startup_lock_count = 0U;
+            }
+        }
+#endif
+#if(ENABLE_INITIAL_POSITION_DETECTION == true)
+        if((gIPD.step == IPD_PULSES) || (gIPD.step == IPD_POLARITY))
+        {
+            /* No lock while the pulses run, they are applied along the pulse angle */
+            gCtrlParam.startup_lock_count = 0U;
+            gPositionCalc.rotor_angle_rad_per_sec = gIPD.axis.angle;
+        }
+#endif
     }
     else
     {
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+        /* Envelopes are the average of the last carrier period: lead the tracked angle by half of it */
+        resolverAngle = gResolver.angleQ32 + (uint32_t)(int32_t)(gResolver.speed * MOTOR_RESOLVER_LATENCY_TO_ANGLE_Q32);
+        /* Electrical phase: the 32 bit product wraps once per electrical revolution */
+        gPositionCalc.angleQ32 = (resolverAngle * MOTOR_RESOLVER_TO_ANGLE_Q32) + gResolver.offsetQ32;
+        gPositionCalc.rotor_angle_rad_per_sec = (float)gPositionCalc.angleQ32 * MOTOR_ANGLE_Q32_TO_RAD;
+#else
         /* Switched to closed loop..*/
         gPositionCalc.QDECcnt = (uint16_t)((TC1_REGS->TC_CHANNEL[0].TC_CV)& 0xFFFFu);        
-        if((gPositionCalc.QDECcnt>QDEC_UPPER_THRESHOLD) && (gPositionCalc.QDECcntZ<QDEC_LOWER_THRESHOLD))
-        {
-            gPositionCalc.posCompensation += QDEC_UNDERFLOW;
-        } else if((gPositionCalc.QDECcntZ>QDEC_UPPER_THRESHOLD) && (gPositionCalc.QDECcnt<QDEC_LOWER_THRESHOLD))
+#if(ENABLE_SPEED_MT == true)
+        MCAPP_SpeedMTUpdate(gPositionCalc.QDECcnt);
+#endif
+
+        /* Mechanical count: one fast loop moves far less than a revolution,
+           a single add or subtract wraps it */
+        countDelta = MCAPP_QDECDelta(gPositionCalc.QDECcnt, gPositionCalc.QDECcntZ);
+        gPositionCalc.angleQ32 = MCAPP_EncoderCountUpdate(countDelta, &gPositionCalc.posCnt, &gPositionCalc.position);
+#if(ENABLE_INDEX_ALIGNMENT == true)
+        MCAPP_IndexAlign(qdecStatus);
+#endif
+        gPositionCalc.rotor_angle_rad_per_sec = (float)gPositionCalc.angleQ32 * MOTOR_ANGLE_Q32_TO_RAD;
+#endif
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+        sensorAngle = true;
+#endif
+#if(BEMF_OBSERVER_MODE != BEMF_OBSERVER_OFF)
+        MCAPP_BemfObserverUpdate(&gMCLIBVoltageAlphaBeta, &gMCLIBCurrentAlphaBeta, gPositionCalc.rotor_angle_rad_per_sec);
+#endif
+#if(ENABLE_ANGLE_PLL == true)
+        MCAPP_AnglePLLUpdate(gPositionCalc.rotor_angle_rad_per_sec);
+#if(ANGLE_PLL_FOC_ANGLE == true)
+        gPositionCalc.rotor_angle_rad_per_sec = gAnglePLL.angle;
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+        sensorAngle = false;
+#endif
+#endif
+#endif
+#if(BEMF_OBSERVER_MODE != BEMF_OBSERVER_OFF)
+        if(gBemfObserver.inUse == true)
         {
-            gPositionCalc.posCompensation += QDEC_OVERFLOW;           
-        } else{ 
-            /* No Operation*/
-        }        
-        
-        gPositionCalc.posCompensation = gPositionCalc.posCompensation % ENCODER_PULSES_PER_EREV;
-        gPositionCalc.posCntTmp = (uint32_t)((uint32_t)gPositionCalc.QDECcnt + (uint32_t)gPositionCalc.posCompensation);  
-        gPositionCalc.posCnt =(uint16_t) (gPositionCalc.posCntTmp % ENCODER_PULSES_PER_EREV);
-        gPositionCalc.rotor_angle_rad_per_sec = ((float)gPositionCalc.posCnt) * (2.0f * (float)M_PI / (float)ENCODER_PULSES_PER_EREV);
+            gPositionCalc.rotor_angle_rad_per_sec = gBemfObserver.angle;
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+            sensorAngle = false;
+#endif
+        }
+#endif
+#if(POSITION_SENSOR == POSITION_SENSOR_ENCODER)
         gPositionCalc.QDECcntZ = gPositionCalc.QDECcnt;
+#endif
     }
 
     /* Limit rotor angle range to 0 to 2*M_PI for lookup table */
@@ -282,66 +566,251 @@ __STATIC_INLINE void MCAPP_MotorAngleCalc(void)
     {
       gfocParam.angle = gPositionCalc.rotor_angle_rad_per_sec;
     }
+
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+    /* Binary angle of the Q31 loop: the sensor angle as is, the other angle sources converted */
+    if(sensorAngle == true)
+    {
+        gMCLIBPositionQ31.angle = gPositionCalc.angleQ32;
+    }
+    else
+    {
+        gMCLIBPositionQ31.angle = MCLIB_AngleToQ31(gfocParam.angle);
+    }
+#endif
 }
 
+#if(ENABLE_INDEX_ALIGNMENT == true)
 /******************************************************************************/
-/* Function name: MCAPP_ADCOffsetCalibration                                  */
-/* Function parameters: None                                                  */
+/* Function name: MCAPP_IndexAlign                                            */
+/* Function parameters: qdecStatus - QDEC status read in this loop            */
 /* Function return: None                                                      */
-/* Description: Measures motor phase current offsets.Limits the offset if it  */
-/*              exceeds the predetermined range.                              */
+/* Description: Index alignment of the mechanical count, called every fast    */
+/*              loop in closed loop, after the count is computed. A           */
+/*              correction also moves the electrical and the PLL angle.       */
 /******************************************************************************/
-
-static void MCAPP_ADCOffsetCalibration(void)
+__STATIC_INLINE void MCAPP_IndexAlign(uint32_t qdecStatus)
 {
-    uint32_t AdcSampleCounter = 0u;
-    uint32_t phaseUOffsetBuffer = 0u;
-    uint32_t phaseVOffsetBuffer = 0u;
+    bool learn = true;
 
-    for(AdcSampleCounter = 0u; AdcSampleCounter < CURRENTS_OFFSET_SAMPLES; AdcSampleCounter++)
+#if(ENABLE_INITIAL_POSITION_DETECTION == true)
+    /* The detected angle is only good to its tolerance: learn after a lock start */
+    learn = (gIPD.step != IPD_DONE);
+#endif
+    if(MCAPP_IndexAlignUpdate(qdecStatus, &gPositionCalc.posCnt, learn) == true)
     {
-        /* Wait next sample */
-        uint32_t sample = sinc3_out_sample_count;
-        do
+        gPositionCalc.angleQ32 = gPositionCalc.posCnt * MOTOR_ENCODER_COUNT_TO_ANGLE_Q32;
+#if(ENABLE_ANGLE_PLL == true)
+        /* Move the PLL with the angle, its speed is unchanged */
+        gAnglePLL.angle += (float)(gIndexAlign.lastError * MOTOR_ENCODER_COUNT_TO_ANGLE_Q32) * MOTOR_ANGLE_Q32_TO_RAD;
+        if(gAnglePLL.angle >= (2.0f * PI))
         {
-            NOP();
-        } while (sinc3_out_sample_count == sample);
-
-        phaseUOffsetBuffer += gCurrentU.sinc3_out;
-        phaseVOffsetBuffer += gCurrentV.sinc3_out;
-    }
-
-    phaseCurrentUOffset = phaseUOffsetBuffer/CURRENTS_OFFSET_SAMPLES;
-    phaseCurrentVOffset = phaseVOffsetBuffer/CURRENTS_OFFSET_SAMPLES;
-
-    /* Limit motor phase A current offset calibration to configured Min/Max levels. */
-    if(phaseCurrentUOffset >  CURRENT_OFFSET_MAX)
-    {
-        phaseCurrentUOffset = CURRENT_OFFSET_MAX;
-    }
-    else if(phaseCurrentUOffset <  CURRENT_OFFSET_MIN)
-    {
-        phaseCurrentUOffset = CURRENT_OFFSET_MIN;
+            gAnglePLL.angle -= 2.0f * PI;
+        }
+#endif
     }
     else
     {
         /* No Operation*/
     }
+}
+#endif
 
-    /* Limit motor phase B current offset calibration to configured Min/Max levels. */
-    if(phaseCurrentVOffset >  CURRENT_OFFSET_MAX)
+#if(ENABLE_INITIAL_POSITION_DETECTION == true)
+/******************************************************************************/
+/* Function name: MCAPP_IPDPulseApply                                         */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Runs the detection on the present currents and replaces the  */
+/*              current controller voltages with its pulse. Called every fast */
+/*              loop of the detection, after the current controllers.         */
+/******************************************************************************/
+__STATIC_INLINE void MCAPP_IPDPulseApply(void)
+{
+    float voltage;
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+    MCLIB_I_ALPHA_BETA current;
+
+    current.iAlpha = MCLIB_Q31ToFloat(gMCLIBCurrentAlphaBetaQ31.iAlpha) * Q31_CURRENT_BASE;
+    current.iBeta = MCLIB_Q31ToFloat(gMCLIBCurrentAlphaBetaQ31.iBeta) * Q31_CURRENT_BASE;
+    voltage = MCAPP_IPDUpdate(&current);
+#else
+    voltage = MCAPP_IPDUpdate(&gMCLIBCurrentAlphaBeta);
+#endif
+
+    /* Voltage along the pulse angle, controllers held at zero */
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+    gMCLIBVoltageDQQ31.vd = MCLIB_FloatToQ31(voltage);
+    gMCLIBVoltageDQQ31.vq = 0;
+    gPIParmDQ31.dSum = 0;
+    gPIParmQQ31.dSum = 0;
+#else
+    gPIParmD.dSum = 0.0f;
+    gPIParmQ.dSum = 0.0f;
+#endif
+    gMCLIBVoltageDQ.vd = voltage;
+    gMCLIBVoltageDQ.vq = 0.0f;
+
+    if(gIPD.step == IPD_DONE)
     {
-        phaseCurrentVOffset = CURRENT_OFFSET_MAX;
+        /* Angle known: switch to closed loop */
+        gCtrlParam.startup_lock_count = 2U*(uint32_t)LOCK_COUNT_FOR_LOCK_TIME;
     }
-    else if(phaseCurrentVOffset <  CURRENT_OFFSET_MIN)
+}
+#endif
+
+#if(ENABLE_FLYING_START == true)
+/******************************************************************************/
+/* Function name: MCAPP_EncoderTrack                                          */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Follows the encoder count while the fast loop is stopped, so  */
+/*              that the angle of a coasting or hand turned rotor stays       */
+/*              known. Any count change below half the QDEC range is taken.   */
+/******************************************************************************/
+static void MCAPP_EncoderTrack(void)
+{
+    uint16_t count;
+    int32_t countDelta;
+
+    count = (uint16_t)((TC1_REGS->TC_CHANNEL[0].TC_CV) & 0xFFFFu);
+    countDelta = MCAPP_QDECDelta(count, gPositionCalc.QDECcntZ);
+    gPositionCalc.angleQ32 = MCAPP_EncoderCountUpdate(countDelta, &gPositionCalc.posCnt, &gPositionCalc.position);
+    gPositionCalc.QDECcnt = count;
+    gPositionCalc.QDECcntZ = count;
+#if(ENABLE_INDEX_ALIGNMENT == true)
+    /* The fast loop is stopped, this is the only QDEC status reader */
+    MCAPP_IndexAlign(TC1_QuadratureStatusGet());
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_FlyingStart                                           */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Loads the control loops with the rotor speed of the last      */
+/*              window, with the PWM still off. Below                         */
+/*              FLYING_START_MIN_SPEED_RPM the loops start from zero, on the  */
+/*              tracked angle.                                                */
+/******************************************************************************/
+static void MCAPP_FlyingStart(void)
+{
+    float speed;
+    float vq;
+#if((ENABLE_ANGLE_PLL == true) || (BEMF_OBSERVER_MODE != BEMF_OBSERVER_OFF))
+    float angle;
+#endif
+#if(BEMF_OBSERVER_MODE != BEMF_OBSERVER_OFF)
+    bool encoderFault;
+#endif
+
+    /* Angle of this instant, speed of the last window */
+    MCAPP_EncoderTrack();
+    speed = MCAPP_FlyingStartCatch();
+
+    /* Speed loop: the ramp starts from the rotor speed, either way round */
+    gCtrlParam.velRef = speed * (float)gCtrlParam.direction;
+    gCtrlParam.idRef = 0.0f;
+    gCtrlParam.iqRef = 0.0f;
+    MCAPP_SchedulerSync();
+    speed_elec_rad_per_sec = speed;
+
+    /* Speed loop count difference starts on the present count */
+    gPositionCalc.prev_position_count = gPositionCalc.QDECcntZ;
+    gCtrlParam.oldStatus = MOTOR_STATUS_RUNNING;
+
+    /* Current loops: the back EMF is the q-axis voltage of zero current */
+    vq = fmaxf(fminf(speed * (MOTOR_BEMF_CONST_VPK_PH_PER_RAD_PER_SEC_ELEC / MOTOR_PHASE_VOLTS_PER_UNIT),
+                     gPIParmQ.outMax), gPIParmQ.outMin);
+    gFlyingStart.vqFeedForward = vq;
+    gPIParmQ.dSum = vq;
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+    gPIParmQQ31.dSum = MCLIB_FloatToQ31(vq);
+#endif
+
+    /* Speed and angle estimators start on the rotor, not at standstill */
+#if((ENABLE_ANGLE_PLL == true) || (BEMF_OBSERVER_MODE != BEMF_OBSERVER_OFF))
+    angle = (float)gPositionCalc.angleQ32 * MOTOR_ANGLE_Q32_TO_RAD;
+#endif
+#if(ENABLE_SPEED_MT == true)
+    MCAPP_SpeedMTReset(gPositionCalc.QDECcntZ);
+    gSpeedMT.speed = speed;
+#endif
+#if(ENABLE_ANGLE_PLL == true)
+    MCAPP_AnglePLLReset(angle);
+    gAnglePLL.speed = speed;
+#endif
+#if(BEMF_OBSERVER_MODE != BEMF_OBSERVER_OFF)
+    /* An encoder found faulty stays faulty */
+    encoderFault = gBemfObserver.encoderFault;
+    MCAPP_BemfObserverReset(&gMCLIBCurrentAlphaBeta, angle);
+    gBemfObserver.encoderFault = encoderFault;
+    gBemfObserver.esq = speed / MOTOR_BEMF_OBSERVER_INV_KE;
+    gBemfObserver.omega = speed;
+    gBemfObserver.speed = speed;
+#endif
+#if(ENABLE_GAIN_SCHEDULING == true)
+    /* Gains of the rotor speed from the first fast loop */
+    MCAPP_GainScheduleUpdate(speed, 0.0f);
+#endif
+}
+#endif
+
+/******************************************************************************/
+/* Function name: MCAPP_OffsetCalibStart                                      */
+/* Function parameters: nextState - state once the offsets are measured       */
+/* Function return: None                                                      */
+/* Description: Starts the current sense and the offset measurement. The     */
+/*              samples are taken in the MC_APP_STATE_OFFSET_CALIBRATION      */
+/*              state.                                                        */
+/******************************************************************************/
+static void MCAPP_OffsetCalibStart(MC_APP_STATE nextState)
+{
+    /* ADC conversion start */
+    TC0_CH1_TimerStart();
+    TC3_CH0_CaptureStart();
+    TC3_CH1_CaptureStart();
+
+    offsetCalibNextState = nextState;
+    MCAPP_OffsetCalibReset(sinc3_out_sample_count);
+    gMCAPPData.mcState = MC_APP_STATE_OFFSET_CALIBRATION;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_OffsetApply                                           */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Rounds the measured offsets to the fast loop ones.            */
+/******************************************************************************/
+__STATIC_INLINE void MCAPP_OffsetApply(void)
+{
+    phaseCurrentUOffset = (uint32_t)(gOffsetCalib.trackU + 0.5f);
+    phaseCurrentVOffset = (uint32_t)(gOffsetCalib.trackV + 0.5f);
+}
+
+#if(ENABLE_OFFSET_TRACKING == true)
+/******************************************************************************/
+/* Function name: MCAPP_OffsetTrack                                           */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Background task while the bridge is off. The fast loop is     */
+/*              stopped: the tracked offsets are applied at once.             */
+/******************************************************************************/
+static void MCAPP_OffsetTrack(void)
+{
+    if(MCAPP_OffsetTrackDue(sinc3_out_sample_count) == true)
     {
-        phaseCurrentVOffset = CURRENT_OFFSET_MIN;
+        /* The current the fast loop would read */
+        MCAPP_OffsetTrackUpdate(MCAPP_PhaseCurrentSum(&gCurrentU, 0U),
+                                MCAPP_PhaseCurrentSum(&gCurrentV, 0U));
+        MCAPP_OffsetApply();
     }
     else
     {
         /* No Operation*/
     }
 }
+#endif
 
 /******************************************************************************/
 /* Function name: MCAPP_PIOutputInit                                          */
@@ -391,8 +860,55 @@ void MCAPP_MotorPIParamInit(void)
     gPIParmQref.outMin = -SPEEDCNTR_OUTMAX;
 
     MCAPP_PIOutputInit(&gPIParmQref);
+
+#if(POSITION_MODE == true)
+    /**************** PI Position Control **************************************/
+    gPIParmPos.kp = POSCNTR_PTERM;
+    gPIParmPos.ki = POSCNTR_ITERM;
+    gPIParmPos.kc = POSCNTR_CTERM;
+    gPIParmPos.outMax = POSCNTR_OUTMAX;
+    gPIParmPos.outMin = -POSCNTR_OUTMAX;
+
+    MCAPP_PIOutputInit(&gPIParmPos);
+#endif
+
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+    /**************** PI D and Q Terms, Q31 ***********************************/
+    MCLIB_PIParamToQ31(&gPIParmD, Q31_CURRENT_BASE, &gPIParmDQ31);
+    MCLIB_PIParamToQ31(&gPIParmQ, Q31_CURRENT_BASE, &gPIParmQQ31);
+#endif
+
+#if(ENABLE_GAIN_SCHEDULING == true)
+    /* Drop any scheduled gain set not yet consumed by the fast loop */
+    gPIGainsShadowPending = false;
+#endif
 }
 
+#if(ENABLE_GAIN_SCHEDULING == true)
+/******************************************************************************/
+/* Function name: MCAPP_PIGainsApply                                          */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Swaps the shadow gains into the PI controllers. Called from   */
+/*              the fast control loop, so the controllers never run with a    */
+/*              partially updated gain set.                                   */
+/******************************************************************************/
+__STATIC_INLINE void MCAPP_PIGainsApply(void)
+{
+    gPIParmD.kp = gPIGainsShadow.dKp;
+    gPIParmD.ki = gPIGainsShadow.dKi;
+    gPIParmQ.kp = gPIGainsShadow.qKp;
+    gPIParmQ.ki = gPIGainsShadow.qKi;
+    gPIParmQref.kp = gPIGainsShadow.speedKp;
+    gPIParmQref.ki = gPIGainsShadow.speedKi;
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+    MCLIB_PIParamToQ31(&gPIParmD, Q31_CURRENT_BASE, &gPIParmDQ31);
+    MCLIB_PIParamToQ31(&gPIParmQ, Q31_CURRENT_BASE, &gPIParmQQ31);
+#endif
+    gPIGainsShadowPending = false;
+}
+#endif
+
 /******************************************************************************/
 /* Function name: MCAPP_MotorControlParamInit                                 */
 /* Function parameters: None                                                  */
@@ -415,59 +931,57 @@ static void MCAPP_MotorControlParamInit(void)
     gCtrlParam.motorStatus = MOTOR_STATUS_STOPPED;
     gMCLIBCurrentDQ.id = 0.0f;
     gMCLIBCurrentDQ.iq = 0.0f;
-    gCtrlParam.rampIncStep = SPEED_RAMP_INC_SLOW_LOOP;
     gCtrlParam.velRef = 0.0f;
+#if((TORQUE_MODE == false) && (POSITION_MODE == false))
+    MCAPP_SpeedRampReset();
+#endif
     MCAPP_PIOutputInit(&gPIParmD);
     MCAPP_PIOutputInit(&gPIParmQ);
     MCAPP_PIOutputInit(&gPIParmQref);
+#if(POSITION_MODE == true)
+    /* Hold the present position */
+    MCAPP_PIOutputInit(&gPIParmPos);
+    MCAPP_TrajectoryReset(gPositionCalc.position);
+#endif
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+    gMCLIBSVPWMQ31.period = (uint32_t)MAX_DUTY;
+    gMCLIBPositionQ31.angle = 0U;
+    gMCLIBCurrentDQQ31.id = 0;
+    gMCLIBCurrentDQQ31.iq = 0;
+    gPIParmDQ31.dSum = 0;
+    gPIParmDQ31.out = 0;
+    gPIParmQQ31.dSum = 0;
+    gPIParmQQ31.out = 0;
+#endif
 
     gPositionCalc.rotor_angle_rad_per_sec = 0.0f;
     gPositionCalc.elec_rotation_count = 0U;
-    gPositionCalc.prev_position_count = 0;
-    gPositionCalc.present_position_count = 0;
+    gPositionCalc.prev_position_count = 0U;
+    gPositionCalc.present_position_count = 0U;
     speed_ref_filtered = 0.0f;
 }
 
+#if(POSITION_MODE == true)
 /******************************************************************************/
-/* Function name: MCAPP_SlowLoopTimeIsFinished                                */
-/* Function parameters: None                                                  */
-/* Function return: Bool( True - executes slow control loop )                 */
-/* Description: To be used in a while loop; It returns true                   */
-/******************************************************************************/
-__STATIC_INLINE bool MCAPP_SlowLoopTimeIsFinished(void)
-{
-    bool retval = false;
-    if(SLOW_LOOP_TIME_PWM_COUNT <= gCtrlParam.sync_cnt)
-    {
-        gCtrlParam.sync_cnt = 0U;
-        retval = true;
-    }
-    return( retval );
-}
-
-#if(TORQUE_MODE == false)
-/******************************************************************************/
-/* Function name: MCAPP_Spee                                                  */
+/* Function name: MCAPP_PositionControl                                       */
 /* Function parameters: None                                                  */
 /* Function return: None                                                      */
-/* Description: Increment/Decrements speed reference based upon ramp          */
-/*              configuration in "userparams.h" file.                         */
+/* Description: Position loop, at the speed loop rate. The trajectory speed   */
+/*              is fed forward, the P/PI controller corrects the position     */
+/*              error; the sum is the speed loop reference.                   */
 /******************************************************************************/
-__STATIC_INLINE void MCAPP_SpeedRamp(void)
+__STATIC_INLINE void MCAPP_PositionControl(void)
 {
-   if(gCtrlParam.endSpeed > (gCtrlParam.velRef + gCtrlParam.rampIncStep))
-   {
-      gCtrlParam.velRef += gCtrlParam.rampIncStep;
-   }
-   else if(gCtrlParam.endSpeed < (gCtrlParam.velRef - gCtrlParam.rampIncStep))
-   {
-      gCtrlParam.velRef -= gCtrlParam.rampIncStep;
-   }
-   else
-   {
-      gCtrlParam.velRef = gCtrlParam.endSpeed;
-   }
+    MCAPP_TrajectoryUpdate();
+
+    /* Both positions relative to the trajectory origin: small, wrap safe */
+    gPIParmPos.inRef = gTrajectory.pos;
+    gPIParmPos.inMeas = (float)(int32_t)((uint32_t)gPositionCalc.position - (uint32_t)gTrajectory.origin);
+    MCLIB_PIControl(&gPIParmPos);
+
+    gPIParmQref.inRef = (gTrajectory.vel + gPIParmPos.out) * MOTOR_ENCODER_COUNT_TO_RAD_ELEC;
 }
+
 #endif
 
 /******************************************************************************/
@@ -495,34 +1009,73 @@ __STATIC_INLINE void MCAPP_PWMDutyUpdate(uint32_t duty_PhU, uint32_t duty_PhV, u
 
 void MCAPP_ControlLoopISR(TC_COMPARE_STATUS status, uintptr_t context)
 {    
-    float phaseCurrentU;
-    float phaseCurrentV;
-    float temp;
+    uint32_t start = DWT->CYCCNT;
+#if(ENABLE_Q31_CURRENT_LOOP == false)
+    int32_t phaseCurrentU;
+    int32_t phaseCurrentV;
+#endif
     X2Cscope_Update();
+
+#if(ENABLE_GAIN_SCHEDULING == true)
+    /* Swap in the gains published by the slow control loop */
+    if(gPIGainsShadowPending == true)
+    {
+        MCAPP_PIGainsApply();
+    }
+#endif
    
    /* PB17 GPIO is used for timing measurement. - Set High*/
     PIOB_REGS->PIO_SODR = (uint32_t)((uint32_t)1U << (17U & 0x1FU));
 
- 	/* Weight average on 4 last samples */
-    temp = 2.0f * (float)gCurrentU.sinc3_out;
-    temp += 4.0f * (float)gCurrentU.sinc3_out_p;
-    temp += 3.0f * (float)gCurrentU.sinc3_out_pp;
-    temp += (float)gCurrentU.sinc3_out_ppp;
-    phaseCurrentU = ((float)temp / 10.0f);
-	
-    temp = 2.0f * (float)gCurrentV.sinc3_out;
-    temp +=4.0f * (float)gCurrentV.sinc3_out_p;
-    temp +=3.0f * (float)gCurrentV.sinc3_out_pp;
-    temp += (float)gCurrentV.sinc3_out_ppp;
-    phaseCurrentV = ((float)temp / 10.0f);
+#if(ENABLE_Q31_CURRENT_LOOP == true)
+    /* Offset removed, weighted average phase currents in Q31 per unit */
+    gMCLIBCurrentABCQ31.ia = MCAPP_PhaseCurrentQ31(&gCurrentU, phaseCurrentUOffset);
+    gMCLIBCurrentABCQ31.ib = MCAPP_PhaseCurrentQ31(&gCurrentV, phaseCurrentVOffset);
+
+    /* Clarke transform */
+    MCLIB_ClarkeTransform_Q31(&gMCLIBCurrentABCQ31, &gMCLIBCurrentAlphaBetaQ31);
+
+    /* Park transform */
+    MCLIB_ParkTransform_Q31(&gMCLIBCurrentAlphaBetaQ31, &gMCLIBPositionQ31, &gMCLIBCurrentDQQ31);
+
+    /* Currents in Amps for the slow loop and X2Cscope */
+    gMCLIBCurrentDQ.id = MCLIB_Q31ToFloat(gMCLIBCurrentDQQ31.id) * Q31_CURRENT_BASE;
+    gMCLIBCurrentDQ.iq = MCLIB_Q31ToFloat(gMCLIBCurrentDQQ31.iq) * Q31_CURRENT_BASE;
+
+#if(BEMF_OBSERVER_MODE != BEMF_OBSERVER_OFF)
+    /* Back EMF observer inputs: present currents, voltages of the last period */
+    gMCLIBCurrentAlphaBeta.iAlpha = MCLIB_Q31ToFloat(gMCLIBCurrentAlphaBetaQ31.iAlpha) * Q31_CURRENT_BASE;
+    gMCLIBCurrentAlphaBeta.iBeta = MCLIB_Q31ToFloat(gMCLIBCurrentAlphaBetaQ31.iBeta) * Q31_CURRENT_BASE;
+    gMCLIBVoltageAlphaBeta.vAlpha = MCLIB_Q31ToFloat(gMCLIBVoltageAlphaBetaQ31.vAlpha);
+    gMCLIBVoltageAlphaBeta.vBeta = MCLIB_Q31ToFloat(gMCLIBVoltageAlphaBetaQ31.vBeta);
+#endif
+
+    /* Calculate control values  */
+    MCAPP_MotorCurrentControl();
+
+    /* Calculate park angle */
+    MCAPP_MotorAngleCalc();
+
+    gMCLIBPosition.angle = gfocParam.angle;
+
+    /* Calculate qSin,qCos from qAngle  */
+    MCLIB_SinCosCalc_Q31( &gMCLIBPositionQ31 );
+
+    /* Calculate qValpha, qVbeta from qSin,qCos,qVd,qVq */
+    MCLIB_InvParkTransform_Q31(&gMCLIBVoltageDQQ31, &gMCLIBPositionQ31, &gMCLIBVoltageAlphaBetaQ31);
+
+    /* Calculate and set PWM duty cycles from Vr1,Vr2,Vr3 */
+    MCLIB_SVPWMGen_Q31(&gMCLIBVoltageAlphaBetaQ31, &gMCLIBSVPWMQ31);
 
-    /* Remove the offset from measured motor currents */
-    phaseCurrentU = phaseCurrentU - (float)(phaseCurrentUOffset);
-    phaseCurrentV = phaseCurrentV - (float)(phaseCurrentVOffset);
+    MCAPP_PWMDutyUpdate(gMCLIBSVPWMQ31.dPWM1, gMCLIBSVPWMQ31.dPWM2, gMCLIBSVPWMQ31.dPWM3);
+#else
+ 	/* Weight average on 4 last samples, offset removed */
+    phaseCurrentU = MCAPP_PhaseCurrentSum(&gCurrentU, phaseCurrentUOffset);
+    phaseCurrentV = MCAPP_PhaseCurrentSum(&gCurrentV, phaseCurrentVOffset);
 
     /* Non Inverting amplifiers for current sensing */
-    gMCLIBCurrentABC.ia  = phaseCurrentU * (float)(0.000112);
-    gMCLIBCurrentABC.ib  = phaseCurrentV * (float)(0.000112);
+    gMCLIBCurrentABC.ia  = (float)phaseCurrentU * CURRENT_SUM_TO_AMPS;
+    gMCLIBCurrentABC.ib  = (float)phaseCurrentV * CURRENT_SUM_TO_AMPS;
 
     /* Clarke transform */
     MCLIB_ClarkeTransform(&gMCLIBCurrentABC, &gMCLIBCurrentAlphaBeta);
@@ -548,29 +1101,41 @@ void MCAPP_ControlLoopISR(TC_COMPARE_STATUS status, uintptr_t context)
     MCLIB_SVPWMGen(&gMCLIBVoltageAlphaBeta, &gMCLIBSVPWM);
 
     MCAPP_PWMDutyUpdate(gMCLIBSVPWM.dPWM1, gMCLIBSVPWM.dPWM2, gMCLIBSVPWM.dPWM3);
+#endif
   
-    /* sync count for slow control loop execution */
-    gCtrlParam.sync_cnt++;
+    /* Release of the medium and slow rate tasks */
+    if(MCAPP_SchedulerTick() == true)
+    {
+        /* Released rates run from the background tasks */
+        MCAPP_EventPost(MCAPP_EVENT_RATE);
+    }
+
+    MCAPP_RateStatsUpdate(MCAPP_RATE_FAST, DWT->CYCCNT - start);
+    if(NVIC_GetPendingIRQ(TC0_CH0_IRQn) != 0U)
+    {
+        /* Next PWM period already started */
+        gRates[MCAPP_RATE_FAST].overruns++;
+    }
 
     /* PB17 GPIO is used for timing measurement. - Set Low*/
     PIOB_REGS->PIO_CODR = ((uint32_t)1U <<(17U & 0x1FU));
 }
 
 /******************************************************************************/
-/* Function name: MCAPP_SlowControlLoop                                       */
+/* Function name: MCAPP_SpeedControlLoop                                      */
 /* Function parameters: None                                                  */
 /* Function return: None                                                      */
-/* Description: Slow control loop is in sync with fast control loop           */
-/*              ADCEOCInterruptHandler().Slow loop execution frequency should */
-/*              be in multiple of PWM frequency and be configured by          */
-/*              "SLOW_LOOP_TIME_SEC" MACRO in "userparms.h file.              */
+/* Description: Speed control loop is in sync with fast control loop. It runs */
+/*              in the rate task selected by SPEED_LOOP_RATE, every           */
+/*              SPEED_LOOP_TIME_SEC, configured in "userparams.h" file.       */
 /*               Speed ramp and speed control loop is executed from this loop */
 /******************************************************************************/
-__STATIC_INLINE void MCAPP_SlowControlLoop(void)
+__STATIC_INLINE void MCAPP_SpeedControlLoop(void)
 {
-    int16_t pos_count_diff;
-
 #if(TORQUE_MODE == false)
+#if((ENABLE_ANGLE_PLL == false) && (ENABLE_SPEED_MT == false) && (POSITION_SENSOR == POSITION_SENSOR_ENCODER))
+    int32_t pos_count_diff;
+#endif
 
     if(gCtrlParam.openLoop == false)
     {
@@ -578,29 +1143,68 @@ __STATIC_INLINE void MCAPP_SlowControlLoop(void)
         PIOB_REGS->PIO_SODR = (uint32_t)((uint32_t)1U << (18U & 0x1FU));
         gCtrlParam.endSpeed = motor_speed_target_elec_rad_per_sec;
  
+#if(POSITION_MODE == true)
+        /* Trajectory and position loop: speed reference of the speed loop */
+        MCAPP_PositionControl();
+#else
         /* Speed Ramp */
-        MCAPP_SpeedRamp();
+        gCtrlParam.velRef = MCAPP_SpeedRampUpdate(gCtrlParam.velRef, gCtrlParam.endSpeed);
+#endif
 
         /* Speed Calculation from Encoder */
-        gPositionCalc.present_position_count = (int16_t)(TC1_REGS->TC_CHANNEL[0].TC_CV);
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+        /* Resolver tracking loop speed of the fast loop */
+        speed_elec_rad_per_sec = gResolver.speed * MOTOR_RESOLVER_SPEED_TO_ELEC;
+#elif(ENABLE_ANGLE_PLL == true)
+        /* Angle tracking PLL speed of the fast loop */
+        speed_elec_rad_per_sec = gAnglePLL.speed;
+#elif(ENABLE_SPEED_MT == true)
+        /* Latest M/T measurement of the fast loop */
+        speed_elec_rad_per_sec = gSpeedMT.speed;
+#else
+        gPositionCalc.present_position_count = (uint16_t)(TC1_REGS->TC_CHANNEL[0].TC_CV);
         if( ( gCtrlParam.oldStatus == MOTOR_STATUS_STOPPED ) && ( gCtrlParam.motorStatus == MOTOR_STATUS_RUNNING ))
         {
            gPositionCalc.prev_position_count = gPositionCalc.present_position_count;
         }
-        pos_count_diff = gPositionCalc.present_position_count - gPositionCalc.prev_position_count;
-        speed_elec_rad_per_sec = ((float)pos_count_diff * 2.0f*(float)M_PI)/((float)ENCODER_PULSES_PER_EREV *SLOW_LOOP_TIME_SEC );
+        pos_count_diff = MCAPP_QDECDelta(gPositionCalc.present_position_count, gPositionCalc.prev_position_count);
+        speed_elec_rad_per_sec = (float)pos_count_diff * MOTOR_ENCODER_DIFF_TO_RAD_PER_SEC_ELEC;
         gPositionCalc.prev_position_count = gPositionCalc.present_position_count;
+#endif
+#if(BEMF_OBSERVER_MODE != BEMF_OBSERVER_OFF)
+        /* Observer speed whenever the observer angle drives the FOC */
+        if(gBemfObserver.inUse == true)
+        {
+            speed_elec_rad_per_sec = gBemfObserver.speed;
+        }
+#endif
             
         /* Execute the velocity control loop */
         gPIParmQref.inMeas = speed_elec_rad_per_sec;
+#if(POSITION_MODE == false)
         gPIParmQref.inRef  = gCtrlParam.velRef*(float)gCtrlParam.direction;
+#endif
         MCLIB_PIControl(&gPIParmQref);
+#if(POSITION_MODE == true)
+        /* Torque feed forward of the trajectory acceleration */
+        gCtrlParam.iqRef = fmaxf(fminf(gPIParmQref.out + (gTrajectory.acc * MOTOR_POSITION_ACCEL_TO_IQ),
+                                       gPIParmQref.outMax), gPIParmQref.outMin);
+#else
         gCtrlParam.iqRef = gPIParmQref.out;
+#endif
         gCtrlParam.oldStatus = gCtrlParam.motorStatus;
         /* PB18 GPIO is used for timing measurement. - Set Low*/
         PIOB_REGS->PIO_CODR = (uint32_t)((uint32_t)1U << (18U & 0x1FU));
     }
 #endif	// End of #if(TORQUE_MODE == false)
+
+#if(ENABLE_GAIN_SCHEDULING == true)
+    if(gCtrlParam.openLoop == false)
+    {
+        /* Gains for the next speed loop period, applied by the fast loop */
+        MCAPP_GainScheduleUpdate(speed_elec_rad_per_sec, gCtrlParam.iqRef);
+    }
+#endif
 }
 
 /******************************************************************************/
@@ -614,20 +1218,39 @@ void MCAPP_MotorStart(void)
     /* Stop QDEC Timer */
     /* Initialize motor control variables */
     MCAPP_MotorControlParamInit();
+#if(ENABLE_ENCODER_CALIBRATION == true)
+    if(gEncoderCalib.step != ENCODER_CALIB_DONE)
+    {
+        MCAPP_EncoderCalibReset();
+    }
+#endif
+#if(ENABLE_LOCK_SETTLE_DETECTION == true)
+    if(gCtrlParam.fieldAlignmentFlag == 1U)
+    {
+        MCAPP_LockSettleReset();
+    }
+#endif
+#if(ENABLE_INITIAL_POSITION_DETECTION == true)
+    if(gCtrlParam.fieldAlignmentFlag == 1U)
+    {
+        MCAPP_IPDReset();
+    }
+#endif
     
-    /* ADC conversion start */
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+    /* Current sense already running: the sample timer restarts after the carrier */
+    TC0_CH1_TimerStop();
+    MCAPP_ResolverStart();
     TC0_CH1_TimerStart();
-    TC3_CH0_CaptureStart();
-    TC3_CH1_CaptureStart();
+#endif
 
-    // Skip first 10 samples
-    uint32_t current_count = sinc3_out_sample_count;
-    while (sinc3_out_sample_count < (current_count+10U) )
+#if(ENABLE_FLYING_START == true)
+    if(gCtrlParam.fieldAlignmentFlag == 0U)
     {
-        /*Skip first 10 samples*/
+        /* Angle and speed of the coasting rotor, loops loaded to them */
+        MCAPP_FlyingStart();
     }
-
-    MCAPP_ADCOffsetCalibration();
+#endif
 
     //Enable peripheral control of the PWM low pins : PA4, PA5, PA6
     PIOA_REGS->PIO_MSKR = 0x70U;
@@ -671,6 +1294,70 @@ static uint32_t MCAPP_Median_filter(uint32_t a, uint32_t b, uint32_t c)
     }
 }
 
+/******************************************************************************/
+/* Function name: MCAPP_Sinc1Update                                           */
+/* Function parameters: pChannel - decimation filter of the channel,          */
+/*                      count - free running TC count of the channel          */
+/* Function return: None                                                      */
+/* Description: sinc1 stage: clock periods the bitstream was high since the   */
+/*              last call, integrated three times for the sinc3. The delay    */
+/*              line keeps the median of the last three sinc1 samples.       */
+/*              Forced inline: the count interrupt runs from TCM.             */
+/******************************************************************************/
+__STATIC_FORCEINLINE void MCAPP_Sinc1Update(volatile MCAPP_SINC3 *pChannel, uint32_t count)
+{
+    uint32_t sinc1;
+    uint32_t intg2;
+
+    //Advance median filter delay line
+    pChannel->s1_out_pp = pChannel->s1_out_p;
+    pChannel->s1_out_p = pChannel->sinc1_out;
+
+    //Calculate delta
+    sinc1 = count - pChannel->sinc1_prevq;
+    pChannel->sinc1_prevq = count;
+
+    // Limit sinc1_out value in case of counter error
+    if (sinc1 > SIGMA_DELTA_SINC1_PERIOD_COUNT)
+    {
+        sinc1 = SIGMA_DELTA_SINC1_PERIOD_COUNT;
+    }
+    intg2 = pChannel->intg2;
+    pChannel->intg3 = (pChannel->intg3 + intg2);
+    pChannel->intg2 = (intg2 + pChannel->intg1);
+    pChannel->intg1 = (pChannel->intg1 + sinc1);
+
+    // Calculate median
+    pChannel->sinc1_out = MCAPP_Median_filter(sinc1, pChannel->s1_out_pp, pChannel->s1_out_p);
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_Sinc3Decimate                                         */
+/* Function parameters: pChannel - decimation filter of the channel           */
+/* Function return: None                                                      */
+/* Description: sinc3 differentiators, once every SIGMA_DELTA_SINC3_DECIMATION*/
+/*              sinc1 samples. Keeps the last four sinc3 samples.             */
+/******************************************************************************/
+__STATIC_FORCEINLINE void MCAPP_Sinc3Decimate(volatile MCAPP_SINC3 *pChannel)
+{
+    uint32_t intg3;
+    uint32_t der2;
+    uint32_t der1;
+
+    //Average 3 sample delay line
+    pChannel->sinc3_out_ppp = pChannel->sinc3_out_pp;
+    pChannel->sinc3_out_pp = pChannel->sinc3_out_p;
+    pChannel->sinc3_out_p = pChannel->sinc3_out;
+
+    intg3 = pChannel->intg3;
+    der2 = pChannel->der2;
+    der1 = pChannel->der1;
+    pChannel->sinc3_out = (intg3 - der1 - der2 - pChannel->der3);
+    pChannel->der3 = (intg3 - der1 - der2);
+    pChannel->der2 = (intg3 - der1);
+    pChannel->der1 = (intg3);
+}
+
 /******************************************************************************/
 /* Function name: MCAPP_CurrentSNSCountISR                                    */
 /* Function parameters: None                                                  */
@@ -680,92 +1367,38 @@ static uint32_t MCAPP_Median_filter(uint32_t a, uint32_t b, uint32_t c)
 /******************************************************************************/
 void __attribute__ ((tcm)) MCAPP_CurrentSNSCountISR(TC_TIMER_STATUS status, uintptr_t context)
 {
-    uint32_t temp1, temp2, temp3;
     /* PB28 GPIO is used for timing measurement. - Set High*/    
     PIOB_REGS->PIO_SODR =(uint32_t)((uint32_t)1U << (28U & 0x1FU));
 
     currentUActive = TC3_REGS->TC_CHANNEL[0].TC_CV;
     currentVActive = TC3_REGS->TC_CHANNEL[1].TC_CV;
 
-    //Advance median filter delay line - channel U
-    gCurrentU.s1_out_pp = gCurrentU.s1_out_p;
-    gCurrentU.s1_out_p = gCurrentU.sinc1_out;
-    
-    //Advance median filter delay line - channel V
-    gCurrentV.s1_out_pp = gCurrentV.s1_out_p;
-    gCurrentV.s1_out_p = gCurrentV.sinc1_out;
-    
-    //Calculate delta for channel U
-    temp3 = currentUActive;
-    gCurrentU.sinc1_out = temp3 - gCurrentU.sinc1_prevq;
-    gCurrentU.sinc1_prevq = temp3;
-
-    // Limit sinc1_out value in case of counter error
-    if (gCurrentU.sinc1_out > 200U)
-    {
-        gCurrentU.sinc1_out = 200U;
-    }
-    temp2 =gCurrentU.intg2;
-    gCurrentU.intg3 = (gCurrentU.intg3 + temp2);
-    gCurrentU.intg2 = (temp2 + gCurrentU.intg1);
-    temp1=gCurrentU.sinc1_out;
-    gCurrentU.intg1 = (gCurrentU.intg1 + temp1);
-    
-    temp2=gCurrentU.s1_out_pp;
-    // Calculate median for channel U
-    gCurrentU.sinc1_out = MCAPP_Median_filter(temp1, temp2, gCurrentU.s1_out_p);
-    
-    //Calculate delta for channel V
-    temp3 = currentVActive;
-    gCurrentV.sinc1_out = temp3 - gCurrentV.sinc1_prevq;
-    gCurrentV.sinc1_prevq = currentVActive;
-    
-    // Limit sinc1_out value in case of counter error
-    if (gCurrentV.sinc1_out > 200U)
-    {
-        gCurrentV.sinc1_out = 200U;
-    }
-    temp2=gCurrentV.intg2;
-    gCurrentV.intg3 = (gCurrentV.intg3 + temp2);
-    gCurrentV.intg2 = (temp2 + gCurrentV.intg1);
-    temp1=gCurrentV.sinc1_out;
-    gCurrentV.intg1 = (gCurrentV.intg1 + temp1);
-    temp2=gCurrentV.s1_out_pp;
-    // Calculate median for channel V
-    gCurrentV.sinc1_out = MCAPP_Median_filter(temp1, temp2, gCurrentV.s1_out_p);
+    MCAPP_Sinc1Update(&gCurrentU, currentUActive);
+    MCAPP_Sinc1Update(&gCurrentV, currentVActive);
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+    MCAPP_Sinc1Update(&gResolverSin, TC2_REGS->TC_CHANNEL[0].TC_CV);
+    MCAPP_Sinc1Update(&gResolverCos, TC2_REGS->TC_CHANNEL[1].TC_CV);
+#endif
    
     sinc3_count++;
-    if (sinc3_count >= 5U)
+    if (sinc3_count >= SIGMA_DELTA_SINC3_DECIMATION)
     {
         sinc3_count = 0U;
         
-        //Average 3 sample delay line - channel U
-        gCurrentU.sinc3_out_ppp = gCurrentU.sinc3_out_pp;
-        gCurrentU.sinc3_out_pp = gCurrentU.sinc3_out_p;
-        gCurrentU.sinc3_out_p = gCurrentU.sinc3_out;
-
-        //Average 3 sample delay line - channel V
-        gCurrentV.sinc3_out_ppp = gCurrentV.sinc3_out_pp;
-        gCurrentV.sinc3_out_pp = gCurrentV.sinc3_out_p;
-        gCurrentV.sinc3_out_p = gCurrentV.sinc3_out;
-
-        temp3=gCurrentU.intg3;
-        temp2=gCurrentU.der2;
-        temp1=gCurrentU.der1;
-        gCurrentU.sinc3_out = (temp3 - temp1 - temp2 - gCurrentU.der3);
-        gCurrentU.der3 = (temp3 - temp1 - temp2);
-        gCurrentU.der2 = (temp3 - temp1);
-        gCurrentU.der1 = (temp3);
-        
-        temp3=gCurrentV.intg3;
-        temp2=gCurrentV.der2;
-        temp1=gCurrentV.der1;
-        gCurrentV.sinc3_out = (temp3 - temp1 - temp2 - gCurrentV.der3);
-        gCurrentV.der3 = (temp3 - temp1 - temp2);
-        gCurrentV.der2 = (temp3 - temp1);
-        gCurrentV.der1 = (temp3);
+        MCAPP_Sinc3Decimate(&gCurrentU);
+        MCAPP_Sinc3Decimate(&gCurrentV);
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+        MCAPP_Sinc3Decimate(&gResolverSin);
+        MCAPP_Sinc3Decimate(&gResolverCos);
+        MCAPP_ResolverDemodulate((int32_t)gResolverSin.sinc3_out, (int32_t)gResolverCos.sinc3_out);
+#endif
         
         sinc3_out_sample_count++;
+        if(gMCAPPData.mcState == MC_APP_STATE_OFFSET_CALIBRATION)
+        {
+            /* The offset measurement takes every sample */
+            MCAPP_EventPost(MCAPP_EVENT_SENSE);
+        }
     }
 
     /* PA28 GPIO is used for timing measurement. - Set Low*/
@@ -789,11 +1422,23 @@ void MCAPP_MotorStop(void)
 	
 	/* Reset algorithm specific variables for next iteration.*/
 	MCAPP_MotorControlParamInit();
+#if(ENABLE_FLYING_START == true)
+    MCAPP_FlyingStartReset(speed_elec_rad_per_sec, gPositionCalc.position);
+#endif
     
+#if(ENABLE_OFFSET_TRACKING == true)
+    /* Current sense kept running: offset tracking once the currents decayed */
+    MCAPP_OffsetTrackHoldoff(sinc3_out_sample_count);
+#else
     // Stop current measures
     TC0_CH1_TimerStop();
     TC3_CH0_CaptureStop();
     TC3_CH1_CaptureStop();
+    gOffsetCalib.done = false;
+#endif
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+    MCAPP_ResolverStop();
+#endif
 	
     gPIParmQref.inMeas = 0.0f;
     gPIParmQref.inRef = 0.0f;
@@ -845,7 +1490,7 @@ static void MCAPP_SwitchStartDebounce(MC_APP_STATE state)
     if (!(bool)SWITCH_START_Get())
     {
         gMCAPPData.switchStartCount++;
-        if (gMCAPPData.switchStartCount >= 0xFFU)            
+        if (gMCAPPData.switchStartCount >= SWITCH_DEBOUNCE_TICKS)            
         {
            gMCAPPData.switchStartCount = 0U;
            gMCAPPData.switchStartState = MC_APP_SWITCH_PRESSED;
@@ -858,7 +1503,6 @@ static void MCAPP_SwitchStartDebounce(MC_APP_STATE state)
             gMCAPPData.switchStartCount = 0U;
             gMCAPPData.switchStartState = MC_APP_SWITCH_RELEASED;
             gMCAPPData.mcState = state;
-            motor_activity_count = 0U;
             LED3_Clear();
         }
     }
@@ -911,7 +1555,7 @@ static void MCAPP_SwitchIncrDebounce(void)
     if (!(bool)SWITCH_INCR_Get())
     {
         gMCAPPData.switchIncrCount++;
-        if (gMCAPPData.switchIncrCount >= 0xFFU)            
+        if (gMCAPPData.switchIncrCount >= SWITCH_DEBOUNCE_TICKS)            
         {
            gMCAPPData.switchIncrCount = 0U;
            gMCAPPData.switchIncrState = MC_APP_SWITCH_PRESSED;
@@ -923,9 +1567,11 @@ static void MCAPP_SwitchIncrDebounce(void)
         {
             gMCAPPData.switchIncrCount = 0U;
             gMCAPPData.switchIncrState = MC_APP_SWITCH_RELEASED;
-            MCAPP_SpeedIncrease();
-            motor_activity_count = 0U;
-            LED3_Clear();
+#if(POSITION_MODE == true)
+            MCAPP_SetpointPost(0, (int32_t)(POSITION_STEP_REV * ENCODER_PULSES_PER_REV));
+#else
+            MCAPP_SetpointPost(1, 0);
+#endif
         }
     }
 }
@@ -941,7 +1587,7 @@ static void MCAPP_SwitchDecrDebounce(void)
     if (!(bool)SWITCH_DECR_Get())
     {
         gMCAPPData.switchDecrCount++;
-        if (gMCAPPData.switchDecrCount >= 0xFFU)            
+        if (gMCAPPData.switchDecrCount >= SWITCH_DEBOUNCE_TICKS)            
         {
            gMCAPPData.switchDecrCount = 0U;
            gMCAPPData.switchDecrState = MC_APP_SWITCH_PRESSED;
@@ -953,9 +1599,11 @@ static void MCAPP_SwitchDecrDebounce(void)
         {
             gMCAPPData.switchDecrCount = 0U;
             gMCAPPData.switchDecrState = MC_APP_SWITCH_RELEASED;
-            MCAPP_SpeedDecrease();
-            motor_activity_count = 0U;
-            LED3_Clear();
+#if(POSITION_MODE == true)
+            MCAPP_SetpointPost(0, -(int32_t)(POSITION_STEP_REV * ENCODER_PULSES_PER_REV));
+#else
+            MCAPP_SetpointPost(-1, 0);
+#endif
         }
     }
 }
@@ -971,7 +1619,7 @@ static void MCAPP_SwitchResetDebounce(void)
     if (!(bool)SWITCH_RESET_Get())
     {
         gMCAPPData.switchResetCount++;
-        if (gMCAPPData.switchResetCount >= 0xFFU)            
+        if (gMCAPPData.switchResetCount >= SWITCH_DEBOUNCE_TICKS)            
         {
            gMCAPPData.switchResetCount = 0U;
            gMCAPPData.switchResetState = MC_APP_SWITCH_PRESSED;
@@ -1001,7 +1649,7 @@ static void MCAPP_SwitchDirectionDebounce(void)
     if (!(bool)SWITCH_DIRECTION_Get())
     {
         gMCAPPData.switchDirectionCount++;
-        if (gMCAPPData.switchDirectionCount >= 0xFFU)            
+        if (gMCAPPData.switchDirectionCount >= SWITCH_DEBOUNCE_TICKS)            
         {
            gMCAPPData.switchDirectionCount = 0U;
            gMCAPPData.switchDirectionState = MC_APP_SWITCH_PRESSED;
@@ -1033,18 +1681,176 @@ static void MCAPP_SwitchDirectionDebounce(void)
 }
 
 /******************************************************************************/
-/* Function name: MCAPP_Tasks                                                  */
+/* Function name: MCAPP_SetpointPost                                          */
+/* Function parameters: speedSteps - speed target steps, + increase,          */
+/*                      positionStep - position target change, encoder counts */
+/* Function return: None                                                      */
+/* Description: Hands setpoint changes of the background tasks over to the    */
+/*              slow control loop, with the button activity. The request is   */
+/*              withdrawn while it is written: the slow loop interrupt never  */
+/*              sees it half updated.                                         */
+/******************************************************************************/
+static void MCAPP_SetpointPost(int32_t speedSteps, int32_t positionStep)
+{
+    gSetpointPending = false;
+    __DMB();
+    gSetpointRequest.speedSteps += speedSteps;
+    gSetpointRequest.positionStep = (int32_t)((uint32_t)gSetpointRequest.positionStep + (uint32_t)positionStep);
+    gSetpointRequest.activity = true;
+
+    /* Request must be complete before it is handed over to the slow loop */
+    __DMB();
+    gSetpointPending = true;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_SetpointApply                                         */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Takes the pending setpoint requests, at the start of a slow   */
+/*              loop period: the speed and position targets and the           */
+/*              inactivity count only change in the slow loop.                */
+/******************************************************************************/
+static void MCAPP_SetpointApply(void)
+{
+    if(gSetpointPending == true)
+    {
+        while(gSetpointRequest.speedSteps > 0)
+        {
+            MCAPP_SpeedIncrease();
+            gSetpointRequest.speedSteps--;
+        }
+        while(gSetpointRequest.speedSteps < 0)
+        {
+            MCAPP_SpeedDecrease();
+            gSetpointRequest.speedSteps++;
+        }
+#if(POSITION_MODE == true)
+        MCAPP_PositionTargetStep(gSetpointRequest.positionStep);
+#endif
+        gSetpointRequest.positionStep = 0;
+        if(gSetpointRequest.activity == true)
+        {
+            motor_activity_count = 0U;
+            gSetpointRequest.activity = false;
+        }
+        gSetpointPending = false;
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_MediumLoopTasks                                       */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Medium rate task, every MEDIUM_LOOP_TIME_SEC: speed loop with */
+/*              SPEED_LOOP_RATE_MEDIUM.                                       */
+/******************************************************************************/
+static void MCAPP_MediumLoopTasks(void)
+{
+#if(SPEED_LOOP_RATE == SPEED_LOOP_RATE_MEDIUM)
+    if((gMCAPPData.mcState == MC_APP_STATE_RUNNING) || (gMCAPPData.mcState == MC_APP_STATE_STOP_DECREASE))
+    {
+        MCAPP_SpeedControlLoop();
+    }
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_SlowLoopTasks                                         */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Slow rate task, every SLOW_LOOP_TIME_SEC: setpoint requests,  */
+/*              speed loop with SPEED_LOOP_RATE_SLOW and the ramp down of     */
+/*              MC_APP_STATE_STOP_DECREASE. The state changes stay in         */
+/*              MCAPP_Tasks.                                                  */
+/******************************************************************************/
+static void MCAPP_SlowLoopTasks(void)
+{
+    MCAPP_SetpointApply();
+
+    if((gMCAPPData.mcState == MC_APP_STATE_RUNNING) || (gMCAPPData.mcState == MC_APP_STATE_STOP_DECREASE))
+    {
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+        MCAPP_ResolverAmplitudeUpdate();
+#endif
+#if(SPEED_LOOP_RATE == SPEED_LOOP_RATE_SLOW)
+        MCAPP_SpeedControlLoop();
+#endif
+    }
+
+    if(gMCAPPData.mcState == MC_APP_STATE_RUNNING)
+    {
+        motor_activity_count++;
+    }
+    else if(gMCAPPData.mcState == MC_APP_STATE_STOP_DECREASE)
+    {
+        if((speed_elec_rad_per_sec*(float)gCtrlParam.direction) <= (motor_speed_target_elec_rad_per_sec + 10.0f))
+        {
+            MCAPP_SpeedDecrease();
+        }
+    }
+    else
+    {
+        /* Stopped: the next start counts from zero */
+        motor_activity_count = 0U;
+    }
+
+    /* State machine checks on the new speed and activity count */
+    MCAPP_EventPost(MCAPP_EVENT_SLOW);
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_CycleCounterInit                                      */
 /* Function parameters: None                                                  */
 /* Function return: None                                                      */
-/* Description: Motor application state machine                               */
+/* Description: Starts the DWT cycle counter, the time base of the execution  */
+/*              times, the load meter and the flying start. Called once at    */
+/*              init, the counter is never reset: users take differences.     */
+/******************************************************************************/
+static void MCAPP_CycleCounterInit(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->LAR = 0xC5ACCE55U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_Tasks                                                  */
+/* Function parameters: events - MCAPP_EVENT_x bits of MCAPP_EventWait        */
+/* Function return: None                                                      */
+/* Description: Motor application state machine. Runs on any event, the     */
+/*              switches only on the background tick: the debounce time does  */
+/*              not depend on how often the other events come.                */
 /******************************************************************************/
-void MCAPP_Tasks(void)
+void MCAPP_Tasks(uint32_t events)
 {
+  bool tick = ((events & MCAPP_EVENT_TICK) != 0U);
+  uint32_t activityCount;
+
+#if(ENABLE_RATE_INTERRUPTS == false)
+  MCAPP_SchedulerPoll();
+#endif
+  if(tick == true)
+  {
+      MCAPP_LoadMeterUpdate();
+  }
+
   switch (gMCAPPData.mcState)
   {
       case MC_APP_STATE_INIT:
                       /* Set field alignment flag */
             gCtrlParam.fieldAlignmentFlag = 1U;
+          /* DWT time base of the benchmark, the scheduler and the load meter */
+          MCAPP_CycleCounterInit();
+#if(SINCOS_BENCHMARK == true)
+          /* Measure sine/cosine before the control interrupts are enabled */
+          MCLIB_SinCosBenchmark(&gSinCosBenchmark);
+#endif
+#if(Q31_BENCHMARK == true)
+          /* Both current loops run with the PI gains of the motor */
+          MCAPP_MotorPIParamInit();
+          MCLIB_Q31Benchmark(&gPIParmD, Q31_CURRENT_BASE, &gQ31Benchmark);
+#endif
           //Disable peripheral control of the PWM low pins : PA4, PA5, PA6
           PIOA_REGS->PIO_MSKR = 0x70U;
           PIOA_REGS->PIO_CFGR = 0x0U;
@@ -1052,7 +1858,9 @@ void MCAPP_Tasks(void)
           /* Start TC0 to trigger periodic PWM duty update */
           NVIC_DisableIRQ(TC0_CH0_IRQn);
           NVIC_ClearPendingIRQ(TC0_CH0_IRQn);
-          NVIC_SetPriority(TC0_CH0_IRQn, 1U);
+          /* Fast loop and rate task priorities from the scheduler table */
+          MCAPP_SchedulerInit(gRateConfig);
+          MCAPP_BackgroundInit();
           NVIC_EnableIRQ(TC0_CH0_IRQn);
           TC0_CH0_CompareCallbackRegister(MCAPP_ControlLoopISR, (uintptr_t)dummyforMisra);
           TC0_REGS->TC_CHANNEL[0].TC_EMR |= TC_EMR_TRIGSRCB(TC_EMR_TRIGSRCB_PWMx_Val);
@@ -1068,53 +1876,114 @@ void MCAPP_Tasks(void)
           NVIC_EnableIRQ(TC1_CH0_IRQn);
           TC3_REGS->TC_CHANNEL[0].TC_CMR |= TC_CMR_BURST_XC0;
           TC3_REGS->TC_CHANNEL[1].TC_CMR |= TC_CMR_BURST_XC1;
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+          MCAPP_ResolverInitialize();
+#endif
+#if(ENCODER_REVERSED == true)
+          TC1_REGS->TC_BMR |= TC_BMR_SWAP_Msk;
+#endif
+#if((ENABLE_ENCODER_CALIBRATION == true) && (ENABLE_INDEX_ALIGNMENT == true))
+          if(gIndexAlign.offset != ENCODER_INDEX_OFFSET_UNKNOWN)
+          {
+              /* Commissioned: offset and direction from "userparams.h" */
+              gEncoderCalib.step = ENCODER_CALIB_DONE;
+          }
+#endif
 
-          gMCAPPData.switchStartCount = 0xFF;
+          gMCAPPData.switchStartCount = SWITCH_DEBOUNCE_TICKS;
           gMCAPPData.mcDirection = MC_APP_DIRECTION_FORWARD;
           gCtrlParam.direction = 1;
+#if((TORQUE_MODE == false) && (POSITION_MODE == false))
+          MCAPP_SpeedRampInit();
+#endif
+#if(ENABLE_OFFSET_TRACKING == true)
+          /* Offsets measured once, then tracked while stopped */
+          MCAPP_OffsetCalibStart(MC_APP_STATE_WAIT_START);
+#else
           gMCAPPData.mcState = MC_APP_STATE_WAIT_START;
+#endif
+          break;
+
+      case MC_APP_STATE_OFFSET_CALIBRATION:
+          if(MCAPP_OffsetCalibUpdate(sinc3_out_sample_count, gCurrentU.sinc3_out, gCurrentV.sinc3_out) == true)
+          {
+              MCAPP_OffsetApply();
+              gMCAPPData.mcState = offsetCalibNextState;
+          }
+          else
+          {
+              /* No Operation*/
+          }
           break;
           
       case MC_APP_STATE_WAIT_START:
-          MCAPP_SwitchStartDebounce(MC_APP_STATE_START);  
-          MCAPP_SwitchDirectionDebounce();
+#if(ENABLE_FLYING_START == true)
+          if(gCtrlParam.fieldAlignmentFlag == 0U)
+          {
+              /* Fast loop stopped, the encoder still counts */
+              MCAPP_EncoderTrack();
+              MCAPP_FlyingStartMeasure(gPositionCalc.position);
+          }
+#endif
+#if(ENABLE_OFFSET_TRACKING == true)
+          MCAPP_OffsetTrack();
+#endif
+          if(tick == true)
+          {
+              MCAPP_SwitchStartDebounce(MC_APP_STATE_START);
+              MCAPP_SwitchDirectionDebounce();
+          }
           break;
 
       case MC_APP_STATE_START:
-          LED0_Set();
-          MCAPP_LedDirectionUpdate(true);
-          MCAPP_MotorStart();
-          motor_activity_count = 0U;
-          LED3_Clear();
+          if(gOffsetCalib.done == false)
+          {
+              /* Offsets first, back here once measured */
+              MCAPP_OffsetCalibStart(MC_APP_STATE_START);
+          }
+          else
+          {
+              LED0_Set();
+              MCAPP_LedDirectionUpdate(true);
+              MCAPP_MotorStart();
+              LED3_Clear();
 
-          gMCAPPData.mcState = MC_APP_STATE_RUNNING;  
+              gMCAPPData.mcState = MC_APP_STATE_RUNNING;
+          }
           break;
 
       case MC_APP_STATE_RUNNING:
-          if(MCAPP_SlowLoopTimeIsFinished())
-          {
-            MCAPP_SlowControlLoop();
-            motor_activity_count++;
-          }
-
-          if (motor_activity_count > ( 5U * MOTOR_ACTIVITY_SLOW_LOOP_COUNT_60_SEC) ) // 5 minutes
+          /* Written by the slow loop: one read for both limits */
+          activityCount = motor_activity_count;
+          if (activityCount > ( 5U * MOTOR_ACTIVITY_SLOW_LOOP_COUNT_60_SEC) ) // 5 minutes
           {
               gMCAPPData.mcState = MC_APP_STATE_STOP_DECREASE;
           }
-          else if (motor_activity_count > ( 4U * MOTOR_ACTIVITY_SLOW_LOOP_COUNT_60_SEC) ) // > 4 minutes
+          else if (activityCount > ( 4U * MOTOR_ACTIVITY_SLOW_LOOP_COUNT_60_SEC) ) // > 4 minutes
           {
               LED3_Set();
           }
           else{
-              /* Dummy branch for MISRAC compliance*/
+              /* Button activity restarted the count in the slow loop */
+              LED3_Clear();
           }
 
-          MCAPP_SwitchStartDebounce(MC_APP_STATE_STOP_DECREASE);
-          
-          // Check buttons
-          MCAPP_SwitchDecrDebounce();
-          MCAPP_SwitchIncrDebounce();
-          MCAPP_SwitchResetDebounce();
+          if(tick == true)
+          {
+              MCAPP_SwitchStartDebounce(MC_APP_STATE_STOP_DECREASE);
+
+              // Check buttons
+              MCAPP_SwitchDecrDebounce();
+              MCAPP_SwitchIncrDebounce();
+              MCAPP_SwitchResetDebounce();
+          }
+#if(ENABLE_ENCODER_CALIBRATION == true)
+          if(gEncoderCalib.step == ENCODER_CALIB_FAILED)
+          {
+              /* Rotor did not follow or wrong pole pairs: the next start calibrates again */
+              gMCAPPData.mcState = MC_APP_STATE_STOP;
+          }
+#endif
          break;
 
         case MC_APP_STATE_STOP_DECREASE:
@@ -1126,15 +1995,7 @@ void MCAPP_Tasks(void)
             }
             else
             {
-                if(MCAPP_SlowLoopTimeIsFinished())
-                {
-                    MCAPP_SlowControlLoop();
-                  
-                    if((speed_elec_rad_per_sec*(float)gCtrlParam.direction) <= (motor_speed_target_elec_rad_per_sec + 10.0f))
-                    {
-                       MCAPP_SpeedDecrease();
-                    }
-                }
+                /* Speed ramps down in the slow rate task */
             }
         break;
 
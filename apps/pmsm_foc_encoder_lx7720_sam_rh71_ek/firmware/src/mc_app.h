@@ -62,6 +62,25 @@
 // *****************************************************************************
 #include "userparams.h"
 #include "mclib_generic_float.h"
+#include "mclib_generic_q31.h"
+#include "mc_motor_profile.h"
+#include "mc_angle_pll.h"
+#include "mc_background.h"
+#include "mc_bemf_observer.h"
+#include "mc_current_sense.h"
+#include "mc_encoder.h"
+#include "mc_encoder_calib.h"
+#include "mc_flying_start.h"
+#include "mc_gain_sched.h"
+#include "mc_index_align.h"
+#include "mc_ipd.h"
+#include "mc_lock_settle.h"
+#include "mc_offset_calib.h"
+#include "mc_resolver.h"
+#include "mc_scheduler.h"
+#include "mc_speed_mt.h"
+#include "mc_speed_ramp.h"
+#include "mc_trajectory.h"
 
 /*  This section lists the other files that are included in this file.
 */
@@ -90,18 +109,8 @@ extern "C" {
 #define ONE_BY_SQRT3    ((float)(0.5773502691))
 #define TWO_BY_SQRT3    ((float)(1.1547005384))
 
-/* Rated Electric speed(rad/s) = (2 * pi * RATED_SPEED_RPM / 60) * (Pole Pairs) */
-#define DECIMATE_RATED_SPEED      ((RATED_SPEED_RPM *((float)M_PI/30)) * NUM_POLE_PAIRS/10)
 #define SQRT3                     ((float)1.732)
 #define ANGLE_OFFSET_MIN          ((float)(M_PI_2)/(float)(32767))
-    
-//#define TOTAL_SINE_TABLE_ANGLE      (2*(float)M_PI)
-//#define ANGLE_STEP                  (TOTAL_SINE_TABLE_ANGLE/(float)TABLE_SIZE)
-//#define TABLE_SIZE  256
-
-/* Motor phase current offset calibration limits. */
-#define CURRENT_OFFSET_MAX                (12700U) /* current offset max limit in terms of ADC count*/
-#define CURRENT_OFFSET_MIN                (12300U) /* current offset min limit in terms of ADC count*/
 
 
 typedef enum 
@@ -114,6 +123,7 @@ typedef enum
     MC_APP_STATE_STOP,
     MC_APP_STATE_STOP_DECREASE,
     MC_APP_STATE_STOP_WAIT_ACQ,
+    MC_APP_STATE_OFFSET_CALIBRATION,    /* Current sense offsets measured, one sinc3 sample per pass */
 }MC_APP_STATE;
 
 /* Switch state enum
@@ -178,11 +188,9 @@ typedef struct
 	float    idRefFF;       /* Id reference value from feed forward */
     float    iqRef;         /* Vq torque reference value */
 	float	 endSpeed;      /* End speed reference value for ramp */
-	float    rampIncStep;   /* Speed increment per slow loop execution */
     float    startup_angle_ramp_rads_per_sec;  /* ramp angle variable for initial ramp */
     uint32_t startup_lock_count; /* lock variable for initial ramp */
     uint32_t open_loop_stab_counter;
-    uint32_t sync_cnt;   /* counter in main loop (5ms) synchronization function */
 	tMotorStatus motorStatus;   /* Motor status, STOPPED - 0, RUNNING -1 */
     tMotorStatus oldStatus;
 	bool         openLoop;      /* Indicated motor running in open loop; */
@@ -208,35 +216,41 @@ typedef struct
 {
   volatile uint16_t elec_rotation_count;
   float rotor_angle_rad_per_sec;
-  int16_t prev_position_count;
-  int16_t present_position_count;
+  uint16_t prev_position_count;
+  uint16_t present_position_count;
   uint16_t QDECcnt;
   uint16_t QDECcntZ;
-  uint16_t posCnt;
-  uint16_t posCompensation;
-  uint32_t posCntTmp;
+  uint32_t posCnt;      /* Mechanical count, 0 to ENCODER_PULSES_PER_REV - 1 */
+  int32_t position;     /* Multi-turn count since alignment, wraps modulo 2^32 */
+  uint32_t angleQ32;    /* Electrical angle, 2^32 = 2*PI */
   
 }MCAPP_POSITION_CALC;
 
-typedef struct 
+/* Setpoint requests
+
+  Summary:
+    Setpoint changes of the background tasks, for the slow control loop
+
+  Description:
+    The buttons add their steps to the requests; the slow control loop
+    takes them at the start of its period, so the speed and position
+    targets only ever change inside the slow loop, and so does the
+    inactivity count which each button press restarts. The background
+    tasks clear the pending flag while they write, the slow loop cannot
+    take a half written request.
+
+  Remarks:
+    With ENABLE_RATE_INTERRUPTS the slow loop preempts the background
+    tasks, never the opposite.
+*/
+typedef struct
 {
-    volatile uint32_t sinc1_prevq;
-    volatile uint32_t sinc1_out;
-    volatile uint32_t s1_out_pp;
-    volatile uint32_t s1_out_p;
-    volatile uint32_t intg3;
-    volatile uint32_t intg2;
-    volatile uint32_t intg1;
-    volatile uint32_t der3;
-    volatile uint32_t der2;
-    volatile uint32_t der1;
-    volatile uint32_t sinc3_out_ppp;
-    volatile uint32_t sinc3_out_pp;
-    volatile uint32_t sinc3_out_p;
-    volatile uint32_t sinc3_out;
-} MCAPP_SINC3;
-
-void MCAPP_Tasks(void);
+    int32_t speedSteps;     /* Speed target steps, + increase, - decrease */
+    int32_t positionStep;   /* Position target change, encoder counts */
+    bool    activity;       /* Button pressed: restarts the inactivity count */
+} MCAPP_SETPOINT_REQUEST;
+
+void MCAPP_Tasks(uint32_t events);
 void MCAPP_MotorStart(void);
 void MCAPP_MotorStop(void);
 void MCAPP_MotorPIParamInit(void);
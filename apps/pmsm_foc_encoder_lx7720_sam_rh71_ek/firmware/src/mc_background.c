@@ -0,0 +1,247 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_background.c
+
+  Summary:
+    This file contains the background events and the CPU load meter.
+
+  Description:
+    This file contains the event sources of the main loop, its idle sleep
+    and the CPU load meter.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_background.h"
+#include "mc_motor_profile.h"
+#include "CMSIS/Core/Include/core_cm7.h"
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_LOAD_METER gLoadMeter;
+
+/* Events posted by the interrupts, taken by the main loop. The first pass
+   runs MC_APP_STATE_INIT, which starts the event sources */
+static volatile uint32_t gBackgroundEvents = MCAPP_EVENT_TICK;
+
+/******************************************************************************/
+/* Function name: MCAPP_BackgroundInit                                        */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Starts the event sources of the background tasks: the         */
+/*              SysTick tick and the X2Cscope UART interrupt, both at the     */
+/*              lowest priority.                                              */
+/******************************************************************************/
+void MCAPP_BackgroundInit(void)
+{
+    /* Processor clock, lowest priority */
+    (void)SysTick_Config(BACKGROUND_TICK_CYCLES);
+
+    NVIC_DisableIRQ(FLEXCOM1_IRQn);
+    NVIC_ClearPendingIRQ(FLEXCOM1_IRQn);
+    NVIC_SetPriority(FLEXCOM1_IRQn, 7U);
+    NVIC_EnableIRQ(FLEXCOM1_IRQn);
+    MCAPP_UartEventEnable();
+
+    gLoadMeter.ticks = 0U;
+    gLoadMeter.idleCycles = 0U;
+    gLoadMeter.passCycles = 0U;
+    gLoadMeter.windowStart = DWT->CYCCNT;
+    gLoadMeter.passStart = gLoadMeter.windowStart;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_EventPost                                             */
+/* Function parameters: event - MCAPP_EVENT_x bits                            */
+/* Function return: None                                                      */
+/* Description: Posts background events, from any interrupt priority. The     */
+/*              exclusive access retries if a higher priority interrupt       */
+/*              posted in between.                                            */
+/******************************************************************************/
+void MCAPP_EventPost(uint32_t event)
+{
+    uint32_t events;
+
+    do
+    {
+        events = __LDREXW(&gBackgroundEvents) | event;
+    } while(__STREXW(events, &gBackgroundEvents) != 0U);
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_EventWait                                             */
+/* Function parameters: None                                                  */
+/* Function return: Posted MCAPP_EVENT_x bits                                 */
+/* Description: Sleeps until an interrupt posts an event. The interrupts are  */
+/*              masked around the check and the WFI: an event posted right    */
+/*              after the check still ends the sleep, and the sleep time is   */
+/*              read before the waking interrupt runs. Times the background   */
+/*              pass from its return to the next call for the load meter.     */
+/******************************************************************************/
+uint32_t MCAPP_EventWait(void)
+{
+    uint32_t events;
+    uint32_t sleep;
+
+    __disable_irq();
+    gLoadMeter.passCycles += DWT->CYCCNT - gLoadMeter.passStart;
+    while(gBackgroundEvents == 0U)
+    {
+        sleep = DWT->CYCCNT;
+#if(ENABLE_IDLE_SLEEP == true)
+        __DSB();
+        __WFI();
+#endif
+        gLoadMeter.idleCycles += DWT->CYCCNT - sleep;
+
+        /* Pending interrupts run here */
+        __enable_irq();
+        __ISB();
+        __disable_irq();
+    }
+    events = gBackgroundEvents;
+    gBackgroundEvents = 0U;
+    gLoadMeter.passStart = DWT->CYCCNT;
+    __enable_irq();
+
+    return events;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_LoadMeterUpdate                                       */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Called every background tick. Closes the load meter window    */
+/*              every LOAD_METER_WINDOW_TICKS: the busy time is the window    */
+/*              less the sleep, split between the background passes and the   */
+/*              interrupts.                                                   */
+/******************************************************************************/
+void MCAPP_LoadMeterUpdate(void)
+{
+    uint32_t now;
+    float window;
+    float outside;
+    float busy;
+    float background;
+    float isrDensity = 0.0f;
+
+    gLoadMeter.ticks++;
+    if(gLoadMeter.ticks >= LOAD_METER_WINDOW_TICKS)
+    {
+        /* Close the running pass at the window end */
+        now = DWT->CYCCNT;
+        gLoadMeter.passCycles += now - gLoadMeter.passStart;
+        gLoadMeter.passStart = now;
+
+        window = (float)(now - gLoadMeter.windowStart);
+        background = (float)gLoadMeter.passCycles;
+        outside = window - background;
+        busy = window - (float)gLoadMeter.idleCycles;
+
+        /* Outside the passes the CPU sleeps or runs interrupts: their share
+           of that time is taken for the interrupts preempting the passes */
+        if(outside > 0.0f)
+        {
+            isrDensity = (outside - (float)gLoadMeter.idleCycles) / outside;
+        }
+        background = background * (1.0f - isrDensity);
+
+        gLoadMeter.idle = (100.0f * (float)gLoadMeter.idleCycles) / window;
+        gLoadMeter.background = (100.0f * background) / window;
+        gLoadMeter.isr = (100.0f * (busy - background)) / window;
+        if((100.0f - gLoadMeter.idle) > gLoadMeter.busyMax)
+        {
+            gLoadMeter.busyMax = 100.0f - gLoadMeter.idle;
+        }
+
+        gLoadMeter.windowStart = now;
+        gLoadMeter.ticks = 0U;
+        gLoadMeter.idleCycles = 0U;
+        gLoadMeter.passCycles = 0U;
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_UartEventEnable                                       */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Called after X2Cscope_Communicate. Wakes the background on    */
+/*              the next received byte and, while X2Cscope sends, once the    */
+/*              byte on the line is out.                                      */
+/******************************************************************************/
+void MCAPP_UartEventEnable(void)
+{
+    uint32_t enable = FLEX_US_IER_RXRDY_Msk;
+
+    if((FLEXCOM1_REGS->FLEX_US_CSR & FLEX_US_CSR_TXEMPTY_Msk) == 0U)
+    {
+        enable |= FLEX_US_IER_TXEMPTY_Msk;
+    }
+    FLEXCOM1_REGS->FLEX_US_IER = enable;
+}
+
+/******************************************************************************/
+/* Function name: FLEXCOM1_InterruptHandler                                   */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: X2Cscope UART interrupt. Leaves the data to X2Cscope in the   */
+/*              background: masks the interrupt until the background ran.     */
+/*              Replaces the weak handler of interrupts.c.                    */
+/******************************************************************************/
+void FLEXCOM1_InterruptHandler(void)
+{
+    FLEXCOM1_REGS->FLEX_US_IDR = FLEX_US_IDR_RXRDY_Msk | FLEX_US_IDR_TXEMPTY_Msk;
+    MCAPP_EventPost(MCAPP_EVENT_UART);
+}
+
+/******************************************************************************/
+/* Function name: SysTick_Handler                                             */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Background tick, every BACKGROUND_TICK_MS. Replaces the       */
+/*              weak handler of interrupts.c.                                 */
+/******************************************************************************/
+void SysTick_Handler(void)
+{
+    MCAPP_EventPost(MCAPP_EVENT_TICK);
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,141 @@
+/*******************************************************************************
+ Background events interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_background.h
+
+  Summary:
+    Events, idle sleep and CPU load of the main loop
+
+  Description:
+    This file contains the data structure and function prototypes of the
+    background events. The interrupts post events, the main loop sleeps
+    until one comes, and the load meter measures the spare CPU time.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_BACKGROUND_H    // Guards against multiple inclusion
+#define MC_BACKGROUND_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include "userparams.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Background events, posted by the interrupts to the main loop */
+#define MCAPP_EVENT_TICK                  (0x01U)     /* SysTick, every BACKGROUND_TICK_MS */
+#define MCAPP_EVENT_RATE                  (0x02U)     /* Rate task released, ENABLE_RATE_INTERRUPTS disabled */
+#define MCAPP_EVENT_SLOW                  (0x04U)     /* Slow rate task done: state machine checks */
+#define MCAPP_EVENT_SENSE                 (0x08U)     /* Current sense sample for the offset measurement */
+#define MCAPP_EVENT_UART                  (0x10U)     /* X2Cscope UART received a byte or sent one */
+
+/* CPU load meter
+
+  Summary:
+    Share of the CPU time of the interrupts, the background and sleep
+
+  Description:
+    The main loop sleeps in MCAPP_EventWait with the interrupts masked, so
+    the sleep time is counted up to the wakeup, before any interrupt runs.
+    The rest of the window is busy: nothing is added to the interrupts.
+    MCAPP_EventWait also times the background passes, interrupts that
+    preempt them included. Outside the passes the CPU only sleeps or runs
+    interrupts, the interrupt share of that time is taken off the passes.
+    Shares are percent of the last LOAD_METER_WINDOW_MS.
+
+  Remarks:
+    Idle and busy are exact. The interrupt and background split is an
+    estimate: it assumes the interrupts load the passes as much as the
+    rest of the window. With ENABLE_IDLE_SLEEP disabled, idle is the time
+    spent polling for events.
+*/
+typedef struct
+{
+    float             isr;          /* Interrupt share, percent */
+    float             background;   /* Background task share, percent */
+    float             idle;         /* Sleep share: the headroom, percent */
+    float             busyMax;      /* Highest interrupt + background share of a window, percent */
+    uint32_t          ticks;        /* Background ticks into the window */
+    uint32_t          windowStart;  /* DWT count at the window start */
+    uint32_t          idleCycles;   /* Cycles asleep in the window */
+    uint32_t          passCycles;   /* Cycles in background passes in the window */
+    uint32_t          passStart;    /* DWT count at the start of the running pass */
+} MCAPP_LOAD_METER;
+
+/* CPU load, read through X2Cscope */
+extern MCAPP_LOAD_METER gLoadMeter;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_BackgroundInit(void);
+void MCAPP_EventPost(uint32_t event);
+uint32_t MCAPP_EventWait(void);
+void MCAPP_LoadMeterUpdate(void);
+void MCAPP_UartEventEnable(void);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_BACKGROUND_H
+
+/**
+ End of File
+*/
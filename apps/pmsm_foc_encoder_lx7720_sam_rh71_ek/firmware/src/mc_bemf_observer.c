@@ -0,0 +1,243 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_bemf_observer.c
+
+  Summary:
+    This file contains the back EMF observer.
+
+  Description:
+    This file contains the back EMF observer: rotor angle and speed
+    estimated from the phase voltages and currents, and the encoder
+    cross-check.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_bemf_observer.h"
+#include "mc_motor_profile.h"
+#include "CMSIS/Core/Include/core_cm7.h"
+#include "math.h"
+
+#if(BEMF_OBSERVER_MODE != BEMF_OBSERVER_OFF)
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_BEMF_OBSERVER gBemfObserver;
+
+/******************************************************************************/
+/* Function name: MCAPP_BemfObserverReset                                     */
+/* Function parameters: current - present alpha/beta currents (A)             */
+/*                      angle - present encoder angle (rad)                   */
+/* Function return: None                                                      */
+/* Description: Starts the back EMF observer at standstill on the encoder     */
+/*              angle, clears the encoder fault and the cycle count.          */
+/******************************************************************************/
+void MCAPP_BemfObserverReset(const MCLIB_I_ALPHA_BETA *current, float angle)
+{
+    gBemfObserver.iAlpha = current->iAlpha;
+    gBemfObserver.iBeta = current->iBeta;
+    gBemfObserver.esd = 0.0f;
+    gBemfObserver.esq = 0.0f;
+    gBemfObserver.omega = 0.0f;
+    gBemfObserver.speed = 0.0f;
+    gBemfObserver.rho = angle;
+    gBemfObserver.angle = angle;
+    gBemfObserver.error = 0.0f;
+    gBemfObserver.faultCount = 0U;
+    gBemfObserver.cycles = 0U;
+    gBemfObserver.cyclesMax = 0U;
+    gBemfObserver.valid = false;
+    gBemfObserver.encoderFault = false;
+    gBemfObserver.inUse = false;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_BemfObserverUpdate                                    */
+/* Function parameters: voltage - alpha/beta voltages of the last period      */
+/*                      current - present alpha/beta currents (A)             */
+/*                      encoderAngle - encoder electrical angle (rad)         */
+/* Function return: None                                                      */
+/* Description: Back EMF observer, called every fast loop once the present    */
+/*              currents are known and before the new voltages are computed:  */
+/*              the alpha/beta voltages are those of the last PWM period. The */
+/*              Esd/Esq filter corner follows the speed, so that the loop     */
+/*              stays stable at high speed. The back EMF is the average over  */
+/*              the last period: the integrated angle is half a period ahead  */
+/*              of the sample. The estimate is compared with the encoder      */
+/*              angle, a lasting difference is latched as an encoder fault.   */
+/******************************************************************************/
+void MCAPP_BemfObserverUpdate(const MCLIB_V_ALPHA_BETA *voltage, const MCLIB_I_ALPHA_BETA *current,
+                              float encoderAngle)
+{
+    uint32_t start;
+    float eAlpha;
+    float eBeta;
+    float esd;
+    float esq;
+    float kFilter;
+    float error;
+    MCLIB_POSITION estimate;
+
+    start = DWT->CYCCNT;
+
+    /* Back EMF: phase voltage minus the resistive and inductive drops */
+    eAlpha = (voltage->vAlpha * MOTOR_PHASE_VOLTS_PER_UNIT)
+           - (current->iAlpha * MOTOR_PER_PHASE_RESISTANCE)
+           - ((current->iAlpha - gBemfObserver.iAlpha) * MOTOR_INDUCTANCE_PER_FAST_LOOP);
+    eBeta  = (voltage->vBeta * MOTOR_PHASE_VOLTS_PER_UNIT)
+           - (current->iBeta * MOTOR_PER_PHASE_RESISTANCE)
+           - ((current->iBeta - gBemfObserver.iBeta) * MOTOR_INDUCTANCE_PER_FAST_LOOP);
+    gBemfObserver.iAlpha = current->iAlpha;
+    gBemfObserver.iBeta = current->iBeta;
+
+    /* Back EMF in the frame of the estimated angle */
+    estimate.angle = gBemfObserver.rho;
+    MCLIB_SinCosCalc(&estimate);
+    esd = (eAlpha * estimate.cosAngle) + (eBeta * estimate.sineAngle);
+    esq = (eBeta * estimate.cosAngle) - (eAlpha * estimate.sineAngle);
+
+    kFilter = fmaxf(fabsf(gBemfObserver.speed) * BEMF_OBSERVER_FILTER_PER_SPEED, KFILTER_ESDQ);
+    gBemfObserver.esd += (esd - gBemfObserver.esd) * kFilter;
+    gBemfObserver.esq += (esq - gBemfObserver.esq) * kFilter;
+
+    /* Esd is -Esq * sin(angle error): it speeds up a lagging estimate in either direction */
+    if(gBemfObserver.esq > 0.0f)
+    {
+        gBemfObserver.omega = (gBemfObserver.esq - gBemfObserver.esd) * MOTOR_BEMF_OBSERVER_INV_KE;
+    }
+    else
+    {
+        gBemfObserver.omega = (gBemfObserver.esq + gBemfObserver.esd) * MOTOR_BEMF_OBSERVER_INV_KE;
+    }
+    gBemfObserver.speed += (gBemfObserver.omega - gBemfObserver.speed) * KFILTER_VELESTIM;
+
+    gBemfObserver.rho += gBemfObserver.omega * FAST_LOOP_TIME_SEC;
+    if(gBemfObserver.rho >= (2.0f * PI))
+    {
+        gBemfObserver.rho -= 2.0f * PI;
+    }
+    else if(gBemfObserver.rho < 0.0f)
+    {
+        gBemfObserver.rho += 2.0f * PI;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+
+    /* Angle at the sample: half a period back from the integrated angle */
+    gBemfObserver.angle = gBemfObserver.rho - (gBemfObserver.omega * (0.5f * FAST_LOOP_TIME_SEC));
+    if(gBemfObserver.angle >= (2.0f * PI))
+    {
+        gBemfObserver.angle -= 2.0f * PI;
+    }
+    else if(gBemfObserver.angle < 0.0f)
+    {
+        gBemfObserver.angle += 2.0f * PI;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+
+    /* Cross-check with the encoder, shortest angle error */
+    error = gBemfObserver.angle - encoderAngle;
+    if(error > PI)
+    {
+        error -= 2.0f * PI;
+    }
+    else if(error < -PI)
+    {
+        error += 2.0f * PI;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+    gBemfObserver.error = error;
+
+    gBemfObserver.valid = (fabsf(gBemfObserver.speed) >= MOTOR_BEMF_OBSERVER_MIN_SPEED);
+    if(gBemfObserver.valid == true)
+    {
+        if(fabsf(error) > BEMF_OBSERVER_FAULT_ANGLE)
+        {
+            gBemfObserver.faultCount++;
+            if(gBemfObserver.faultCount >= BEMF_OBSERVER_FAULT_COUNT)
+            {
+                gBemfObserver.encoderFault = true;
+            }
+        }
+        else if(gBemfObserver.faultCount > 0U)
+        {
+            /* Counts down rather than clearing: a stuck encoder sweeps the error through zero */
+            gBemfObserver.faultCount--;
+        }
+        else
+        {
+            /* No Operation*/
+        }
+    }
+    else if(gBemfObserver.encoderFault == false)
+    {
+        /* Low speed: hold the estimate on the encoder for a bumpless handover */
+        gBemfObserver.rho = encoderAngle;
+        gBemfObserver.angle = encoderAngle;
+        gBemfObserver.faultCount = 0U;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+
+#if(BEMF_OBSERVER_MODE == BEMF_OBSERVER_PRIMARY)
+    gBemfObserver.inUse = gBemfObserver.valid;
+#else
+    gBemfObserver.inUse = gBemfObserver.valid && gBemfObserver.encoderFault;
+#endif
+
+    gBemfObserver.cycles = DWT->CYCCNT - start;
+    if(gBemfObserver.cycles > gBemfObserver.cyclesMax)
+    {
+        gBemfObserver.cyclesMax = gBemfObserver.cycles;
+    }
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ Back EMF observer interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_bemf_observer.h
+
+  Summary:
+    Sensorless rotor angle and speed from the back EMF
+
+  Description:
+    This file contains the data structure and function prototypes of the
+    back EMF observer, which checks the encoder or replaces it above its
+    min speed (BEMF_OBSERVER_MODE).
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_BEMF_OBSERVER_H    // Guards against multiple inclusion
+#define MC_BEMF_OBSERVER_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "userparams.h"
+#include "mclib_generic_float.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Back EMF observer
+
+  Summary:
+    Sensorless rotor angle and speed from the back EMF
+
+  Description:
+    The alpha/beta back EMF is what remains of the phase voltage once the
+    resistive and inductive drops of the measured currents are removed. It
+    is turned into the frame of the estimated angle: the speed follows the
+    q-axis back EMF and is corrected by the d-axis back EMF, which is zero
+    when the angle is right. The angle integrates that speed.
+
+  Remarks:
+    Below the min speed the back EMF is lost in the model errors: the angle
+    is held on the encoder and the estimate is not valid.
+*/
+typedef struct
+{
+    float    iAlpha;        /* Alpha current of the previous fast loop (A) */
+    float    iBeta;         /* Beta current of the previous fast loop (A) */
+    float    esd;           /* Filtered d-axis back EMF in the estimated frame (V) */
+    float    esq;           /* Filtered q-axis back EMF in the estimated frame (V) */
+    float    omega;         /* Electrical speed of the PLL (rad/s) */
+    float    speed;         /* Filtered electrical speed (rad/s) */
+    float    rho;           /* Integrated angle (rad), 0 to 2*PI */
+    float    angle;         /* Estimated electrical angle at the sample (rad), 0 to 2*PI */
+    float    error;         /* Estimated angle - encoder angle (rad), -PI to PI */
+    uint32_t faultCount;    /* Fast loops with an error above BEMF_OBSERVER_FAULT_ANGLE, less those below */
+    uint32_t cycles;        /* CPU cycles of the last update */
+    uint32_t cyclesMax;     /* Slowest update since the motor start */
+    bool     valid;         /* Speed above BEMF_OBSERVER_MIN_SPEED_RPM */
+    bool     encoderFault;  /* Encoder disagreed with the observer, latched until the next start */
+    bool     inUse;         /* Observer angle and speed drive the FOC */
+} MCAPP_BEMF_OBSERVER;
+
+#if(BEMF_OBSERVER_MODE != BEMF_OBSERVER_OFF)
+/* Back EMF observer state and cost, read through X2Cscope */
+extern MCAPP_BEMF_OBSERVER gBemfObserver;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_BemfObserverReset(const MCLIB_I_ALPHA_BETA *current, float angle);
+void MCAPP_BemfObserverUpdate(const MCLIB_V_ALPHA_BETA *voltage, const MCLIB_I_ALPHA_BETA *current,
+                              float encoderAngle);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_BEMF_OBSERVER_H
+
+/**
+ End of File
+*/
@@ -0,0 +1,140 @@
+/*******************************************************************************
+ Phase current sense interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_current_sense.h
+
+  Summary:
+    Sigma delta filter outputs and phase current scaling
+
+  Description:
+    This file contains the state of one sigma delta decimation filter and
+    the inline routine which turns its last sinc3 outputs into the offset
+    removed phase current used by the fast control loop.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_CURRENT_SENSE_H    // Guards against multiple inclusion
+#define MC_CURRENT_SENSE_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+/* Phase current in Amps of one sinc3 count, and of the weighted sum of 4 samples (weights add to 10) */
+#define CURRENT_COUNT_TO_AMPS       ((float)(0.000112))
+#define CURRENT_SUM_TO_AMPS         ((float)(CURRENT_COUNT_TO_AMPS / 10.0f))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct 
+{
+    volatile uint32_t sinc1_prevq;
+    volatile uint32_t sinc1_out;
+    volatile uint32_t s1_out_pp;
+    volatile uint32_t s1_out_p;
+    volatile uint32_t intg3;
+    volatile uint32_t intg2;
+    volatile uint32_t intg1;
+    volatile uint32_t der3;
+    volatile uint32_t der2;
+    volatile uint32_t der1;
+    volatile uint32_t sinc3_out_ppp;
+    volatile uint32_t sinc3_out_pp;
+    volatile uint32_t sinc3_out_p;
+    volatile uint32_t sinc3_out;
+} MCAPP_SINC3;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: MCAPP_PhaseCurrentSum                                       */
+/* Function parameters: pCurrent - decimation filter of the phase,            */
+/*                      offset - phase current offset, in tenths of a sinc3   */
+/*                      count                                                 */
+/* Function return: Offset removed phase current, in tenths of sinc3 counts   */
+/* Description: Weighted average on the 4 last sinc3 samples, without the    */
+/*              division by the sum of the weights: integer and exact, the    */
+/*              1/10 is part of the current scale.                            */
+/******************************************************************************/
+static inline int32_t MCAPP_PhaseCurrentSum(volatile MCAPP_SINC3 *pCurrent, uint32_t offset)
+{
+    uint32_t sum;
+
+    sum = (2U * pCurrent->sinc3_out) + (4U * pCurrent->sinc3_out_p)
+        + (3U * pCurrent->sinc3_out_pp) + pCurrent->sinc3_out_ppp;
+
+    return (int32_t)sum - (int32_t)offset;
+}
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_CURRENT_SENSE_H
+
+/**
+ End of File
+*/
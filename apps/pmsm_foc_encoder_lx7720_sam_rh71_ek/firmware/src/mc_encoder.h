@@ -0,0 +1,172 @@
+/*******************************************************************************
+ Quadrature encoder count interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_encoder.h
+
+  Summary:
+    Count arithmetic of the quadrature decoder
+
+  Description:
+    This file contains the inline routines which unwrap the 16 bit QDEC
+    count, wrap the mechanical count over one revolution and update the
+    counts and the electrical angle from a count change. They are shared
+    by the position calculation and the startup features.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_ENCODER_H    // Guards against multiple inclusion
+#define MC_ENCODER_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include "userparams.h"
+#include "mc_motor_profile.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: MCAPP_QDECDelta                                             */
+/* Function parameters: count - present QDEC count, prevCount - QDEC count of */
+/*                      the previous read                                     */
+/* Function return: Signed count change                                       */
+/* Description: Count change between two reads, unwrapped over the counter    */
+/*              modulus. Valid for changes below half the counter range.      */
+/******************************************************************************/
+static inline int32_t MCAPP_QDECDelta(uint16_t count, uint16_t prevCount)
+{
+    int32_t delta;
+
+    delta = (int32_t)count - (int32_t)prevCount;
+    if(delta > QDEC_HALF_MODULUS)
+    {
+        delta -= QDEC_COUNTER_MODULUS;
+    }
+    else if(delta < -QDEC_HALF_MODULUS)
+    {
+        delta += QDEC_COUNTER_MODULUS;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+    return delta;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_EncoderCountWrap                                      */
+/* Function parameters: count - signed mechanical count                       */
+/* Function return: Mechanical count, 0 to ENCODER_PULSES_PER_REV - 1         */
+/* Description: Wraps a count over one mechanical revolution.                 */
+/******************************************************************************/
+static inline uint32_t MCAPP_EncoderCountWrap(int32_t count)
+{
+    int32_t wrapped = count % ENCODER_PULSES_PER_MREV;
+
+    if(wrapped < 0)
+    {
+        wrapped += ENCODER_PULSES_PER_MREV;
+    }
+    return (uint32_t)wrapped;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_EncoderCountUpdate                                    */
+/* Function parameters: countDelta - count change since the last update,     */
+/*                      pPosCnt - mechanical count, pPosition - multi-turn    */
+/*                      count                                                 */
+/* Function return: Binary electrical angle, 2^32 = 2*PI                      */
+/* Description: Moves both counts by the change. A change below one          */
+/*              revolution, as in one fast loop, is wrapped by a single add   */
+/*              or subtract; a larger one falls back to the modulo. The 32    */
+/*              bit angle product wraps once per electrical revolution.       */
+/******************************************************************************/
+static inline uint32_t MCAPP_EncoderCountUpdate(int32_t countDelta, uint32_t *pPosCnt, int32_t *pPosition)
+{
+    int32_t mechCount;
+
+    mechCount = (int32_t)*pPosCnt + countDelta;
+    if(mechCount >= ENCODER_PULSES_PER_MREV)
+    {
+        mechCount -= ENCODER_PULSES_PER_MREV;
+    }
+    else if(mechCount < 0)
+    {
+        mechCount += ENCODER_PULSES_PER_MREV;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+    if((uint32_t)mechCount >= (uint32_t)ENCODER_PULSES_PER_MREV)
+    {
+        mechCount = (int32_t)MCAPP_EncoderCountWrap(mechCount);
+    }
+    *pPosCnt = (uint32_t)mechCount;
+    *pPosition = (int32_t)((uint32_t)*pPosition + (uint32_t)countDelta);
+
+    return *pPosCnt * MOTOR_ENCODER_COUNT_TO_ANGLE_Q32;
+}
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_ENCODER_H
+
+/**
+ End of File
+*/
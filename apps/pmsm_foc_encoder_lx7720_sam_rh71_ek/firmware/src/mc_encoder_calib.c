@@ -0,0 +1,275 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_encoder_calib.c
+
+  Summary:
+    This file contains the encoder calibration.
+
+  Description:
+    This file contains the open loop sweep which measures the encoder
+    offset, direction and the motor pole pairs.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_encoder_calib.h"
+#include "mc_encoder.h"
+#include "mc_motor_profile.h"
+#include "math.h"
+
+#if(ENABLE_ENCODER_CALIBRATION == true)
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+__STATIC_INLINE void MCAPP_EncoderCalibSample(int32_t direction, float *pSin, float *pCos);
+static void MCAPP_EncoderCalibDirection(void);
+static void MCAPP_EncoderCalibFinish(void);
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_ENCODER_CALIB gEncoderCalib;
+
+/******************************************************************************/
+/* Function name: MCAPP_EncoderCalibReset                                     */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Starts the encoder calibration with the rotor alignment.      */
+/******************************************************************************/
+void MCAPP_EncoderCalibReset(void)
+{
+    gEncoderCalib.step = ENCODER_CALIB_ALIGN;
+    gEncoderCalib.ticks = 0U;
+    gEncoderCalib.angleQ32 = 0U;
+    gEncoderCalib.mechCount = 0;
+    gEncoderCalib.prevCount = 0U;
+    gEncoderCalib.indexSeen = false;
+    gEncoderCalib.indexCount = 0;
+    gEncoderCalib.indexOffset = 0U;
+    gEncoderCalib.sinFwd = 0.0f;
+    gEncoderCalib.cosFwd = 0.0f;
+    gEncoderCalib.sinFwdRev = 0.0f;
+    gEncoderCalib.cosFwdRev = 0.0f;
+    gEncoderCalib.sinBack = 0.0f;
+    gEncoderCalib.cosBack = 0.0f;
+    gEncoderCalib.direction = 1;
+    gEncoderCalib.polePairs = 0.0f;
+    gEncoderCalib.offset = 0.0f;
+    gEncoderCalib.lag = 0.0f;
+    gEncoderCalib.startCount = 0U;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_EncoderCalibSample                                    */
+/* Function parameters: direction - 1 or -1, count direction to test,         */
+/*                      pSin, pCos - sums of the sweep                        */
+/* Function return: None                                                      */
+/* Description: Adds the sine and cosine of the forced angle minus the count  */
+/*              angle. Binary angles: the difference wraps by itself.         */
+/******************************************************************************/
+__STATIC_INLINE void MCAPP_EncoderCalibSample(int32_t direction, float *pSin, float *pCos)
+{
+    MCLIB_POSITION difference;
+    uint32_t countAngle;
+
+    countAngle = (uint32_t)(direction * gEncoderCalib.mechCount) * MOTOR_ENCODER_COUNT_TO_ANGLE_Q32;
+    difference.angle = (float)(gEncoderCalib.angleQ32 - countAngle) * MOTOR_ANGLE_Q32_TO_RAD;
+    MCLIB_SinCosCalc(&difference);
+    *pSin += difference.sineAngle;
+    *pCos += difference.cosAngle;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_EncoderCalibDirection                                 */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: End of the forward sweep. The sign of the count is the        */
+/*              direction, its size gives the pole pairs: the forced angle    */
+/*              made NUM_POLE_PAIRS electrical revolutions.                   */
+/******************************************************************************/
+static void MCAPP_EncoderCalibDirection(void)
+{
+    int32_t counts = gEncoderCalib.mechCount;
+
+    if(counts < 0)
+    {
+        gEncoderCalib.direction = -1;
+        gEncoderCalib.sinFwd = gEncoderCalib.sinFwdRev;
+        gEncoderCalib.cosFwd = gEncoderCalib.cosFwdRev;
+        counts = -counts;
+    }
+
+    if(counts > 0)
+    {
+        gEncoderCalib.polePairs = (NUM_POLE_PAIRS * ENCODER_PULSES_PER_REV) / (float)counts;
+    }
+
+    if(fabsf(gEncoderCalib.polePairs - NUM_POLE_PAIRS) > ENCODER_CALIB_POLE_PAIR_TOLERANCE)
+    {
+        /* Rotor did not follow, or pole pairs / encoder pulses are wrong */
+        gEncoderCalib.step = ENCODER_CALIB_FAILED;
+    }
+    else
+    {
+        gEncoderCalib.ticks = 0U;
+        gEncoderCalib.step = ENCODER_CALIB_BACKWARD;
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_EncoderCalibFinish                                    */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: End of the backward sweep. Offset from both sweeps, lag from  */
+/*              their difference. Sets the rotor count, the index offset and  */
+/*              the decoder direction.                                        */
+/******************************************************************************/
+static void MCAPP_EncoderCalibFinish(void)
+{
+    float lag;
+    float offsetCount;
+    int32_t direction = gEncoderCalib.direction;
+
+    gEncoderCalib.offset = atan2f(gEncoderCalib.sinFwd + gEncoderCalib.sinBack,
+                                  gEncoderCalib.cosFwd + gEncoderCalib.cosBack);
+    lag = atan2f(gEncoderCalib.sinFwd, gEncoderCalib.cosFwd) - atan2f(gEncoderCalib.sinBack, gEncoderCalib.cosBack);
+    if(lag > PI)
+    {
+        lag -= 2.0f * PI;
+    }
+    else if(lag < -PI)
+    {
+        lag += 2.0f * PI;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+    gEncoderCalib.lag = 0.5f * lag;
+
+    /* Rotor electrical angle = count angle + offset */
+    offsetCount = roundf(gEncoderCalib.offset * MOTOR_RAD_ELEC_TO_ENCODER_COUNT);
+    gEncoderCalib.startCount = MCAPP_EncoderCountWrap((direction * gEncoderCalib.mechCount) + (int32_t)offsetCount);
+#if(ENABLE_INDEX_ALIGNMENT == true)
+    if(gEncoderCalib.indexSeen == true)
+    {
+        gEncoderCalib.indexOffset = MCAPP_EncoderCountWrap((direction * gEncoderCalib.indexCount) + (int32_t)offsetCount);
+    }
+#endif
+    if(direction < 0)
+    {
+        TC1_REGS->TC_BMR |= TC_BMR_SWAP_Msk;
+    }
+    gEncoderCalib.step = ENCODER_CALIB_DONE;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_EncoderCalibUpdate                                    */
+/* Function parameters: qdecStatus - QDEC status read in this loop            */
+/* Function return: Forced electrical angle (rad)                             */
+/* Description: Encoder calibration, every fast loop of the open loop until   */
+/*              it is done. The caller holds the lock sequence at its start   */
+/*              meanwhile. The d-axis current is set by                       */
+/*              MCAPP_MotorCurrentControl.                                    */
+/******************************************************************************/
+float MCAPP_EncoderCalibUpdate(uint32_t qdecStatus)
+{
+    uint16_t count;
+
+    if((gEncoderCalib.step == ENCODER_CALIB_FORWARD) || (gEncoderCalib.step == ENCODER_CALIB_BACKWARD))
+    {
+        count = (uint16_t)((TC1_REGS->TC_CHANNEL[0].TC_CV) & 0xFFFFu);
+        gEncoderCalib.mechCount += MCAPP_QDECDelta(count, gEncoderCalib.prevCount);
+        gEncoderCalib.prevCount = count;
+#if(ENABLE_INDEX_ALIGNMENT == true)
+        if(((qdecStatus & TC_QUADRATURE_INDEX) != 0U) && (gEncoderCalib.indexSeen == false))
+        {
+            gEncoderCalib.indexSeen = true;
+            gEncoderCalib.indexCount = gEncoderCalib.mechCount;
+        }
+#endif
+        gEncoderCalib.ticks++;
+    }
+
+    switch(gEncoderCalib.step)
+    {
+        case ENCODER_CALIB_ALIGN:
+            gEncoderCalib.ticks++;
+            if(gEncoderCalib.ticks >= ENCODER_CALIB_ALIGN_TICKS)
+            {
+                /* Count from the aligned rotor, in the wired direction */
+                TC1_REGS->TC_BMR &= ~TC_BMR_SWAP_Msk;
+                TC1_QuadratureStart();
+                gEncoderCalib.prevCount = 0U;
+                gEncoderCalib.ticks = 0U;
+                gEncoderCalib.step = ENCODER_CALIB_FORWARD;
+            }
+            break;
+
+        case ENCODER_CALIB_FORWARD:
+            MCAPP_EncoderCalibSample(1, &gEncoderCalib.sinFwd, &gEncoderCalib.cosFwd);
+            MCAPP_EncoderCalibSample(-1, &gEncoderCalib.sinFwdRev, &gEncoderCalib.cosFwdRev);
+            gEncoderCalib.angleQ32 += MOTOR_ENCODER_CALIB_STEP_Q32;
+            if(gEncoderCalib.ticks >= ENCODER_CALIB_SWEEP_TICKS)
+            {
+                MCAPP_EncoderCalibDirection();
+            }
+            break;
+
+        case ENCODER_CALIB_BACKWARD:
+            MCAPP_EncoderCalibSample(gEncoderCalib.direction, &gEncoderCalib.sinBack, &gEncoderCalib.cosBack);
+            gEncoderCalib.angleQ32 -= MOTOR_ENCODER_CALIB_STEP_Q32;
+            if(gEncoderCalib.ticks >= ENCODER_CALIB_SWEEP_TICKS)
+            {
+                /* Back at the forced angle 0 */
+                MCAPP_EncoderCalibFinish();
+            }
+            break;
+
+        default:
+            /* Failed: no current, MCAPP_Tasks stops the motor */
+            break;
+    }
+
+    return (float)gEncoderCalib.angleQ32 * MOTOR_ANGLE_Q32_TO_RAD;
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
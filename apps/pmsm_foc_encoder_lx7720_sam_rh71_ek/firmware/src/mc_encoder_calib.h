@@ -0,0 +1,151 @@
+/*******************************************************************************
+ Encoder calibration interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_encoder_calib.h
+
+  Summary:
+    Encoder offset, direction and pole pair check
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    encoder calibration, which sweeps the rotor open loop at the first
+    start and fits the encoder to the electrical angle.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_ENCODER_CALIB_H    // Guards against multiple inclusion
+#define MC_ENCODER_CALIB_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "userparams.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Encoder calibration steps */
+typedef enum
+{
+    ENCODER_CALIB_NONE = 0U,    /* Not calibrated, runs at the next start */
+    ENCODER_CALIB_ALIGN,        /* Rotor pulled onto electrical angle 0 */
+    ENCODER_CALIB_FORWARD,      /* Forced angle forward, one mechanical revolution */
+    ENCODER_CALIB_BACKWARD,     /* Forced angle back to the start */
+    ENCODER_CALIB_DONE,         /* Offset and direction known */
+    ENCODER_CALIB_FAILED        /* Rotor did not follow, or wrong pole pairs: motor stopped */
+} MCAPP_ENCODER_CALIB_STEP;
+
+/* Encoder calibration
+
+  Summary:
+    Encoder offset, direction and pole pair check from an open loop sweep
+
+  Description:
+    The d-axis current pulls the rotor along a forced angle, one mechanical
+    revolution forward and one back. The pole pairs follow from the counts
+    of the forward sweep, the direction from their sign. The offset is the
+    mean difference of the forced angle and the count angle: the rotor lags
+    the forced angle by the same amount in both sweeps, the mean drops it.
+
+  Remarks:
+    The mean is taken on sine and cosine, free of the angle wrap. The
+    forward sweep sums both count directions, the count decides at its end.
+*/
+typedef struct
+{
+    MCAPP_ENCODER_CALIB_STEP step;
+    uint32_t ticks;             /* Fast loops in the present step */
+    uint32_t angleQ32;          /* Forced electrical angle, 2^32 = 2*PI */
+    int32_t  mechCount;         /* Encoder count since the end of the alignment */
+    uint16_t prevCount;         /* QDEC count of the previous fast loop */
+    bool     indexSeen;         /* Index pulse passed during the forward sweep */
+    int32_t  indexCount;        /* mechCount at the index pulse */
+    uint32_t indexOffset;       /* Mechanical count of the index from the fit, with indexSeen */
+    float    sinFwd;            /* Sums of the angle difference, forward sweep */
+    float    cosFwd;
+    float    sinFwdRev;         /* Same, for a reversed encoder */
+    float    cosFwdRev;
+    float    sinBack;           /* Sums of the angle difference, backward sweep */
+    float    cosBack;
+    int32_t  direction;         /* 1 - count rises with the electrical angle, -1 - reversed */
+    float    polePairs;         /* Measured pole pairs */
+    float    offset;            /* Electrical angle at count 0 (rad) */
+    float    lag;               /* Rotor lag behind the forced angle (rad): friction and load */
+    uint32_t startCount;        /* Mechanical count of the rotor at the switch to closed loop */
+} MCAPP_ENCODER_CALIB;
+
+#if(ENABLE_ENCODER_CALIBRATION == true)
+/* Encoder calibration results, read through X2Cscope */
+extern MCAPP_ENCODER_CALIB gEncoderCalib;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_EncoderCalibReset(void);
+float MCAPP_EncoderCalibUpdate(uint32_t qdecStatus);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_ENCODER_CALIB_H
+
+/**
+ End of File
+*/
@@ -0,0 +1,128 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_flying_start.c
+
+  Summary:
+    This file contains the flying start speed measurement.
+
+  Description:
+    This file contains the speed windows measured on the encoder while the
+    motor is stopped, and the start speed of a restart.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_flying_start.h"
+#include "mc_motor_profile.h"
+#include "CMSIS/Core/Include/core_cm7.h"
+#include "math.h"
+
+#if(ENABLE_FLYING_START == true)
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_FLYING_START gFlyingStart;
+
+/******************************************************************************/
+/* Function name: MCAPP_FlyingStartReset                                      */
+/* Function parameters: speed - speed of the speed loop, electrical rad/s,    */
+/*                      position - present multi-turn count                   */
+/* Function return: None                                                      */
+/* Description: Opens the first speed window at the motor stop. The speed of  */
+/*              the speed loop holds until the window closes. The DWT cycle   */
+/*              counter is the time base: the fast loop timer is stopped.     */
+/******************************************************************************/
+void MCAPP_FlyingStartReset(float speed, int32_t position)
+{
+    gFlyingStart.speed = speed;
+    gFlyingStart.windowPosition = position;
+    gFlyingStart.windowCycles = DWT->CYCCNT;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_FlyingStartMeasure                                    */
+/* Function parameters: position - present multi-turn count                   */
+/* Function return: None                                                      */
+/* Description: Background task while stopped, on the tracked count.          */
+/*              Closes the speed window once FLYING_START_WINDOW_MS is over   */
+/*              and opens the next one: the speed is always at most one       */
+/*              window old, a start does not wait for a measurement.          */
+/******************************************************************************/
+void MCAPP_FlyingStartMeasure(int32_t position)
+{
+    uint32_t cycles;
+
+    cycles = DWT->CYCCNT - gFlyingStart.windowCycles;
+    if(cycles >= FLYING_START_WINDOW_CYCLES)
+    {
+        gFlyingStart.windowCount = (int32_t)((uint32_t)position - (uint32_t)gFlyingStart.windowPosition);
+        gFlyingStart.speed = ((float)gFlyingStart.windowCount * MOTOR_ENCODER_COUNT_PER_CYCLE_TO_RAD_PER_SEC_ELEC)
+                             / (float)cycles;
+        gFlyingStart.windowPosition = position;
+        gFlyingStart.windowCycles += cycles;
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_FlyingStartCatch                                      */
+/* Function parameters: None                                                  */
+/* Function return: Start speed, electrical rad/s                             */
+/* Description: Speed of the last window to start the loops from, at the      */
+/*              restart. Below FLYING_START_MIN_SPEED_RPM the loops start     */
+/*              from zero.                                                    */
+/******************************************************************************/
+float MCAPP_FlyingStartCatch(void)
+{
+    float speed = gFlyingStart.speed;
+
+    if(fabsf(speed) < MOTOR_FLYING_START_MIN_SPEED)
+    {
+        speed = 0.0f;
+    }
+    else
+    {
+        gFlyingStart.catches++;
+    }
+    gFlyingStart.startSpeed = speed;
+    return speed;
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,132 @@
+/*******************************************************************************
+ Flying start interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_flying_start.h
+
+  Summary:
+    Speed of a coasting rotor for the restart
+
+  Description:
+    This file contains the data structure and function prototypes of the
+    flying start speed measurement. mc_app.c tracks the encoder while the
+    motor is stopped and loads its control loops from the start speed.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_FLYING_START_H    // Guards against multiple inclusion
+#define MC_FLYING_START_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include "userparams.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Flying start
+
+  Summary:
+    Restart on a rotor which is still spinning
+
+  Description:
+    The encoder keeps counting while the motor is stopped and the
+    background task follows the count, so the angle is known at any
+    restart. The count over each FLYING_START_WINDOW_MS window, timed by
+    the DWT cycle counter, gives the speed. At the restart the speed ramp
+    and the speed estimators start from the last window speed, the q-axis
+    current integrator from its back EMF: the loops take the rotor over at
+    zero current instead of braking it from zero speed.
+
+  Remarks:
+    Until the first window after the stop closes, the speed is the one of
+    the speed loop when the motor stopped. The speed loop integrator, the
+    load torque, starts from zero: the coast deceleration over the window
+    is too small to be measured.
+*/
+typedef struct
+{
+    float    speed;             /* Speed of the last window, electrical rad/s */
+    float    startSpeed;        /* Speed loaded at the last restart; 0 below the min speed */
+    float    vqFeedForward;     /* Back EMF loaded in the Iq integrator, per unit */
+    int32_t  windowCount;       /* Encoder counts over the last window */
+    int32_t  windowPosition;    /* Multi-turn count at the start of the open window */
+    uint32_t windowCycles;      /* CPU cycle count at the start of the open window */
+    uint32_t catches;           /* Restarts on a spinning rotor */
+} MCAPP_FLYING_START;
+
+#if(ENABLE_FLYING_START == true)
+/* Last restart measurement, read through X2Cscope */
+extern MCAPP_FLYING_START gFlyingStart;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_FlyingStartReset(float speed, int32_t position);
+void MCAPP_FlyingStartMeasure(int32_t position);
+float MCAPP_FlyingStartCatch(void);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_FLYING_START_H
+
+/**
+ End of File
+*/
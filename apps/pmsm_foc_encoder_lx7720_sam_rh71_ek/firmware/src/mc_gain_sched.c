@@ -0,0 +1,163 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_gain_sched.c
+
+  Summary:
+    This file contains the PI gain scheduling.
+
+  Description:
+    This file contains the gain scheduling tables and the interpolation of
+    the PI gains on the speed and the q-axis current.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_gain_sched.h"
+#include "mc_motor_profile.h"
+#include "CMSIS/Core/Include/core_cm7.h"
+#include "math.h"
+
+#if(ENABLE_GAIN_SCHEDULING == true)
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static float MCAPP_GainSchedFraction(float x, float x0, float x1);
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+/* Gain scheduling tables. Defaults equal the fixed gains of "userparams.h" */
+MCAPP_GAIN_SCHED_SPEED_POINT gGainSchedSpeedTable[GAIN_SCHED_SPEED_POINTS] =
+{
+    {GAIN_SCHED_SPEED_0, {D_CURRCNTR_PTERM, D_CURRCNTR_ITERM, Q_CURRCNTR_PTERM, Q_CURRCNTR_ITERM, SPEEDCNTR_PTERM, SPEEDCNTR_ITERM}},
+    {GAIN_SCHED_SPEED_1, {D_CURRCNTR_PTERM, D_CURRCNTR_ITERM, Q_CURRCNTR_PTERM, Q_CURRCNTR_ITERM, SPEEDCNTR_PTERM, SPEEDCNTR_ITERM}},
+    {GAIN_SCHED_SPEED_2, {D_CURRCNTR_PTERM, D_CURRCNTR_ITERM, Q_CURRCNTR_PTERM, Q_CURRCNTR_ITERM, SPEEDCNTR_PTERM, SPEEDCNTR_ITERM}},
+    {GAIN_SCHED_SPEED_3, {D_CURRCNTR_PTERM, D_CURRCNTR_ITERM, Q_CURRCNTR_PTERM, Q_CURRCNTR_ITERM, SPEEDCNTR_PTERM, SPEEDCNTR_ITERM}}
+};
+
+MCAPP_GAIN_SCHED_IQ_POINT gGainSchedIqTable[GAIN_SCHED_IQ_POINTS] =
+{
+    {GAIN_SCHED_IQ_0, 1.0f},
+    {GAIN_SCHED_IQ_1, 1.0f},
+    {GAIN_SCHED_IQ_2, 1.0f}
+};
+
+/* Shadow gains written by the slow loop and swapped in by the fast loop */
+MCAPP_PI_GAINS gPIGainsShadow;
+volatile bool gPIGainsShadowPending = false;
+
+/******************************************************************************/
+/* Function name: MCAPP_GainSchedFraction                                     */
+/* Function parameters: x - table input, x0/x1 - segment breakpoints          */
+/* Function return: Position of x inside the segment, limited to 0..1         */
+/* Description: Interpolation weight for the gain scheduling tables           */
+/******************************************************************************/
+static float MCAPP_GainSchedFraction(float x, float x0, float x1)
+{
+    float frac = 0.0f;
+
+    /* Breakpoints are edited at runtime: guard against unordered entries */
+    if((x1 > x0) && (x > x0))
+    {
+        frac = (x - x0) / (x1 - x0);
+        if(frac > 1.0f)
+        {
+            frac = 1.0f;
+        }
+    }
+    return frac;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_GainScheduleUpdate                                    */
+/* Function parameters: speed - electrical speed (rad/s), iq - Iq ref (A)     */
+/* Function return: None                                                      */
+/* Description: Interpolates the PI gains from the gain scheduling tables     */
+/*              and publishes them in the shadow copy. The fast control loop  */
+/*              swaps them in at its next execution.                          */
+/******************************************************************************/
+void MCAPP_GainScheduleUpdate(float speed, float iq)
+{
+    const MCAPP_GAIN_SCHED_SPEED_POINT *pLo;
+    const MCAPP_GAIN_SCHED_SPEED_POINT *pHi;
+    float absSpeed = fabsf(speed);
+    float absIq = fabsf(iq);
+    float frac;
+    float currScale;
+    uint32_t i;
+
+    /* Do not touch the shadow copy until the fast loop has consumed it */
+    if(gPIGainsShadowPending == false)
+    {
+        /* Speed segment lookup, values beyond the table ends are clamped */
+        i = 0U;
+        while(((i + 2U) < GAIN_SCHED_SPEED_POINTS) && (absSpeed > gGainSchedSpeedTable[i + 1U].speed))
+        {
+            i++;
+        }
+        pLo = &gGainSchedSpeedTable[i];
+        pHi = &gGainSchedSpeedTable[i + 1U];
+        frac = MCAPP_GainSchedFraction(absSpeed, pLo->speed, pHi->speed);
+
+        /* Current loop scale factor from the iq table */
+        i = 0U;
+        while(((i + 2U) < GAIN_SCHED_IQ_POINTS) && (absIq > gGainSchedIqTable[i + 1U].iq))
+        {
+            i++;
+        }
+        currScale = MCAPP_GainSchedFraction(absIq, gGainSchedIqTable[i].iq, gGainSchedIqTable[i + 1U].iq);
+        currScale = gGainSchedIqTable[i].currScale
+                  + (currScale * (gGainSchedIqTable[i + 1U].currScale - gGainSchedIqTable[i].currScale));
+
+        gPIGainsShadow.dKp = currScale * (pLo->gains.dKp + (frac * (pHi->gains.dKp - pLo->gains.dKp)));
+        gPIGainsShadow.dKi = currScale * (pLo->gains.dKi + (frac * (pHi->gains.dKi - pLo->gains.dKi)));
+        gPIGainsShadow.qKp = currScale * (pLo->gains.qKp + (frac * (pHi->gains.qKp - pLo->gains.qKp)));
+        gPIGainsShadow.qKi = currScale * (pLo->gains.qKi + (frac * (pHi->gains.qKi - pLo->gains.qKi)));
+        gPIGainsShadow.speedKp = pLo->gains.speedKp + (frac * (pHi->gains.speedKp - pLo->gains.speedKp));
+        gPIGainsShadow.speedKi = pLo->gains.speedKi + (frac * (pHi->gains.speedKi - pLo->gains.speedKi));
+
+        /* Shadow must be complete before it is handed over to the ISR */
+        __DMB();
+        gPIGainsShadowPending = true;
+    }
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ Gain scheduling interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_gain_sched.h
+
+  Summary:
+    PI gains interpolated on speed and current
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    PI gain scheduling. mc_app.c swaps the scheduled gains into its PI
+    controllers in the fast control loop.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_GAIN_SCHED_H    // Guards against multiple inclusion
+#define MC_GAIN_SCHED_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "userparams.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* PI gain set
+
+  Summary:
+    Proportional and integral gains of the three FOC PI controllers
+
+  Description:
+    Used both as the output of the gain scheduler and as the shadow copy
+    which is swapped into gPIParmD, gPIParmQ and gPIParmQref by the fast
+    control loop.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    float dKp;      /* Id PI proportional gain */
+    float dKi;      /* Id PI integral gain */
+    float qKp;      /* Iq PI proportional gain */
+    float qKi;      /* Iq PI integral gain */
+    float speedKp;  /* Speed PI proportional gain */
+    float speedKi;  /* Speed PI integral gain */
+} MCAPP_PI_GAINS;
+
+/* Speed gain scheduling breakpoint */
+typedef struct
+{
+    float speed;            /* Breakpoint absolute electrical speed (rad/s) */
+    MCAPP_PI_GAINS gains;   /* Gains at this breakpoint */
+} MCAPP_GAIN_SCHED_SPEED_POINT;
+
+/* Current gain scheduling breakpoint */
+typedef struct
+{
+    float iq;               /* Breakpoint absolute q-axis current (A) */
+    float currScale;        /* Scale applied to the Id/Iq PI gains */
+} MCAPP_GAIN_SCHED_IQ_POINT;
+
+#if(ENABLE_GAIN_SCHEDULING == true)
+/* Gain scheduling tables, kept in RAM to be tuned at runtime through X2Cscope */
+extern MCAPP_GAIN_SCHED_SPEED_POINT gGainSchedSpeedTable[GAIN_SCHED_SPEED_POINTS];
+extern MCAPP_GAIN_SCHED_IQ_POINT gGainSchedIqTable[GAIN_SCHED_IQ_POINTS];
+
+/* Shadow gains written by the slow loop and swapped in by the fast loop */
+extern MCAPP_PI_GAINS gPIGainsShadow;
+extern volatile bool gPIGainsShadowPending;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_GainScheduleUpdate(float speed, float iq);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_GAIN_SCHED_H
+
+/**
+ End of File
+*/
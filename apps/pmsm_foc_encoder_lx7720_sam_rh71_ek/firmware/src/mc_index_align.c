@@ -0,0 +1,109 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_index_align.c
+
+  Summary:
+    This file contains the encoder index alignment.
+
+  Description:
+    This file contains the learning of the index offset and the correction
+    of the mechanical count on each index pulse.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_index_align.h"
+#include "mc_motor_profile.h"
+
+#if(ENABLE_INDEX_ALIGNMENT == true)
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_INDEX_ALIGN gIndexAlign = {ENCODER_INDEX_OFFSET_COUNT, 0U, 0U, 0U};
+
+/******************************************************************************/
+/* Function name: MCAPP_IndexAlignUpdate                                      */
+/* Function parameters: qdecStatus - QDEC status read in this loop,           */
+/*                      pCount - mechanical count, 0 to                       */
+/*                      ENCODER_PULSES_PER_MREV - 1,                          */
+/*                      learn - an unknown offset may be learned              */
+/* Function return: true when the count was moved onto the offset             */
+/* Description: On an encoder index pulse, learns the index offset or moves   */
+/*              the mechanical count back onto it.                            */
+/******************************************************************************/
+bool MCAPP_IndexAlignUpdate(uint32_t qdecStatus, uint32_t *pCount, bool learn)
+{
+    uint32_t error;
+    bool moved = false;
+
+    if((qdecStatus & TC_QUADRATURE_INDEX) != 0U)
+    {
+        gIndexAlign.indexCount++;
+        if(gIndexAlign.offset == ENCODER_INDEX_OFFSET_UNKNOWN)
+        {
+            if(learn == true)
+            {
+                /* Commissioning: the rotor was aligned by the full lock */
+                gIndexAlign.offset = *pCount;
+            }
+        }
+        else
+        {
+            /* Counts to add to reach the offset, 0 to ENCODER_PULSES_PER_REV - 1 */
+            error = (gIndexAlign.offset + (uint32_t)ENCODER_PULSES_PER_MREV) - *pCount;
+            if(error >= (uint32_t)ENCODER_PULSES_PER_MREV)
+            {
+                error -= (uint32_t)ENCODER_PULSES_PER_MREV;
+            }
+            gIndexAlign.lastError = error;
+
+            if((error > INDEX_CORRECTION_TOLERANCE) && (error < ((uint32_t)ENCODER_PULSES_PER_MREV - INDEX_CORRECTION_TOLERANCE)))
+            {
+                gIndexAlign.corrections++;
+                *pCount = gIndexAlign.offset;
+                moved = true;
+            }
+        }
+    }
+    return moved;
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,123 @@
+/*******************************************************************************
+ Encoder index alignment interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_index_align.h
+
+  Summary:
+    Encoder count alignment on the index pulse
+
+  Description:
+    This file contains the data structure and function prototypes of the
+    encoder index alignment. mc_app.c calls it on the mechanical count of
+    the fast control loop.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_INDEX_ALIGN_H    // Guards against multiple inclusion
+#define MC_INDEX_ALIGN_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "userparams.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Encoder index alignment
+
+  Summary:
+    Angle offset of the encoder index pulse
+
+  Description:
+    The offset is the mechanical encoder count of the index pulse, counted
+    from the rotor d-axis found by the startup lock. It is learned on the
+    first index after a full lock, or taken from "userparams.h". Each index
+    then moves the count back onto the offset.
+
+  Remarks:
+    The index is sampled at fast loop rate, so the count carries up to one
+    fast loop of motion.
+*/
+typedef struct
+{
+    uint32_t offset;        /* Mechanical count at the index, ENCODER_INDEX_OFFSET_UNKNOWN until learned */
+    uint32_t lastError;     /* Counts added at the last index, 0 to ENCODER_PULSES_PER_REV - 1 */
+    uint32_t indexCount;    /* Index pulses seen in closed loop */
+    uint32_t corrections;   /* Index pulses which moved the angle */
+} MCAPP_INDEX_ALIGN;
+
+#if(ENABLE_INDEX_ALIGNMENT == true)
+/* Index offset, read through X2Cscope after commissioning */
+extern MCAPP_INDEX_ALIGN gIndexAlign;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+bool MCAPP_IndexAlignUpdate(uint32_t qdecStatus, uint32_t *pCount, bool learn);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_INDEX_ALIGN_H
+
+/**
+ End of File
+*/
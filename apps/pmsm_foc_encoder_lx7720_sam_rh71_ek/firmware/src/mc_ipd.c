@@ -0,0 +1,247 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_ipd.c
+
+  Summary:
+    This file contains the initial position detection.
+
+  Description:
+    This file contains the voltage pulse sequence and the saliency and
+    polarity fit of the initial position detection.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_ipd.h"
+#include "mc_motor_profile.h"
+#include "math.h"
+
+#if(ENABLE_INITIAL_POSITION_DETECTION == true)
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static void MCAPP_IPDPulseStart(float angle, uint32_t scale);
+static void MCAPP_IPDPulseEnd(void);
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_IPD gIPD;
+
+/******************************************************************************/
+/* Function name: MCAPP_IPDReset                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Starts the initial position detection with the first pulse.   */
+/******************************************************************************/
+void MCAPP_IPDReset(void)
+{
+    gIPD.step = IPD_PULSES;
+    gIPD.pulse = 0U;
+    gIPD.sumResponse = 0.0f;
+    gIPD.sumCos2 = 0.0f;
+    gIPD.sumSin2 = 0.0f;
+    gIPD.response[0] = 0.0f;
+    gIPD.response[1] = 0.0f;
+    gIPD.saliency = 0.0f;
+    gIPD.polarity = 0.0f;
+    gIPD.angle = 0.0f;
+    gIPD.startCount = 0U;
+    MCAPP_IPDPulseStart(0.0f, 1U);
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_IPDPulseStart                                         */
+/* Function parameters: angle - pulse electrical angle (rad), -2*PI to 4*PI,  */
+/*                      scale - pulse and rest length, in IPD_PULSE_TICKS and */
+/*                      IPD_REST_TICKS                                        */
+/* Function return: None                                                      */
+/* Description: Sets up the next pulse.                                       */
+/******************************************************************************/
+static void MCAPP_IPDPulseStart(float angle, uint32_t scale)
+{
+    if(angle >= (2.0f * PI))
+    {
+        angle -= 2.0f * PI;
+    }
+    else if(angle < 0.0f)
+    {
+        angle += 2.0f * PI;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+    gIPD.axis.angle = angle;
+    MCLIB_SinCosCalc(&gIPD.axis);
+
+    gIPD.ticks = 0U;
+    gIPD.pulseTicks = IPD_PULSE_TICKS * scale;
+    gIPD.endTicks = ((2U * IPD_PULSE_TICKS) + IPD_REST_TICKS) * scale;
+    gIPD.sum = 0.0f;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_IPDPulseEnd                                           */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Adds the response of the pulse just ended, and starts the     */
+/*              next one or ends the detection.                               */
+/******************************************************************************/
+static void MCAPP_IPDPulseEnd(void)
+{
+    float response;
+    float count;
+
+    /* Current left from the previous pulses: remove the line through the first and last sample */
+    response = gIPD.sum - ((float)gIPD.endTicks * 0.5f * (gIPD.first + gIPD.last));
+    gIPD.pulse++;
+
+    if(gIPD.step == IPD_PULSES)
+    {
+        gIPD.sumResponse += response;
+        gIPD.sumCos2 += response * ((gIPD.axis.cosAngle * gIPD.axis.cosAngle) - (gIPD.axis.sineAngle * gIPD.axis.sineAngle));
+        gIPD.sumSin2 += response * (2.0f * gIPD.axis.sineAngle * gIPD.axis.cosAngle);
+
+        if(gIPD.pulse < IPD_PULSE_ANGLES)
+        {
+            /* Opposite angles one after the other: their torque pulses cancel */
+            MCAPP_IPDPulseStart(((float)(gIPD.pulse >> 1U) * (2.0f * PI / (float)IPD_PULSE_ANGLES))
+                                + ((float)(gIPD.pulse & 1U) * PI), 1U);
+        }
+        else
+        {
+            if(gIPD.sumResponse > 0.0f)
+            {
+                gIPD.saliency = 2.0f * hypotf(gIPD.sumCos2, gIPD.sumSin2) / gIPD.sumResponse;
+            }
+            if(gIPD.saliency < IPD_MIN_SALIENCY)
+            {
+                gIPD.step = IPD_FAILED;
+            }
+            else
+            {
+                /* d-axis, either pole */
+                gIPD.angle = 0.5f * atan2f(gIPD.sumSin2, gIPD.sumCos2);
+                gIPD.pulse = 0U;
+                gIPD.step = IPD_POLARITY;
+                MCAPP_IPDPulseStart(gIPD.angle, IPD_POLARITY_PULSE_SCALE);
+            }
+        }
+    }
+    else
+    {
+        gIPD.response[gIPD.pulse - 1U] = response;
+        if(gIPD.pulse < 2U)
+        {
+            MCAPP_IPDPulseStart(gIPD.angle + PI, IPD_POLARITY_PULSE_SCALE);
+        }
+        else
+        {
+            if((gIPD.response[0] + gIPD.response[1]) > 0.0f)
+            {
+                gIPD.polarity = (gIPD.response[0] - gIPD.response[1]) / (gIPD.response[0] + gIPD.response[1]);
+            }
+            if(fabsf(gIPD.polarity) < IPD_MIN_POLARITY)
+            {
+                gIPD.step = IPD_FAILED;
+            }
+            else
+            {
+                if(gIPD.polarity < 0.0f)
+                {
+                    gIPD.angle += PI;
+                }
+                if(gIPD.angle < 0.0f)
+                {
+                    gIPD.angle += 2.0f * PI;
+                }
+                count = roundf(gIPD.angle * MOTOR_RAD_ELEC_TO_ENCODER_COUNT);
+                gIPD.startCount = (uint32_t)count;
+                gIPD.step = IPD_DONE;
+            }
+        }
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_IPDUpdate                                             */
+/* Function parameters: current - present alpha/beta currents (A)             */
+/* Function return: d-axis pulse voltage, along gIPD.axis                     */
+/* Description: Sums the current along the pulse angle and steps the pulse.   */
+/*              Called every fast loop of the detection.                      */
+/******************************************************************************/
+float MCAPP_IPDUpdate(const MCLIB_I_ALPHA_BETA *current)
+{
+    float axisCurrent;
+    float voltage;
+
+    axisCurrent = (current->iAlpha * gIPD.axis.cosAngle) + (current->iBeta * gIPD.axis.sineAngle);
+    if(gIPD.ticks == 0U)
+    {
+        gIPD.first = axisCurrent;
+    }
+    gIPD.last = axisCurrent;
+    gIPD.sum += axisCurrent;
+
+    if(gIPD.ticks < gIPD.pulseTicks)
+    {
+        voltage = IPD_PULSE_VOLTAGE;
+    }
+    else if(gIPD.ticks < (2U * gIPD.pulseTicks))
+    {
+        /* Less the resistive drop of the rise: the current ends near zero */
+        voltage = -IPD_PULSE_VOLTAGE * (1.0f - (IPD_REVERSE_DROP_PER_TICK * (float)gIPD.pulseTicks));
+    }
+    else
+    {
+        voltage = 0.0f;
+    }
+
+    gIPD.ticks++;
+    if(gIPD.ticks >= gIPD.endTicks)
+    {
+        MCAPP_IPDPulseEnd();
+    }
+    return voltage;
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
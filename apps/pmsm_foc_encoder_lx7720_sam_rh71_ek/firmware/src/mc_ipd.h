@@ -0,0 +1,150 @@
+/*******************************************************************************
+ Initial position detection interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_ipd.h
+
+  Summary:
+    Standstill rotor angle from the inductance saliency
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    initial position detection, which finds the rotor angle at standstill
+    with voltage pulses instead of the startup lock.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_IPD_H    // Guards against multiple inclusion
+#define MC_IPD_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include "userparams.h"
+#include "mclib_generic_float.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Initial position detection steps */
+typedef enum
+{
+    IPD_NONE = 0U,              /* Not run since power up */
+    IPD_PULSES,                 /* Pulses around the electrical revolution, d-axis */
+    IPD_POLARITY,               /* Pulses both ways along the d-axis, magnet polarity */
+    IPD_DONE,                   /* Rotor angle found */
+    IPD_FAILED                  /* Saliency or polarity too small: the lock starts the motor */
+} MCAPP_IPD_STEP;
+
+/* Initial position detection
+
+  Summary:
+    Standstill rotor angle from the inductance saliency
+
+  Description:
+    Each pulse is a voltage step along a fixed angle, the same step reversed
+    to bring the current back, and a rest. The current response along the
+    pulse angle, summed over the pulse, goes as one over the inductance:
+    its second harmonic over the angles points along the d-axis, where the
+    inductance is lowest. The magnet saturates the iron further with a
+    positive d current: of two pulses both ways along the axis, the larger
+    response is the north pole.
+
+  Remarks:
+    The current is not fully back to zero at the end of a pulse, the
+    response is taken against the line through its first and last sample.
+*/
+typedef struct
+{
+    MCAPP_IPD_STEP step;
+    uint32_t pulse;             /* Pulse of the present step */
+    uint32_t ticks;             /* Fast loops in the present pulse */
+    uint32_t pulseTicks;        /* Voltage step length of the present pulse */
+    uint32_t endTicks;          /* Length of the present pulse with its rest */
+    MCLIB_POSITION axis;        /* Pulse angle, electrical */
+    float    first;             /* Current along the axis at the start of the pulse (A) */
+    float    last;              /* Same, latest */
+    float    sum;               /* Sum of the current along the axis */
+    float    sumResponse;       /* Sums of the responses over the angles */
+    float    sumCos2;
+    float    sumSin2;
+    float    response[2];       /* Responses of the polarity pulses */
+    float    saliency;          /* d-axis response to mean response ratio */
+    float    polarity;          /* Polarity pulse response difference ratio */
+    float    angle;             /* Rotor electrical angle found (rad) */
+    uint32_t startCount;        /* Mechanical count of the rotor at the switch to closed loop */
+} MCAPP_IPD;
+
+#if(ENABLE_INITIAL_POSITION_DETECTION == true)
+/* Initial position detection results, read through X2Cscope */
+extern MCAPP_IPD gIPD;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_IPDReset(void);
+float MCAPP_IPDUpdate(const MCLIB_I_ALPHA_BETA *current);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_IPD_H
+
+/**
+ End of File
+*/
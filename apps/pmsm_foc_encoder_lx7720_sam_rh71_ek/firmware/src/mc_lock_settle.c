@@ -0,0 +1,139 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_lock_settle.c
+
+  Summary:
+    This file contains the startup lock settle detection.
+
+  Description:
+    This file contains the lock current and angle ramps and the detection
+    of a still rotor on the encoder count.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_lock_settle.h"
+#include "mc_encoder.h"
+#include "mc_motor_profile.h"
+#include "math.h"
+
+#if(ENABLE_LOCK_SETTLE_DETECTION == true)
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_LOCK_SETTLE gLockSettle;
+
+/******************************************************************************/
+/* Function name: MCAPP_LockSettleReset                                       */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Starts the encoder count and the settle detection of the      */
+/*              startup lock, with the lock current at zero.                  */
+/******************************************************************************/
+void MCAPP_LockSettleReset(void)
+{
+    /* Count from 0: the switch to closed loop restarts it again */
+    TC1_QuadratureStart();
+
+    gLockSettle.step = 0U;
+    gLockSettle.ticks = 0U;
+    gLockSettle.stillWindows = 0U;
+    gLockSettle.prevCount = 0U;
+    gLockSettle.currentRamp = 0.0f;
+    gLockSettle.angleRamp = 0.0f;
+    gLockSettle.lockTicks = 0U;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_LockSettleUpdate                                      */
+/* Function parameters: step - lock step, 0 or 1                              */
+/* Function return: true once the rotor is still at the full lock current     */
+/*                  and angle                                                 */
+/* Description: Ramps the lock current and the second step angle, and counts  */
+/*              the speed windows without motion. Called every fast loop of   */
+/*              the lock.                                                     */
+/******************************************************************************/
+bool MCAPP_LockSettleUpdate(uint32_t step)
+{
+    uint16_t count;
+    int32_t  delta;
+    bool     rampsDone;
+
+    count = (uint16_t)((TC1_REGS->TC_CHANNEL[0].TC_CV) & 0xFFFFu);
+    if(step != gLockSettle.step)
+    {
+        /* New step, also entered directly when the index offset is known */
+        gLockSettle.step = step;
+        gLockSettle.ticks = 0U;
+        gLockSettle.stillWindows = 0U;
+        gLockSettle.prevCount = count;
+    }
+
+    gLockSettle.lockTicks++;
+    gLockSettle.currentRamp = fminf(gLockSettle.currentRamp + LOCK_CURRENT_RAMP_STEP, 1.0f);
+    if(step != 0U)
+    {
+        gLockSettle.angleRamp = fminf(gLockSettle.angleRamp + LOCK_ANGLE_RAMP_STEP, 1.0f);
+    }
+    rampsDone = (gLockSettle.currentRamp >= 1.0f) && ((step == 0U) || (gLockSettle.angleRamp >= 1.0f));
+
+    gLockSettle.ticks++;
+    if(gLockSettle.ticks >= LOCK_SETTLE_WINDOW_TICKS)
+    {
+        gLockSettle.ticks = 0U;
+        delta = MCAPP_QDECDelta(count, gLockSettle.prevCount);
+        gLockSettle.prevCount = count;
+
+        /* Still only counts at the full pull: a weak lock may not have moved the rotor yet */
+        if((rampsDone == true) && (delta <= LOCK_SETTLE_WINDOW_COUNT) && (delta >= -LOCK_SETTLE_WINDOW_COUNT))
+        {
+            gLockSettle.stillWindows++;
+        }
+        else
+        {
+            gLockSettle.stillWindows = 0U;
+        }
+    }
+
+    return (gLockSettle.stillWindows >= LOCK_SETTLE_WINDOWS);
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,128 @@
+/*******************************************************************************
+ Startup lock settle interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_lock_settle.h
+
+  Summary:
+    End of the startup lock steps on rotor settle
+
+  Description:
+    This file contains the data structure and function prototypes of the
+    startup lock settle detection, run by the fast control loop of
+    mc_app.c during the lock.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_LOCK_SETTLE_H    // Guards against multiple inclusion
+#define MC_LOCK_SETTLE_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "userparams.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Startup lock settle detection
+
+  Summary:
+    Ends each step of the startup lock once the rotor is still
+
+  Description:
+    The lock current ramps up from zero, and the second step turns the lock
+    angle over instead of jumping it, so the rotor is pulled in without a
+    kick. Once the ramps are done, the encoder count is read every
+    LOCK_SETTLE_WINDOW_TICKS: the step ends after LOCK_SETTLE_WINDOWS
+    windows in a row, each with at most LOCK_SETTLE_WINDOW_COUNT counts
+    of motion.
+
+  Remarks:
+    LOCK_TIME_IN_SEC stays the length of a step which does not settle.
+*/
+typedef struct
+{
+    uint32_t step;              /* Lock step the window belongs to, 0 or 1 */
+    uint32_t ticks;             /* Fast loops in the present window */
+    uint32_t stillWindows;      /* Windows in a row without motion */
+    uint16_t prevCount;         /* QDEC count at the start of the window */
+    float    currentRamp;       /* Lock current, fraction of Q_CURRENT_REF_OPENLOOP */
+    float    angleRamp;         /* Turn to the second step angle, 0 to 1 */
+    uint32_t lockTicks;         /* Fast loops since the start of the lock */
+} MCAPP_LOCK_SETTLE;
+
+#if(ENABLE_LOCK_SETTLE_DETECTION == true)
+/* Startup lock state, lockTicks is the length of the last lock */
+extern MCAPP_LOCK_SETTLE gLockSettle;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_LockSettleReset(void);
+bool MCAPP_LockSettleUpdate(uint32_t step);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_LOCK_SETTLE_H
+
+/**
+ End of File
+*/
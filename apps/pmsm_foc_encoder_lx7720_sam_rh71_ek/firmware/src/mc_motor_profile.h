@@ -0,0 +1,184 @@
+/*******************************************************************************
+  Motor profile constants
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_motor_profile.h
+
+  Summary:
+    Single precision constants derived from the selected motor
+
+  Description:
+    The motor description tables of "userparams.h" are selected by MOTOR.
+    This file turns the selected entry into single precision constants, so
+    that scale factors and reciprocals are folded once at compile time and
+    the control loops only multiply. The constants are listed once in
+    MC_MOTOR_PROFILE_TABLE; the declarations are generated from it.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_MOTOR_PROFILE_H    // Guards against multiple inclusion
+#define MC_MOTOR_PROFILE_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include "userparams.h"
+#include "mclib_generic_float.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Motor description checks
+// *****************************************************************************
+// *****************************************************************************
+#ifndef ENCODER_PULSES_PER_REV
+#error "ENCODER_PULSES_PER_REV is not defined for the selected MOTOR"
+#endif
+
+/* Whole numbers: a float literal here fails the #if itself */
+#if((NUM_POLE_PAIRS < 1U) || (ENCODER_PULSES_PER_REV < 1U) || (RATED_SPEED_RPM > MAX_SPEED_RPM))
+#error "NUM_POLE_PAIRS and ENCODER_PULSES_PER_REV must be positive, RATED_SPEED_RPM up to MAX_SPEED_RPM"
+#endif
+#if(ENCODER_PULSES_PER_REV >= (QDEC_RC / 2U))
+#error "ENCODER_PULSES_PER_REV must be below half the QDEC counter range"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Derived constants
+// *****************************************************************************
+// *****************************************************************************
+/* X(name, value): values are evaluated by the compiler, in double precision
+   where the parameters are doubles, and rounded once to float */
+#define MC_MOTOR_PROFILE_TABLE(X)                                                                  \
+    /* Encoder count to electrical angle (rad) */                                                  \
+    X(MOTOR_ENCODER_COUNT_TO_RAD_ELEC,                                                             \
+      (2.0 * M_PI) * (double)NUM_POLE_PAIRS / (double)ENCODER_PULSES_PER_REV)                      \
+    /* Electrical angle (rad) to encoder count */                                                  \
+    X(MOTOR_RAD_ELEC_TO_ENCODER_COUNT,                                                             \
+      (double)ENCODER_PULSES_PER_REV / ((2.0 * M_PI) * (double)NUM_POLE_PAIRS))                    \
+    /* Encoder count difference over one speed loop to electrical speed (rad/s) */                 \
+    X(MOTOR_ENCODER_DIFF_TO_RAD_PER_SEC_ELEC,                                                      \
+      (2.0 * M_PI) * (double)NUM_POLE_PAIRS / ((double)ENCODER_PULSES_PER_REV * (double)SPEED_LOOP_TIME_SEC)) \
+    /* Encoder counts per fast loop period to electrical speed (rad/s) */                          \
+    X(MOTOR_ENCODER_COUNT_PER_TICK_TO_RAD_PER_SEC_ELEC,                                            \
+      (2.0 * M_PI) * (double)NUM_POLE_PAIRS / ((double)ENCODER_PULSES_PER_REV * (double)FAST_LOOP_TIME_SEC)) \
+    /* Binary electrical angle (2^32 = 2*PI) to radians */                                         \
+    X(MOTOR_ANGLE_Q32_TO_RAD,                                                                      \
+      (2.0 * M_PI) / 4294967296.0)                                                                 \
+    /* Rated and max electrical speed (rad/s) */                                                   \
+    X(MOTOR_RATED_SPEED_RAD_PER_SEC_ELEC,                                                          \
+      (double)RATED_SPEED_RPM * ((2.0 * M_PI) / 60.0) * (double)NUM_POLE_PAIRS)                    \
+    X(MOTOR_MAX_SPEED_RAD_PER_SEC_ELEC,                                                            \
+      (double)MAX_SPEED_RPM * ((2.0 * M_PI) / 60.0) * (double)NUM_POLE_PAIRS)                      \
+    /* Speed ramp limits in electrical rad/s^2 and rad/s^3 */                                      \
+    X(MOTOR_SPEED_RAMP_ACCEL,                                                                      \
+      (double)SPEED_RAMP_ACCEL_RPM_PER_SEC * (double)NUM_POLE_PAIRS * (M_PI / 30.0))               \
+    X(MOTOR_SPEED_RAMP_DECEL,                                                                      \
+      (double)SPEED_RAMP_DECEL_RPM_PER_SEC * (double)NUM_POLE_PAIRS * (M_PI / 30.0))               \
+    X(MOTOR_SPEED_RAMP_JERK,                                                                       \
+      (double)SPEED_RAMP_JERK_RPM_PER_SEC2 * (double)NUM_POLE_PAIRS * (M_PI / 30.0))               \
+    /* Back EMF constant, peak phase volts per electrical rad/s */                                 \
+    X(MOTOR_BEMF_CONST_VPK_PH_PER_RAD_PER_SEC_ELEC,                                                \
+      ((double)MOTOR_BEMF_CONST_V_PEAK_LL_KRPM_MECH / 1000.0) / (double)SQRT3                      \
+      * (60.0 / (2.0 * M_PI)) / (double)NUM_POLE_PAIRS)                                           \
+    /* Encoder counts per CPU cycle to electrical speed (rad/s) */                                 \
+    X(MOTOR_ENCODER_COUNT_PER_CYCLE_TO_RAD_PER_SEC_ELEC,                                           \
+      (2.0 * M_PI) * (double)NUM_POLE_PAIRS * (double)CPU_FREQUENCY / (double)ENCODER_PULSES_PER_REV) \
+    /* Flying start min speed (electrical rad/s) */                                                \
+    X(MOTOR_FLYING_START_MIN_SPEED,                                                                \
+      (double)FLYING_START_MIN_SPEED_RPM * ((2.0 * M_PI) / 60.0) * (double)NUM_POLE_PAIRS)         \
+    /* Position trajectory limits in encoder counts, per second, per s^2 and per s^3 */           \
+    X(MOTOR_POSITION_MAX_SPEED,                                                                    \
+      (double)POSITION_MAX_SPEED_RPM * (double)ENCODER_PULSES_PER_REV / 60.0)                      \
+    X(MOTOR_POSITION_MAX_ACCEL,                                                                    \
+      (double)POSITION_MAX_ACCEL_RPM_PER_SEC * (double)ENCODER_PULSES_PER_REV / 60.0)              \
+    X(MOTOR_POSITION_MAX_JERK,                                                                     \
+      (double)POSITION_MAX_JERK_RPM_PER_SEC2 * (double)ENCODER_PULSES_PER_REV / 60.0)              \
+    /* Time to reach the max acceleration, and the speed gained meanwhile both ways */             \
+    X(MOTOR_POSITION_ACCEL_TIME,                                                                   \
+      (double)POSITION_MAX_ACCEL_RPM_PER_SEC / (double)POSITION_MAX_JERK_RPM_PER_SEC2)             \
+    X(MOTOR_POSITION_ACCEL_SPEED,                                                                  \
+      (double)POSITION_MAX_ACCEL_RPM_PER_SEC * (double)POSITION_MAX_ACCEL_RPM_PER_SEC              \
+      / (double)POSITION_MAX_JERK_RPM_PER_SEC2 * (double)ENCODER_PULSES_PER_REV / 60.0)            \
+    /* Iq (A) per count/s^2 of trajectory acceleration: inertia / torque constant */              \
+    X(MOTOR_POSITION_ACCEL_TO_IQ,                                                                  \
+      (double)POSITION_LOAD_INERTIA_KGM2 * ((2.0 * M_PI) / (double)ENCODER_PULSES_PER_REV)         \
+      / (1.5 * ((double)MOTOR_BEMF_CONST_V_PEAK_LL_KRPM_MECH / 1000.0) / (double)SQRT3 * (60.0 / (2.0 * M_PI)))) \
+    /* Back EMF observer: inverse back EMF constant, electrical rad/s per peak phase volt */      \
+    X(MOTOR_BEMF_OBSERVER_INV_KE,                                                                  \
+      (double)SQRT3 * 1000.0 / (double)MOTOR_BEMF_CONST_V_PEAK_LL_KRPM_MECH                        \
+      * ((2.0 * M_PI) / 60.0) * (double)NUM_POLE_PAIRS)                                           \
+    /* Inductance over one fast loop period (V per A of current change) */                        \
+    X(MOTOR_INDUCTANCE_PER_FAST_LOOP,                                                              \
+      (double)MOTOR_PER_PHASE_INDUCTANCE / (double)FAST_LOOP_TIME_SEC)                             \
+    /* PWM voltage reference of 1.0 to peak phase volts */                                        \
+    X(MOTOR_PHASE_VOLTS_PER_UNIT,                                                                  \
+      (double)DC_BUS_VOLTAGE * (double)ONE_BY_SQRT3)                                               \
+    /* Back EMF observer min speed (electrical rad/s) */                                           \
+    X(MOTOR_BEMF_OBSERVER_MIN_SPEED,                                                               \
+      (double)BEMF_OBSERVER_MIN_SPEED_RPM * ((2.0 * M_PI) / 60.0) * (double)NUM_POLE_PAIRS)        \
+    /* Resolver electrical speed to motor electrical speed */                                      \
+    X(MOTOR_RESOLVER_SPEED_TO_ELEC,                                                                \
+      (double)NUM_POLE_PAIRS / (double)RESOLVER_POLE_PAIRS)                                        \
+    /* Radians to binary angle, 2^32 / (2 * PI) */                                                 \
+    X(MOTOR_RAD_TO_ANGLE_Q32,                                                                      \
+      4294967296.0 / (2.0 * M_PI))                                                                 \
+    /* Resolver envelope latency, half a carrier period: speed (rad/s) to binary angle lead */     \
+    X(MOTOR_RESOLVER_LATENCY_TO_ANGLE_Q32,                                                         \
+      (0.5 / (double)RESOLVER_CARRIER_FREQUENCY) * (4294967296.0 / (2.0 * M_PI)))
+
+#define MC_MOTOR_PROFILE_DECLARE(name, value)    static const float name = (float)(value);
+
+MC_MOTOR_PROFILE_TABLE(MC_MOTOR_PROFILE_DECLARE)
+
+/* Encoder count to binary electrical angle, 2^32 * NUM_POLE_PAIRS / ENCODER_PULSES_PER_REV
+   rounded. Only the fraction of a revolution is kept: the product of a mechanical count
+   and this step wraps once per electrical revolution, for any pulse and pole count */
+static const uint32_t MOTOR_ENCODER_COUNT_TO_ANGLE_Q32 =
+    (uint32_t)((((uint64_t)NUM_POLE_PAIRS << 32U) + ((uint64_t)ENCODER_PULSES_PER_MREV / 2U))
+               / (uint64_t)ENCODER_PULSES_PER_MREV);
+
+/* Encoder calibration forced angle step: NUM_POLE_PAIRS electrical revolutions, one mechanical
+   revolution, in ENCODER_CALIB_SWEEP_TICKS fast loops */
+static const uint32_t MOTOR_ENCODER_CALIB_STEP_Q32 =
+    (uint32_t)(((uint64_t)NUM_POLE_PAIRS << 32U) / (uint64_t)ENCODER_CALIB_SWEEP_TICKS);
+
+/* Resolver to motor binary angle: the product wraps once per motor electrical revolution */
+static const uint32_t MOTOR_RESOLVER_TO_ANGLE_Q32 = (uint32_t)(NUM_POLE_PAIRS / RESOLVER_POLE_PAIRS);
+
+#endif //MC_MOTOR_PROFILE_H
+
+/**
+ End of File
+*/
@@ -0,0 +1,191 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_offset_calib.c
+
+  Summary:
+    This file contains the current offset calibration and tracking.
+
+  Description:
+    This file contains the phase current offset measurement at start and
+    its drift tracking while the motor is stopped.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_offset_calib.h"
+#include "mc_motor_profile.h"
+#include "math.h"
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static float MCAPP_OffsetLimit(float offset);
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_OFFSET_CALIB gOffsetCalib;
+
+/******************************************************************************/
+/* Function name: MCAPP_OffsetCalibReset                                      */
+/* Function parameters: sample - present sinc3 sample count                   */
+/* Function return: None                                                      */
+/* Description: Starts a new offset measurement, on the next samples.         */
+/******************************************************************************/
+void MCAPP_OffsetCalibReset(uint32_t sample)
+{
+    gOffsetCalib.done = false;
+    gOffsetCalib.sample = sample;
+    /* First samples skipped: the sinc3 filter settles */
+    gOffsetCalib.skip = CURRENTS_OFFSET_SKIP_SAMPLES;
+    gOffsetCalib.samples = 0U;
+    gOffsetCalib.sumU = 0U;
+    gOffsetCalib.sumV = 0U;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_OffsetCalibUpdate                                     */
+/* Function parameters: sample - present sinc3 sample count,                  */
+/*                      currentU, currentV - last sinc3 outputs of the phases */
+/* Function return: true once the offsets are measured                        */
+/* Description: Measures motor phase current offsets, one new sinc3 sample    */
+/*              per call, without waiting. Limits the offset if it exceeds    */
+/*              the predetermined range.                                      */
+/******************************************************************************/
+bool MCAPP_OffsetCalibUpdate(uint32_t sample, uint32_t currentU, uint32_t currentV)
+{
+    if(sample == gOffsetCalib.sample)
+    {
+        /* No new sample */
+    }
+    else if(gOffsetCalib.skip > 0U)
+    {
+        gOffsetCalib.sample = sample;
+        gOffsetCalib.skip--;
+    }
+    else
+    {
+        gOffsetCalib.sample = sample;
+        gOffsetCalib.sumU += currentU;
+        gOffsetCalib.sumV += currentV;
+        gOffsetCalib.samples++;
+
+        if(gOffsetCalib.samples >= CURRENTS_OFFSET_SAMPLES)
+        {
+            gOffsetCalib.trackU = MCAPP_OffsetLimit(((float)CURRENT_OFFSET_SCALE * (float)gOffsetCalib.sumU)
+                                                    / (float)CURRENTS_OFFSET_SAMPLES);
+            gOffsetCalib.trackV = MCAPP_OffsetLimit(((float)CURRENT_OFFSET_SCALE * (float)gOffsetCalib.sumV)
+                                                    / (float)CURRENTS_OFFSET_SAMPLES);
+            gOffsetCalib.waitSamples = OFFSET_TRACK_PERIOD_SAMPLES;
+            gOffsetCalib.done = true;
+        }
+    }
+    return gOffsetCalib.done;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_OffsetLimit                                           */
+/* Function parameters: offset - phase current offset, tenths of a count      */
+/* Function return: Offset limited to the CURRENT_OFFSET_MIN/MAX range        */
+/* Description: Limits a phase current offset to configured Min/Max levels.   */
+/******************************************************************************/
+static float MCAPP_OffsetLimit(float offset)
+{
+    return fmaxf(fminf(offset, (float)(CURRENT_OFFSET_SCALE * CURRENT_OFFSET_MAX)),
+                 (float)(CURRENT_OFFSET_SCALE * CURRENT_OFFSET_MIN));
+}
+
+#if(ENABLE_OFFSET_TRACKING == true)
+/******************************************************************************/
+/* Function name: MCAPP_OffsetTrackHoldoff                                    */
+/* Function parameters: sample - present sinc3 sample count                   */
+/* Function return: None                                                      */
+/* Description: Bridge turned off: no tracking update for                     */
+/*              OFFSET_TRACK_HOLDOFF_MS, while the phase currents decay.      */
+/******************************************************************************/
+void MCAPP_OffsetTrackHoldoff(uint32_t sample)
+{
+    gOffsetCalib.sample = sample;
+    gOffsetCalib.waitSamples = OFFSET_TRACK_HOLDOFF_SAMPLES;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_OffsetTrackDue                                        */
+/* Function parameters: sample - present sinc3 sample count                   */
+/* Function return: true when a tracking update is due                        */
+/* Description: Every OFFSET_TRACK_PERIOD_MS, kept on the sample count        */
+/*              whatever the background tick phase.                           */
+/******************************************************************************/
+bool MCAPP_OffsetTrackDue(uint32_t sample)
+{
+    bool due = false;
+
+    if((sample - gOffsetCalib.sample) >= gOffsetCalib.waitSamples)
+    {
+        gOffsetCalib.sample += gOffsetCalib.waitSamples;
+        gOffsetCalib.waitSamples = OFFSET_TRACK_PERIOD_SAMPLES;
+        due = true;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+    return due;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_OffsetTrackUpdate                                     */
+/* Function parameters: currentU, currentV - weighted sums of the last sinc3  */
+/*                      samples, without offset                               */
+/* Function return: None                                                      */
+/* Description: Exponential average of OFFSET_TRACK_TIME_CONSTANT_MS on the   */
+/*              phase currents, once MCAPP_OffsetTrackDue.                    */
+/******************************************************************************/
+void MCAPP_OffsetTrackUpdate(int32_t currentU, int32_t currentV)
+{
+    gOffsetCalib.trackU += ((float)currentU - gOffsetCalib.trackU) * OFFSET_TRACK_GAIN;
+    gOffsetCalib.trackV += ((float)currentV - gOffsetCalib.trackV) * OFFSET_TRACK_GAIN;
+    gOffsetCalib.trackU = MCAPP_OffsetLimit(gOffsetCalib.trackU);
+    gOffsetCalib.trackV = MCAPP_OffsetLimit(gOffsetCalib.trackV);
+    gOffsetCalib.updates++;
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
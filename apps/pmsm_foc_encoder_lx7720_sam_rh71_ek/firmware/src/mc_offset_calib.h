@@ -0,0 +1,142 @@
+/*******************************************************************************
+ Current offset calibration interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_offset_calib.h
+
+  Summary:
+    Phase current sense offsets
+
+  Description:
+    This file contains the data structure and function prototypes of the
+    phase current offset calibration and tracking. mc_app.c runs the current
+    sense and applies the offsets to the fast loop.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_OFFSET_CALIB_H    // Guards against multiple inclusion
+#define MC_OFFSET_CALIB_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "userparams.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Motor phase current offset calibration limits. */
+#define CURRENT_OFFSET_MAX                (12700U) /* current offset max limit in terms of ADC count*/
+#define CURRENT_OFFSET_MIN                (12300U) /* current offset min limit in terms of ADC count*/
+#define CURRENT_OFFSET_SCALE              (10U)    /* Offsets are kept in tenths of a count, the unit of the weighted sum */
+
+/* Phase current offsets
+
+  Summary:
+    Current sense offset calibration and drift tracking
+
+  Description:
+    The calibration averages CURRENTS_OFFSET_SAMPLES sinc3 samples of each
+    phase, after CURRENTS_OFFSET_SKIP_SAMPLES for the filter to settle. It
+    runs in the background task, one new sample per pass, without waiting.
+    With ENABLE_OFFSET_TRACKING the current sense keeps running while the
+    motor is stopped: every OFFSET_TRACK_PERIOD_MS the weighted sum of the
+    last samples goes into an exponential average, which follows the drift
+    of the sense path with the bridge off.
+
+  Remarks:
+    Offsets are in tenths of a sinc3 count: the drift is tracked well
+    below one count. Updates hold for OFFSET_TRACK_HOLDOFF_MS after the
+    bridge turns off, while the phase currents decay.
+*/
+typedef struct
+{
+    bool         done;          /* Offsets valid */
+    uint32_t     sample;        /* sinc3 sample count of the last sample taken */
+    uint32_t     skip;          /* Samples still to drop */
+    uint32_t     samples;       /* Samples summed */
+    uint32_t     sumU;          /* Sums of the phase U and V samples */
+    uint32_t     sumV;
+    uint32_t     waitSamples;   /* Samples to the next tracking update */
+    float        trackU;        /* Tracked offsets, tenths of a sinc3 count */
+    float        trackV;
+    uint32_t     updates;       /* Tracking updates since power up */
+} MCAPP_OFFSET_CALIB;
+
+/* Current sense offsets and their tracking, read through X2Cscope */
+extern MCAPP_OFFSET_CALIB gOffsetCalib;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_OffsetCalibReset(uint32_t sample);
+bool MCAPP_OffsetCalibUpdate(uint32_t sample, uint32_t currentU, uint32_t currentV);
+#if(ENABLE_OFFSET_TRACKING == true)
+void MCAPP_OffsetTrackHoldoff(uint32_t sample);
+bool MCAPP_OffsetTrackDue(uint32_t sample);
+void MCAPP_OffsetTrackUpdate(int32_t currentU, int32_t currentV);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_OFFSET_CALIB_H
+
+/**
+ End of File
+*/
@@ -0,0 +1,213 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_resolver.c
+
+  Summary:
+    This file contains the resolver to digital converter.
+
+  Description:
+    This file contains the resolver excitation and sense counters, and the
+    tracking loop of the resolver angle.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_resolver.h"
+#include "mc_motor_profile.h"
+#include "math.h"
+
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_RESOLVER gResolver;
+volatile __attribute__ ((tcm)) MCAPP_RESOLVER_DEMOD gResolverDemod = {0};
+
+/* In phase and quadrature demodulation references, one entry per sinc3 sample of the carrier */
+__attribute__ ((tcm)) int32_t gResolverRefI[RESOLVER_SAMPLES_PER_CARRIER];
+__attribute__ ((tcm)) int32_t gResolverRefQ[RESOLVER_SAMPLES_PER_CARRIER];
+
+/******************************************************************************/
+/* Function name: MCAPP_ResolverInitialize                                    */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Demodulation references, TC2 channel 0 and 1 counting the     */
+/*              sine and cosine bitstreams like TC3 for the currents, and the */
+/*              excitation carrier on PWM0 channel 3.                         */
+/******************************************************************************/
+void MCAPP_ResolverInitialize(void)
+{
+    uint32_t k;
+    float phase;
+    float ref;
+    int32_t sumI = 0;
+    int32_t sumQ = 0;
+
+    for(k = 0U; k < RESOLVER_SAMPLES_PER_CARRIER; k++)
+    {
+        phase = ((2.0f * PI * (float)k) / (float)RESOLVER_SAMPLES_PER_CARRIER) + (RESOLVER_CARRIER_PHASE_DEG * PI / 180.0f);
+        ref = roundf(sinf(phase) * RESOLVER_REF_SCALE);
+        gResolverRefI[k] = (int32_t)ref;
+        ref = roundf(cosf(phase) * RESOLVER_REF_SCALE);
+        gResolverRefQ[k] = (int32_t)ref;
+        if(k < (RESOLVER_SAMPLES_PER_CARRIER - 1U))
+        {
+            sumI += gResolverRefI[k];
+            sumQ += gResolverRefQ[k];
+        }
+    }
+    /* Zero sum references: the mid scale of the sinc3 samples drops out */
+    gResolverRefI[RESOLVER_SAMPLES_PER_CARRIER - 1U] = -sumI;
+    gResolverRefQ[RESOLVER_SAMPLES_PER_CARRIER - 1U] = -sumQ;
+
+    /* Sense counters: peripheral clock, gated by XC0/XC1 (burst) */
+    PMC_REGS->PMC_PCR = PMC_PCR_EN_Msk | PMC_PCR_CMD_Msk | PMC_PCR_PID(ID_TC2_CHANNEL0);
+    PMC_REGS->PMC_PCR = PMC_PCR_EN_Msk | PMC_PCR_CMD_Msk | PMC_PCR_PID(ID_TC2_CHANNEL1);
+    TC2_REGS->TC_CHANNEL[0].TC_EMR = TC_EMR_NODIVCLK_Msk;
+    TC2_REGS->TC_CHANNEL[0].TC_CMR = TC_CMR_CAPTURE_LDRA_NONE | TC_CMR_CAPTURE_LDRB_NONE | TC_CMR_BURST_XC0;
+    TC2_REGS->TC_CHANNEL[1].TC_EMR = TC_EMR_NODIVCLK_Msk;
+    TC2_REGS->TC_CHANNEL[1].TC_CMR = TC_CMR_CAPTURE_LDRA_NONE | TC_CMR_CAPTURE_LDRB_NONE | TC_CMR_BURST_XC1;
+
+    /* Excitation: 50% square wave, outside the synchronous channels */
+    PWM0_REGS->PWM_CH_NUM[3].PWM_CMR = PWM_CMR_CPRE_MCK | PWM_CMR_CALG_CENTER_ALIGNED;
+    PWM0_REGS->PWM_CH_NUM[3].PWM_CPRD = RESOLVER_CARRIER_PERIOD_COUNT;
+    PWM0_REGS->PWM_CH_NUM[3].PWM_CDTY = RESOLVER_CARRIER_PERIOD_COUNT / 2U;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_ResolverStart                                         */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Starts the excitation and the sense counters, just before the */
+/*              sigma-delta sample timer: the carrier phase of the first      */
+/*              sinc3 sample is the same at every start.                      */
+/******************************************************************************/
+void MCAPP_ResolverStart(void)
+{
+    gResolverDemod.phase = 0U;
+    gResolverDemod.sinSum = 0;
+    gResolverDemod.cosSum = 0;
+    gResolverDemod.sinSumQ = 0;
+    gResolverDemod.cosSumQ = 0;
+    gResolver.speed = 0.0f;
+    gResolver.error = 0.0f;
+
+    TC2_REGS->TC_CHANNEL[0].TC_CCR = (TC_CCR_CLKEN_Msk | TC_CCR_SWTRG_Msk);
+    TC2_REGS->TC_CHANNEL[1].TC_CCR = (TC_CCR_CLKEN_Msk | TC_CCR_SWTRG_Msk);
+
+    /* Restart the carrier from the start of its period */
+    PWM0_ChannelsStop(PWM_CHANNEL_3_MASK);
+    PWM0_ChannelsStart(PWM_CHANNEL_3_MASK);
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_ResolverStop                                          */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Stops the excitation and the sense counters.                  */
+/******************************************************************************/
+void MCAPP_ResolverStop(void)
+{
+    PWM0_ChannelsStop(PWM_CHANNEL_3_MASK);
+    TC2_REGS->TC_CHANNEL[0].TC_CCR = (TC_CCR_CLKDIS_Msk);
+    TC2_REGS->TC_CHANNEL[1].TC_CCR = (TC_CCR_CLKDIS_Msk);
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_ResolverUpdate                                        */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Tracking loop, every fast loop. The error is the envelope     */
+/*              vector turned by the tracked angle, scaled by the amplitude   */
+/*              of the slow loop. While the signal is lost the error is zero: */
+/*              the angle coasts at the last speed.                           */
+/******************************************************************************/
+void MCAPP_ResolverUpdate(void)
+{
+    MCLIB_POSITION tracked;
+    float error;
+    float step;
+
+    tracked.angle = (float)gResolver.angleQ32 * MOTOR_ANGLE_Q32_TO_RAD;
+    MCLIB_SinCosCalc(&tracked);
+
+    /* sin(resolver - tracked) = sin(resolver)cos(tracked) - cos(resolver)sin(tracked) */
+    error = (((float)gResolverDemod.sinEnv * tracked.cosAngle)
+           - ((float)gResolverDemod.cosEnv * tracked.sineAngle)) * gResolver.invAmplitude;
+    gResolver.error = error;
+
+    gResolver.speed += error * RESOLVER_PLL_KI_TS;
+    step = (gResolver.speed + (error * RESOLVER_PLL_KP)) * (FAST_LOOP_TIME_SEC * MOTOR_RAD_TO_ANGLE_Q32);
+    gResolver.angleQ32 += (uint32_t)(int32_t)step;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_ResolverAmplitudeUpdate                               */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Envelope amplitude, signal loss and carrier phase error, in   */
+/*              the slow loop. The phase error is the angle of the quadrature */
+/*              to the in phase envelopes, the same on both channels.         */
+/******************************************************************************/
+void MCAPP_ResolverAmplitudeUpdate(void)
+{
+    float sinEnv = (float)gResolverDemod.sinEnv;
+    float cosEnv = (float)gResolverDemod.cosEnv;
+    float magnitude2;
+    float magnitude;
+
+    magnitude2 = (sinEnv * sinEnv) + (cosEnv * cosEnv);
+    magnitude = sqrtf(magnitude2);
+    gResolver.amplitude = magnitude * RESOLVER_ENVELOPE_TO_UNIT;
+    gResolver.signalLoss = (gResolver.amplitude < RESOLVER_MIN_AMPLITUDE);
+    if(gResolver.signalLoss == true)
+    {
+        gResolver.invAmplitude = 0.0f;
+    }
+    else
+    {
+        gResolver.invAmplitude = 1.0f / magnitude;
+        gResolver.carrierPhaseError = atan2f(((float)gResolverDemod.sinEnvQ * sinEnv) + ((float)gResolverDemod.cosEnvQ * cosEnv),
+                                             magnitude2);
+    }
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
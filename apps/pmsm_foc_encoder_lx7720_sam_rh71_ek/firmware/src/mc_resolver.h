@@ -0,0 +1,201 @@
+/*******************************************************************************
+ Resolver to digital converter interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_resolver.h
+
+  Summary:
+    Resolver excitation, demodulation and angle tracking
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    resolver to digital converter. The sine and cosine sense channels are
+    decimated like the phase currents by the sigma-delta count interrupt,
+    which calls the inline demodulator of this file.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_RESOLVER_H    // Guards against multiple inclusion
+#define MC_RESOLVER_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "userparams.h"
+#include "CMSIS/Core/Include/cmsis_compiler.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Resolver demodulator
+
+  Summary:
+    Synchronous demodulation of the resolver sense channels
+
+  Description:
+    Every sinc3 sample of the sine and cosine channels is multiplied by the
+    in phase and quadrature references of its place in the carrier period
+    and summed. The references sum to zero, so the sense offset drops out.
+    At the end of each carrier period the sums are the envelopes.
+
+  Remarks:
+    Written by the sigma-delta count interrupt only.
+*/
+typedef struct
+{
+    int32_t  sinSum;        /* In phase sum of the sine channel, present carrier period */
+    int32_t  cosSum;        /* In phase sum of the cosine channel */
+    int32_t  sinSumQ;       /* Quadrature sum of the sine channel */
+    int32_t  cosSumQ;       /* Quadrature sum of the cosine channel */
+    uint32_t phase;         /* Sinc3 sample within the carrier period */
+    int32_t  sinEnv;        /* Sine envelope of the last carrier period */
+    int32_t  cosEnv;        /* Cosine envelope of the last carrier period */
+    int32_t  sinEnvQ;       /* Quadrature envelopes, zero with the right carrier phase */
+    int32_t  cosEnvQ;
+} MCAPP_RESOLVER_DEMOD;
+
+/* Resolver to digital converter
+
+  Summary:
+    Angle and speed tracking of the resolver envelopes
+
+  Description:
+    Type II tracking loop: the error is sin(resolver angle - tracked angle),
+    from the envelopes and the sine/cosine of the tracked angle, normalised
+    by the envelope amplitude. The integrator is the speed estimate. The
+    angle is a binary angle so that the motor electrical angle is a plain
+    product with the pole pair ratio.
+
+  Remarks:
+    The amplitude is measured in the slow loop.
+*/
+typedef struct
+{
+    uint32_t angleQ32;          /* Tracked resolver angle, 2^32 = one resolver electrical cycle */
+    float    speed;             /* Resolver electrical speed (rad/s) */
+    float    error;             /* sin(resolver angle - tracked angle) */
+    float    amplitude;         /* Envelope amplitude, 1.0 = sense full scale */
+    float    invAmplitude;      /* Error normalisation, 0 while the signal is lost */
+    float    carrierPhaseError; /* Sensed carrier phase - RESOLVER_CARRIER_PHASE_DEG (rad) */
+    uint32_t offsetQ32;         /* Motor electrical angle at resolver angle 0 */
+    bool     signalLoss;        /* Amplitude below RESOLVER_MIN_AMPLITUDE */
+} MCAPP_RESOLVER;
+
+#if(POSITION_SENSOR == POSITION_SENSOR_RESOLVER)
+/* Resolver converter state, read through X2Cscope */
+extern MCAPP_RESOLVER gResolver;
+
+/* Demodulator and its references, used by the sigma-delta count interrupt */
+extern volatile MCAPP_RESOLVER_DEMOD gResolverDemod;
+extern int32_t gResolverRefI[RESOLVER_SAMPLES_PER_CARRIER];
+extern int32_t gResolverRefQ[RESOLVER_SAMPLES_PER_CARRIER];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_ResolverInitialize(void);
+void MCAPP_ResolverStart(void);
+void MCAPP_ResolverStop(void);
+void MCAPP_ResolverUpdate(void);
+void MCAPP_ResolverAmplitudeUpdate(void);
+
+/******************************************************************************/
+/* Function name: MCAPP_ResolverDemodulate                                    */
+/* Function parameters: sinSample - sinc3 sample of the sine channel          */
+/*                      cosSample - sinc3 sample of the cosine channel        */
+/* Function return: None                                                      */
+/* Description: Called for every sinc3 sample of the sense channels. Adds the */
+/*              samples times the references of their place in the carrier,   */
+/*              latches the envelopes at the end of each carrier period.      */
+/*              Integer only, and inline: runs in the sigma-delta count       */
+/*              interrupt, from TCM.                                          */
+/******************************************************************************/
+__STATIC_FORCEINLINE void MCAPP_ResolverDemodulate(int32_t sinSample, int32_t cosSample)
+{
+    uint32_t phase = gResolverDemod.phase;
+
+    gResolverDemod.sinSum += sinSample * gResolverRefI[phase];
+    gResolverDemod.cosSum += cosSample * gResolverRefI[phase];
+    gResolverDemod.sinSumQ += sinSample * gResolverRefQ[phase];
+    gResolverDemod.cosSumQ += cosSample * gResolverRefQ[phase];
+
+    phase++;
+    if(phase >= RESOLVER_SAMPLES_PER_CARRIER)
+    {
+        phase = 0U;
+        gResolverDemod.sinEnv = gResolverDemod.sinSum;
+        gResolverDemod.cosEnv = gResolverDemod.cosSum;
+        gResolverDemod.sinEnvQ = gResolverDemod.sinSumQ;
+        gResolverDemod.cosEnvQ = gResolverDemod.cosSumQ;
+        gResolverDemod.sinSum = 0;
+        gResolverDemod.cosSum = 0;
+        gResolverDemod.sinSumQ = 0;
+        gResolverDemod.cosSumQ = 0;
+    }
+    gResolverDemod.phase = phase;
+}
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_RESOLVER_H
+
+/**
+ End of File
+*/
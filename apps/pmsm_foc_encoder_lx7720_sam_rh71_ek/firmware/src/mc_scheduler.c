@@ -0,0 +1,235 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_scheduler.c
+
+  Summary:
+    This file contains the multi-rate scheduler.
+
+  Description:
+    This file contains the release of the medium and slow rates on the PWM
+    periods, their software interrupts and their execution statistics.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_scheduler.h"
+#include "CMSIS/Core/Include/core_cm7.h"
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static void MCAPP_RateRun(MCAPP_RATE rate);
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_RATE_STATS gRates[MCAPP_RATE_COUNT];
+
+/* Scheduler table of the application */
+static const MCAPP_RATE_CONFIG *rateConfig;
+
+/******************************************************************************/
+/* Function name: MCAPP_SchedulerInit                                         */
+/* Function parameters: config - scheduler table, MCAPP_RATE_COUNT entries    */
+/* Function return: None                                                      */
+/* Description: Sets the rate interrupt priorities from the scheduler table.  */
+/******************************************************************************/
+void MCAPP_SchedulerInit(const MCAPP_RATE_CONFIG *config)
+{
+    uint32_t rate;
+
+    rateConfig = config;
+
+    for(rate = 0U; rate < (uint32_t)MCAPP_RATE_COUNT; rate++)
+    {
+        NVIC_SetPriority(rateConfig[rate].irq, rateConfig[rate].priority);
+        gRates[rate].tick = 0U;
+        gRates[rate].pending = false;
+    }
+#if(ENABLE_RATE_INTERRUPTS == true)
+    /* Software interrupt: the timer channel behind it never runs */
+    NVIC_ClearPendingIRQ(TC3_CH2_IRQn);
+    NVIC_EnableIRQ(TC3_CH2_IRQn);
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_SchedulerSync                                         */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Restarts the periods of all rates from this fast loop period. */
+/******************************************************************************/
+void MCAPP_SchedulerSync(void)
+{
+    uint32_t rate;
+
+    for(rate = 0U; rate < (uint32_t)MCAPP_RATE_COUNT; rate++)
+    {
+        gRates[rate].tick = 0U;
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_SchedulerTick                                         */
+/* Function parameters: None                                                  */
+/* Function return: true when a released rate waits for MCAPP_SchedulerPoll   */
+/* Description: Called by the fast control loop, once per PWM period.         */
+/*              Releases each slower rate at the end of its period. A rate    */
+/*              still pending or running loses the period, counted as an      */
+/*              overrun.                                                      */
+/******************************************************************************/
+bool MCAPP_SchedulerTick(void)
+{
+    uint32_t rate;
+    bool released = false;
+
+    for(rate = (uint32_t)MCAPP_RATE_MEDIUM; rate < (uint32_t)MCAPP_RATE_COUNT; rate++)
+    {
+        gRates[rate].tick++;
+        if(gRates[rate].tick >= rateConfig[rate].period)
+        {
+            gRates[rate].tick = 0U;
+            if(gRates[rate].pending == true)
+            {
+                gRates[rate].overruns++;
+            }
+            else
+            {
+                gRates[rate].pending = true;
+#if(ENABLE_RATE_INTERRUPTS == true)
+                if(rateConfig[rate].irq == PendSV_IRQn)
+                {
+                    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+                }
+                else
+                {
+                    NVIC_SetPendingIRQ(rateConfig[rate].irq);
+                }
+#else
+                released = true;
+#endif
+            }
+        }
+    }
+    return released;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_RateRun                                               */
+/* Function parameters: rate - released rate                                  */
+/* Function return: None                                                      */
+/* Description: Runs the task of a rate and measures its execution time.      */
+/*              The rate can be released again once it is done.               */
+/******************************************************************************/
+static void MCAPP_RateRun(MCAPP_RATE rate)
+{
+    uint32_t start = DWT->CYCCNT;
+
+    rateConfig[rate].task();
+
+    MCAPP_RateStatsUpdate(rate, DWT->CYCCNT - start);
+    gRates[rate].pending = false;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_RateStatsUpdate                                       */
+/* Function parameters: rate - rate which ran, cycles - its execution time    */
+/* Function return: None                                                      */
+/* Description: Execution count, last and longest execution time of a rate.   */
+/******************************************************************************/
+void MCAPP_RateStatsUpdate(MCAPP_RATE rate, uint32_t cycles)
+{
+    gRates[rate].cycles = cycles;
+    if(cycles > gRates[rate].cyclesMax)
+    {
+        gRates[rate].cyclesMax = cycles;
+    }
+    gRates[rate].count++;
+}
+
+#if(ENABLE_RATE_INTERRUPTS == true)
+/******************************************************************************/
+/* Function name: TC3_CH2_Handler                                             */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Medium rate interrupt. TC3 channel 2 is not used, its line is */
+/*              pended by the fast loop. Replaces the weak handler of         */
+/*              interrupts.c.                                                 */
+/******************************************************************************/
+void TC3_CH2_Handler(void)
+{
+    MCAPP_RateRun(MCAPP_RATE_MEDIUM);
+}
+
+/******************************************************************************/
+/* Function name: PendSV_Handler                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Slow rate interrupt, lowest priority: preempted by all other  */
+/*              rates and the current sense. Replaces the weak handler of     */
+/*              interrupts.c.                                                 */
+/******************************************************************************/
+void PendSV_Handler(void)
+{
+    MCAPP_RateRun(MCAPP_RATE_SLOW);
+}
+#else
+/******************************************************************************/
+/* Function name: MCAPP_SchedulerPoll                                         */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Runs the released rates from the background tasks, faster     */
+/*              rates first.                                                  */
+/******************************************************************************/
+void MCAPP_SchedulerPoll(void)
+{
+    uint32_t rate;
+
+    for(rate = (uint32_t)MCAPP_RATE_MEDIUM; rate < (uint32_t)MCAPP_RATE_COUNT; rate++)
+    {
+        if(gRates[rate].pending == true)
+        {
+            MCAPP_RateRun((MCAPP_RATE)rate);
+        }
+    }
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,172 @@
+/*******************************************************************************
+ Multi-rate scheduler interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_scheduler.h
+
+  Summary:
+    Medium and slow rate tasks released by the control loop
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    multi-rate scheduler. mc_app.c owns the scheduler table and ticks the
+    scheduler from the control loop interrupt.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_SCHEDULER_H    // Guards against multiple inclusion
+#define MC_SCHEDULER_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "userparams.h"
+#include "device.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Task rates
+
+  Summary:
+    Rates of the multi-rate scheduler
+
+  Description:
+    The fast rate is the control loop interrupt itself, at the PWM
+    frequency. The medium and slow rates are released by it every
+    MEDIUM_LOOP_TIME_PWM_COUNT and SLOW_LOOP_TIME_PWM_COUNT periods. The
+    background tasks, MCAPP_Tasks and X2Cscope, run in the main loop on
+    the events of MCAPP_EventWait.
+
+  Remarks:
+    Faster rates have higher interrupt priorities and preempt the slower.
+*/
+typedef enum
+{
+    MCAPP_RATE_FAST,        /* Current loop, PWM frequency */
+    MCAPP_RATE_MEDIUM,      /* MEDIUM_LOOP_TIME_SEC */
+    MCAPP_RATE_SLOW,        /* SLOW_LOOP_TIME_SEC */
+    MCAPP_RATE_COUNT
+} MCAPP_RATE;
+
+/* Task rate configuration
+
+  Summary:
+    Scheduler table entry of a rate
+
+  Description:
+    The period is in PWM periods. Each rate below the fast one runs in a
+    software interrupt: an interrupt line with no peripheral behind it,
+    pended by the fast loop, at the given priority.
+
+  Remarks:
+    PendSV_IRQn is a valid interrupt, it is pended through the SCB.
+*/
+typedef struct
+{
+    uint32_t  period;       /* PWM periods */
+    uint32_t  priority;     /* NVIC priority, 0 is the highest */
+    IRQn_Type irq;          /* Interrupt of the rate */
+    void      (*task)(void);
+} MCAPP_RATE_CONFIG;
+
+/* Task rate statistics
+
+  Summary:
+    Execution counters and times of a rate
+
+  Description:
+    An overrun is a period at which the previous run of the rate is still
+    pending or running: that period is lost. Execution times are DWT
+    cycle counts, preemption by faster rates included.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    uint32_t      tick;         /* PWM periods since the last release */
+    volatile bool pending;      /* Released, not finished */
+    uint32_t      count;        /* Executions */
+    uint32_t      overruns;     /* Periods lost, previous run not finished */
+    uint32_t      cycles;       /* Last execution time, CPU cycles */
+    uint32_t      cyclesMax;    /* Longest execution time, CPU cycles */
+} MCAPP_RATE_STATS;
+
+/* Scheduler rate statistics, read through X2Cscope */
+extern MCAPP_RATE_STATS gRates[MCAPP_RATE_COUNT];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_SchedulerInit(const MCAPP_RATE_CONFIG *config);
+void MCAPP_SchedulerSync(void);
+bool MCAPP_SchedulerTick(void);
+void MCAPP_RateStatsUpdate(MCAPP_RATE rate, uint32_t cycles);
+#if(ENABLE_RATE_INTERRUPTS == false)
+void MCAPP_SchedulerPoll(void);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_SCHEDULER_H
+
+/**
+ End of File
+*/
@@ -0,0 +1,123 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_speed_mt.c
+
+  Summary:
+    This file contains the M/T encoder speed measurement.
+
+  Description:
+    This file contains the speed measurement on encoder edge counts and
+    edge times, at the fast loop rate.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_speed_mt.h"
+#include "mc_encoder.h"
+#include "mc_motor_profile.h"
+
+#if(ENABLE_SPEED_MT == true)
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_SPEED_MT gSpeedMT;
+
+/******************************************************************************/
+/* Function name: MCAPP_SpeedMTReset                                          */
+/* Function parameters: count - present encoder count                         */
+/* Function return: None                                                      */
+/* Description: Restarts the M/T speed measurement from standstill.           */
+/******************************************************************************/
+void MCAPP_SpeedMTReset(uint16_t count)
+{
+    gSpeedMT.tick = 0U;
+    gSpeedMT.edgeTick = 0U;
+    gSpeedMT.refTick = 0U;
+    gSpeedMT.edgeCount = count;
+    gSpeedMT.refCount = count;
+    gSpeedMT.speed = 0.0f;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_SpeedMTUpdate                                         */
+/* Function parameters: count - present encoder count                         */
+/* Function return: None                                                      */
+/* Description: M/T speed measurement, called every fast loop. The window     */
+/*              closes on the first edge after SPEED_MT_MIN_WINDOW_TICKS, so  */
+/*              both its counts and its length are exact. Without edges for   */
+/*              SPEED_MT_MAX_WINDOW_TICKS the speed is below the resolution   */
+/*              and is reported as zero.                                      */
+/******************************************************************************/
+void MCAPP_SpeedMTUpdate(uint16_t count)
+{
+    uint32_t window;
+    int32_t countDiff;
+
+    gSpeedMT.tick++;
+    if(count != gSpeedMT.edgeCount)
+    {
+        gSpeedMT.edgeCount = count;
+        gSpeedMT.edgeTick = gSpeedMT.tick;
+    }
+
+    window = gSpeedMT.edgeTick - gSpeedMT.refTick;
+    if(window >= SPEED_MT_MIN_WINDOW_TICKS)
+    {
+        countDiff = MCAPP_QDECDelta(gSpeedMT.edgeCount, gSpeedMT.refCount);
+        gSpeedMT.speed = ((float)countDiff * MOTOR_ENCODER_COUNT_PER_TICK_TO_RAD_PER_SEC_ELEC) / (float)window;
+        gSpeedMT.refCount = gSpeedMT.edgeCount;
+        gSpeedMT.refTick = gSpeedMT.edgeTick;
+    }
+    else if((gSpeedMT.tick - gSpeedMT.edgeTick) >= SPEED_MT_MAX_WINDOW_TICKS)
+    {
+        /* Standstill: restart the window on the present count */
+        gSpeedMT.speed = 0.0f;
+        gSpeedMT.refCount = gSpeedMT.edgeCount;
+        gSpeedMT.refTick = gSpeedMT.tick;
+        gSpeedMT.edgeTick = gSpeedMT.tick;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,123 @@
+/*******************************************************************************
+ M/T speed measurement interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_speed_mt.h
+
+  Summary:
+    Encoder speed from edge counts and edge times
+
+  Description:
+    This file contains the data structure and function prototypes of the
+    M/T speed measurement, run by the fast control loop of mc_app.c.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_SPEED_MT_H    // Guards against multiple inclusion
+#define MC_SPEED_MT_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include "userparams.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* M/T speed measurement
+
+  Summary:
+    Encoder speed from edge counts and edge times
+
+  Description:
+    A measurement window starts and ends on an encoder edge. Speed is the
+    number of counts of the window divided by its exact length, in fast
+    loop periods, so it has neither the +/-1 count quantization of a fixed
+    window nor its latency.
+
+  Remarks:
+    Edge times are the fast loop sample in which the count changed.
+*/
+typedef struct
+{
+    uint32_t tick;          /* Fast loop periods since reset */
+    uint32_t edgeTick;      /* Time of the last edge */
+    uint32_t refTick;       /* Time of the edge starting the window */
+    uint16_t edgeCount;     /* Encoder count at the last edge */
+    uint16_t refCount;      /* Encoder count at the edge starting the window */
+    float    speed;         /* Electrical speed (rad/s) */
+} MCAPP_SPEED_MT;
+
+#if(ENABLE_SPEED_MT == true)
+/* Last speed measurement, read through X2Cscope */
+extern MCAPP_SPEED_MT gSpeedMT;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_SpeedMTReset(uint16_t count);
+void MCAPP_SpeedMTUpdate(uint16_t count);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_SPEED_MT_H
+
+/**
+ End of File
+*/
@@ -0,0 +1,153 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_speed_ramp.c
+
+  Summary:
+    This file contains the speed ramp.
+
+  Description:
+    This file contains the linear and S-curve speed reference profiles.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_speed_ramp.h"
+#include "mc_motor_profile.h"
+#include "math.h"
+
+#if((TORQUE_MODE == false) && (POSITION_MODE == false))
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_SPEED_RAMP gSpeedRamp;
+
+/******************************************************************************/
+/* Function name: MCAPP_SpeedRampInit                                         */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Speed ramp defaults from "userparams.h".                      */
+/******************************************************************************/
+void MCAPP_SpeedRampInit(void)
+{
+    gSpeedRamp.profile = SPEED_RAMP_PROFILE;
+    gSpeedRamp.accel = MOTOR_SPEED_RAMP_ACCEL;
+    gSpeedRamp.decel = MOTOR_SPEED_RAMP_DECEL;
+    gSpeedRamp.jerk = MOTOR_SPEED_RAMP_JERK;
+    gSpeedRamp.acc = 0.0f;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_SpeedRampReset                                        */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Starts the ramp from zero acceleration, at the motor start.   */
+/******************************************************************************/
+void MCAPP_SpeedRampReset(void)
+{
+    gSpeedRamp.acc = 0.0f;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_SpeedRamp                                             */
+/* Function parameters: velRef - speed reference, endSpeed - end speed,       */
+/*                      electrical rad/s                                      */
+/* Function return: Next speed reference, electrical rad/s                    */
+/* Description: Moves the speed reference towards the end speed within the    */
+/*              acceleration and jerk limits of gSpeedRamp. The S-curve       */
+/*              brakes the acceleration once the speed error is down to what  */
+/*              the jerk limit, stepping once per speed loop, takes to bring  */
+/*              it to zero.                                                   */
+/******************************************************************************/
+float MCAPP_SpeedRampUpdate(float velRef, float endSpeed)
+{
+    float error = endSpeed - velRef;
+    float sign;
+    float limit;
+    float jerkStep;
+    float brakeAcc;
+
+    if(error > 0.0f)
+    {
+        sign = 1.0f;
+    }
+    else if(error < 0.0f)
+    {
+        sign = -1.0f;
+    }
+    else
+    {
+        /* On the end speed: the check below settles the acceleration */
+        sign = 0.0f;
+    }
+    /* Slowing down whenever the reference moves towards standstill */
+    limit = ((error * velRef) >= 0.0f) ? gSpeedRamp.accel : gSpeedRamp.decel;
+
+    if(gSpeedRamp.profile == SPEED_RAMP_SCURVE)
+    {
+        /* Largest acceleration which the jerk steps can still take back to
+           zero within the error: a^2/(2*j) + a*dt/2 <= |error| */
+        jerkStep = gSpeedRamp.jerk * SPEED_LOOP_TIME_SEC;
+        brakeAcc = sqrtf((0.25f * jerkStep * jerkStep) + (2.0f * gSpeedRamp.jerk * fabsf(error)))
+                   - (0.5f * jerkStep);
+        brakeAcc = sign * fminf(brakeAcc, limit);
+        gSpeedRamp.acc = fminf(fmaxf(brakeAcc, gSpeedRamp.acc - jerkStep), gSpeedRamp.acc + jerkStep);
+    }
+    else
+    {
+        gSpeedRamp.acc = sign * limit;
+    }
+
+    velRef += gSpeedRamp.acc * SPEED_LOOP_TIME_SEC;
+
+    /* End speed reached or passed: settle on it */
+    if(((endSpeed - velRef) * sign) <= 0.0f)
+    {
+        velRef = endSpeed;
+        gSpeedRamp.acc = 0.0f;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+    return velRef;
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,128 @@
+/*******************************************************************************
+ Speed ramp interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_speed_ramp.h
+
+  Summary:
+    Acceleration and jerk limited speed reference
+
+  Description:
+    This file contains the data structure and function prototypes of the
+    speed ramp, run by the speed loop of mc_app.c.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_SPEED_RAMP_H    // Guards against multiple inclusion
+#define MC_SPEED_RAMP_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include "userparams.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Speed ramp
+
+  Summary:
+    Acceleration and jerk limited speed reference
+
+  Description:
+    Moves the speed reference (velRef) towards the end speed once per speed
+    loop. The linear profile runs at the acceleration limit. The S-curve
+    profile changes the acceleration by at most jerk per second, and starts
+    taking it back as soon as the remaining speed error is what the jerk
+    needs to bring it to zero, so the reference lands on the end speed
+    without overshoot. Speeding up away from standstill uses accel, slowing
+    down towards it uses decel.
+
+  Remarks:
+    Profile and limits may be written at any time, through X2Cscope, and
+    are taken at the next speed loop. Limits are electrical rad/s^2 and
+    rad/s^3 and must be positive.
+*/
+typedef struct
+{
+    uint32_t profile;       /* SPEED_RAMP_LINEAR or SPEED_RAMP_SCURVE */
+    float    accel;         /* Acceleration limit away from standstill */
+    float    decel;         /* Acceleration limit towards standstill */
+    float    jerk;          /* Jerk limit of the S-curve */
+    float    acc;           /* Present acceleration of velRef, electrical rad/s^2 */
+} MCAPP_SPEED_RAMP;
+
+#if((TORQUE_MODE == false) && (POSITION_MODE == false))
+/* Speed ramp profile and limits, written through X2Cscope */
+extern MCAPP_SPEED_RAMP gSpeedRamp;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_SpeedRampInit(void);
+void MCAPP_SpeedRampReset(void);
+float MCAPP_SpeedRampUpdate(float velRef, float endSpeed);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_SPEED_RAMP_H
+
+/**
+ End of File
+*/
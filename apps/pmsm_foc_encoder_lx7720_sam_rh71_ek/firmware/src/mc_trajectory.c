@@ -0,0 +1,234 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_trajectory.c
+
+  Summary:
+    This file contains the position trajectory.
+
+  Description:
+    This file contains the seven segment S-curve trajectory followed by the
+    position loop.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mc_trajectory.h"
+#include "mc_motor_profile.h"
+#include "math.h"
+
+#if(POSITION_MODE == true)
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static void MCAPP_TrajectoryPlan(void);
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+MCAPP_TRAJECTORY gTrajectory;
+
+/* Jerk sign of the seven trajectory segments */
+static const float trajectoryJerkSign[MCAPP_TRAJECTORY_SEGMENTS] = {1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, 1.0f};
+
+/******************************************************************************/
+/* Function name: MCAPP_TrajectoryReset                                       */
+/* Function parameters: position - present multi-turn count                   */
+/* Function return: None                                                      */
+/* Description: Stops the trajectory on the present multi-turn position.      */
+/******************************************************************************/
+void MCAPP_TrajectoryReset(int32_t position)
+{
+    gTrajectory.origin = position;
+    gTrajectory.target = position;
+    gTrajectory.distance = 0.0f;
+    gTrajectory.pos = 0.0f;
+    gTrajectory.vel = 0.0f;
+    gTrajectory.acc = 0.0f;
+    gTrajectory.segmentTime = 0.0f;
+    gTrajectory.segment = MCAPP_TRAJECTORY_SEGMENTS;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_TrajectoryPlan                                        */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Plans a rest to rest move from the origin to the target. The  */
+/*              peak speed is POSITION_MAX_SPEED_RPM, or the highest speed    */
+/*              the move length allows. Moves beyond                          */
+/*              MCAPP_TRAJECTORY_MAX_MOVE counts are split, so the distance   */
+/*              stays an exact float.                                         */
+/******************************************************************************/
+static void MCAPP_TrajectoryPlan(void)
+{
+    int32_t move;
+    float distance;
+    float peakSpeed;
+
+    move = (int32_t)((uint32_t)gTrajectory.target - (uint32_t)gTrajectory.origin);
+    if(move > MCAPP_TRAJECTORY_MAX_MOVE)
+    {
+        move = MCAPP_TRAJECTORY_MAX_MOVE;
+    }
+    else if(move < -MCAPP_TRAJECTORY_MAX_MOVE)
+    {
+        move = -MCAPP_TRAJECTORY_MAX_MOVE;
+    }
+    else
+    {
+        /* No Operation*/
+    }
+    gTrajectory.distance = (float)move;
+    gTrajectory.jerk = copysignf(MOTOR_POSITION_MAX_JERK, gTrajectory.distance);
+    distance = fabsf(gTrajectory.distance);
+
+    /* Highest speed of a move of this length: jerk segments only, or with
+       constant acceleration segments once the acceleration limit is reached */
+    peakSpeed = cbrtf(0.25f * MOTOR_POSITION_MAX_JERK * distance * distance);
+    if(peakSpeed > MOTOR_POSITION_ACCEL_SPEED)
+    {
+        peakSpeed = 0.5f * MOTOR_POSITION_MAX_ACCEL
+                    * (sqrtf((MOTOR_POSITION_ACCEL_TIME * MOTOR_POSITION_ACCEL_TIME) + ((4.0f / MOTOR_POSITION_MAX_ACCEL) * distance))
+                       - MOTOR_POSITION_ACCEL_TIME);
+    }
+    peakSpeed = fminf(peakSpeed, MOTOR_POSITION_MAX_SPEED);
+
+    if(peakSpeed < MOTOR_POSITION_ACCEL_SPEED)
+    {
+        gTrajectory.jerkTime = sqrtf(peakSpeed / MOTOR_POSITION_MAX_JERK);
+        gTrajectory.accelTime = 0.0f;
+    }
+    else
+    {
+        gTrajectory.jerkTime = MOTOR_POSITION_ACCEL_TIME;
+        gTrajectory.accelTime = (peakSpeed / MOTOR_POSITION_MAX_ACCEL) - MOTOR_POSITION_ACCEL_TIME;
+    }
+    gTrajectory.peakSpeed = peakSpeed;
+    gTrajectory.brakeDistance = peakSpeed * (gTrajectory.jerkTime + (0.5f * gTrajectory.accelTime));
+    gTrajectory.segmentTime = 0.0f;
+    gTrajectory.segment = 0U;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_TrajectoryUpdate                                      */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Advances the references by one speed loop period. Each        */
+/*              segment crossed within the period is integrated exactly. The  */
+/*              constant speed segment ends on the braking distance, not on   */
+/*              time, so no time rounding adds up over long moves.            */
+/******************************************************************************/
+void MCAPP_TrajectoryUpdate(void)
+{
+    float time = SPEED_LOOP_TIME_SEC;
+    float remaining;
+    float step;
+    float jerk;
+    uint32_t segment;
+    int32_t whole;
+
+    if((gTrajectory.segment >= MCAPP_TRAJECTORY_SEGMENTS) && (gTrajectory.target != gTrajectory.origin))
+    {
+        MCAPP_TrajectoryPlan();
+    }
+
+    while((time > 0.0f) && (gTrajectory.segment < MCAPP_TRAJECTORY_SEGMENTS))
+    {
+        segment = gTrajectory.segment;
+        if(segment == 3U)
+        {
+            remaining = fmaxf(fabsf(gTrajectory.distance - gTrajectory.pos) - gTrajectory.brakeDistance, 0.0f)
+                        / gTrajectory.peakSpeed;
+        }
+        else if((segment == 1U) || (segment == 5U))
+        {
+            remaining = gTrajectory.accelTime - gTrajectory.segmentTime;
+        }
+        else
+        {
+            remaining = gTrajectory.jerkTime - gTrajectory.segmentTime;
+        }
+
+        if(remaining > time)
+        {
+            step = time;
+            gTrajectory.segmentTime += step;
+        }
+        else
+        {
+            step = fmaxf(remaining, 0.0f);
+            gTrajectory.segment++;
+            gTrajectory.segmentTime = 0.0f;
+        }
+        time -= step;
+
+        jerk = gTrajectory.jerk * trajectoryJerkSign[segment];
+        gTrajectory.pos += step * (gTrajectory.vel + (step * ((0.5f * gTrajectory.acc) + (step * (1.0f / 6.0f) * jerk))));
+        gTrajectory.vel += step * (gTrajectory.acc + (0.5f * step * jerk));
+        gTrajectory.acc += step * jerk;
+    }
+
+    if(gTrajectory.segment >= MCAPP_TRAJECTORY_SEGMENTS)
+    {
+        /* Move ended: remove the rounding of the segment integration */
+        gTrajectory.pos = gTrajectory.distance;
+        gTrajectory.vel = 0.0f;
+        gTrajectory.acc = 0.0f;
+    }
+
+    /* Whole counts of the reference go to the origin */
+    whole = (int32_t)gTrajectory.pos;
+    gTrajectory.origin = (int32_t)((uint32_t)gTrajectory.origin + (uint32_t)whole);
+    gTrajectory.pos -= (float)whole;
+    gTrajectory.distance -= (float)whole;
+}
+
+/******************************************************************************/
+/* Function name: MCAPP_PositionTargetStep                                    */
+/* Function parameters: step - target change in encoder counts                */
+/* Function return: None                                                      */
+/* Description: Moves the position target, wrap safe.                         */
+/******************************************************************************/
+void MCAPP_PositionTargetStep(int32_t step)
+{
+    gTrajectory.target = (int32_t)((uint32_t)gTrajectory.target + (uint32_t)step);
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
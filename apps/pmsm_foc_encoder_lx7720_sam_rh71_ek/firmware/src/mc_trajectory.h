@@ -0,0 +1,136 @@
+/*******************************************************************************
+ Position trajectory interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_trajectory.h
+
+  Summary:
+    Jerk limited position trajectory of the position mode
+
+  Description:
+    This file contains the data structure and function prototypes of the
+    position trajectory. The position loop of mc_app.c follows its
+    references, and feeds its acceleration forward to the torque.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_TRAJECTORY_H    // Guards against multiple inclusion
+#define MC_TRAJECTORY_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include "userparams.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Position trajectory */
+#define MCAPP_TRAJECTORY_SEGMENTS         (7U)        /* Rest to rest S-curve */
+#define MCAPP_TRAJECTORY_MAX_MOVE         (16777216)  /* Longest single move in counts, exact as float */
+
+/* Position trajectory
+
+  Summary:
+    Jerk limited point to point trajectory
+
+  Description:
+    Seven segment S-curve from rest to rest: jerk, constant acceleration,
+    jerk, constant speed, and the mirror image to stop. The references are
+    relative to a multi-turn origin which follows the reference, so single
+    precision keeps a fraction of a count at any distance.
+
+  Remarks:
+    A new target is taken once the move in progress has ended.
+*/
+typedef struct
+{
+    int32_t  target;        /* Multi-turn target count, written by the application */
+    int32_t  origin;        /* Multi-turn count the references are relative to */
+    float    distance;      /* End of the move, counts from origin */
+    float    pos;           /* Position reference, counts from origin */
+    float    vel;           /* Speed reference, counts/s */
+    float    acc;           /* Acceleration reference, counts/s^2 */
+    float    jerk;          /* Signed jerk of the move, counts/s^3 */
+    float    jerkTime;      /* Length of a jerk segment (s) */
+    float    accelTime;     /* Length of a constant acceleration segment (s) */
+    float    peakSpeed;     /* Constant speed of the move, counts/s */
+    float    brakeDistance; /* Counts needed to stop from peakSpeed */
+    float    segmentTime;   /* Time spent in the present segment (s) */
+    uint32_t segment;       /* Present segment, MCAPP_TRAJECTORY_SEGMENTS when idle */
+} MCAPP_TRAJECTORY;
+
+#if(POSITION_MODE == true)
+/* Position trajectory, the target is written through X2Cscope or the switches */
+extern MCAPP_TRAJECTORY gTrajectory;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCAPP_TrajectoryReset(int32_t position);
+void MCAPP_TrajectoryUpdate(void);
+void MCAPP_PositionTargetStep(int32_t step);
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MC_TRAJECTORY_H
+
+/**
+ End of File
+*/
@@ -49,13 +49,38 @@
 #include "definitions.h"                // SYS function prototypes
 #include "mclib_generic_float.h"
 #include "userparams.h"
-#include "X2Cscope.h"
 #include "math.h"
+
+/******************************************************************************/
+/* Defines                                                                    */
+/******************************************************************************/
+#if(SINCOS_METHOD == MCLIB_SINCOS_POLY)
+/* Minimax coefficients on [-PI/4, PI/4]: odd sine and even cosine series */
+#define SINCOS_POLY_S1      (-1.6666654611e-1f)
+#define SINCOS_POLY_S2      (8.3321608736e-3f)
+#define SINCOS_POLY_S3      (-1.9515295891e-4f)
+#define SINCOS_POLY_C1      (4.166664568298827e-2f)
+#define SINCOS_POLY_C2      (-1.388731625493765e-3f)
+#define SINCOS_POLY_C3      (2.443315711809948e-5f)
+#elif(SINCOS_METHOD == MCLIB_SINCOS_CORDIC)
+/* Binary angle: PI maps to 2^31, vector magnitude: 1.0 maps to 2^30 */
+#define CORDIC_ITERATIONS           (24U)
+#define CORDIC_ANGLE_SCALE          ((float)(2147483648.0f/(float)M_PI))
+#define CORDIC_GAIN_INV_Q30         (652032874L)    /* 2^30 / prod(sqrt(1 + 2^-2i)) */
+#define CORDIC_Q30_TO_FLOAT         ((float)(1.0f/1073741824.0f))
+#endif
+
+#if(SINCOS_BENCHMARK == true)
+#define SINCOS_BENCHMARK_POINTS     (1024U)
+#endif
+
 /******************************************************************************/
 /* Local Function Prototype                                                   */
 /******************************************************************************/
 
+#if(SVPWM_METHOD == MCLIB_SVPWM_SECTOR)
 __STATIC_INLINE void MCLIB_SVPWMTimeCalc(MCLIB_SVPWM* svm);
+#endif
 
 /******************************************************************************/
 /*                   Global Variables                                         */
@@ -72,646 +97,1273 @@ MCLIB_V_DQ              gMCLIBVoltageDQ;
 MCLIB_V_ALPHA_BETA      gMCLIBVoltageAlphaBeta;
 MCLIB_SVPWM             gMCLIBSVPWM;
 
+#if(SINCOS_METHOD == MCLIB_SINCOS_LUT)
 /******************************************************************************/
-/*                   SIN Table  256  -  0.0244rad resolution                  */
+/*      Quarter wave SIN Table  1024 + 1  -  0.0015rad resolution             */
+/*      Entry k holds sin(k * PI / (2 * SINE_TABLE_SIZE)), the last entry     */
+/*      closes the quarter wave so that interpolation never wraps.            */
 /******************************************************************************/
-static const float sineTable[TABLE_SIZE] = 
+static const __attribute__ ((tcm)) float sineTable[SINE_TABLE_SIZE + 1U] =
 // <editor-fold defaultstate="collapsed" desc="Sine Table">
 {
 0.0f,
-0.024541f,
-0.049068f,
-0.073565f,
-0.098017f,
-0.122411f,
-0.14673f,
-0.170962f,
-0.19509f,
-0.219101f,
-0.24298f,
-0.266713f,
-0.290285f,
-0.313682f,
-0.33689f,
-0.359895f,
-0.382683f,
-0.405241f,
-0.427555f,
-0.449611f,
-0.471397f,
-0.492898f,
-0.514103f,
-0.534998f,
-0.55557f,
-0.575808f,
-0.595699f,
-0.615232f,
-0.634393f,
-0.653173f,
-0.671559f,
-0.689541f,
-0.707107f,
-0.724247f,
-0.740951f,
-0.757209f,
-0.77301f,
-0.788346f,
-0.803208f,
-0.817585f,
-0.83147f,
-0.844854f,
-0.857729f,
-0.870087f,
-0.881921f,
-0.893224f,
-0.903989f,
-0.91421f,
-0.92388f,
-0.932993f,
-0.941544f,
-0.949528f,
-0.95694f,
-0.963776f,
-0.970031f,
-0.975702f,
-0.980785f,
-0.985278f,
-0.989177f,
-0.99248f,
-0.995185f,
-0.99729f,
-0.998795f,
-0.999699f,
-1.0f,
-0.999699f,
-0.998795f,
-0.99729f,
-0.995185f,
-0.99248f,
-0.989177f,
-0.985278f,
-0.980785f,
-0.975702f,
-0.970031f,
-0.963776f,
-0.95694f,
-0.949528f,
-0.941544f,
-0.932993f,
-0.92388f,
-0.91421f,
-0.903989f,
-0.893224f,
-0.881921f,
-0.870087f,
-0.857729f,
-0.844854f,
-0.83147f,
-0.817585f,
-0.803208f,
-0.788346f,
-0.77301f,
-0.757209f,
-0.740951f,
-0.724247f,
-0.707107f,
-0.689541f,
+0.00153398019f,
+0.0030679568f,
+0.004601926f,
+0.0061358846f,
+0.007669829f,
+0.0092037548f,
+0.010737659f,
+0.012271538f,
+0.0138053885f,
+0.015339206f,
+0.016872988f,
+0.01840673f,
+0.019940429f,
+0.02147408f,
+0.023007681f,
+0.024541229f,
+0.026074718f,
+0.0276081458f,
+0.0291415088f,
+0.0306748032f,
+0.032208025f,
+0.033741172f,
+0.035274239f,
+0.036807223f,
+0.03834012f,
+0.0398729276f,
+0.04140564f,
+0.04293826f,
+0.044470772f,
+0.04600318f,
+0.047535484f,
+0.0490676743f,
+0.05059975f,
+0.052131705f,
+0.053663538f,
+0.0551952443f,
+0.05672682f,
+0.058258265f,
+0.059789571f,
+0.061320736f,
+0.06285176f,
+0.06438263f,
+0.06591335f,
+0.06744392f,
+0.06897433f,
+0.070504573f,
+0.07203465f,
+0.073564564f,
+0.0750943f,
+0.076623861f,
+0.078153242f,
+0.07968244f,
+0.08121145f,
+0.08274026f,
+0.08426889f,
+0.08579731f,
+0.087325535f,
+0.08885355f,
+0.09038136f,
+0.091908956f,
+0.09343634f,
+0.0949635f,
+0.09649043f,
+0.09801714f,
+0.099543619f,
+0.10106986f,
+0.102595869f,
+0.10412163f,
+0.105647154f,
+0.10717242f,
+0.108697444f,
+0.110222207f,
+0.11174671f,
+0.11327095f,
+0.114794927f,
+0.11631863f,
+0.11784206f,
+0.119365215f,
+0.120888087f,
+0.12241068f,
+0.123932975f,
+0.12545498f,
+0.1269767f,
+0.1284981f,
+0.13001922f,
+0.13154003f,
+0.13306053f,
+0.1345807f,
+0.13610058f,
+0.13762012f,
+0.13913934f,
+0.14065824f,
+0.1421768f,
+0.14369503f,
+0.14521292f,
+0.14673047f,
+0.14824768f,
+0.149764535f,
+0.15128104f,
+0.15279719f,
+0.15431297f,
+0.1558284f,
+0.15734346f,
+0.158858143f,
+0.160372457f,
+0.1618864f,
+0.16339995f,
+0.16491312f,
+0.1664259f,
+0.16793829f,
+0.1694503f,
+0.17096189f,
+0.172473084f,
+0.17398387f,
+0.17549425f,
+0.17700422f,
+0.17851377f,
+0.1800229f,
+0.18153161f,
+0.18303989f,
+0.18454774f,
+0.18605515f,
+0.18756213f,
+0.18906866f,
+0.19057475f,
+0.1920804f,
+0.19358559f,
+0.19509032f,
+0.1965946f,
+0.1980984f,
+0.19960176f,
+0.201104635f,
+0.20260704f,
+0.20410897f,
+0.20561041f,
+0.20711138f,
+0.20861185f,
+0.21011184f,
+0.21161133f,
+0.21311032f,
+0.214608811f,
+0.2161068f,
+0.217604275f,
+0.21910124f,
+0.22059769f,
+0.22209362f,
+0.22358903f,
+0.22508391f,
+0.22657826f,
+0.22807208f,
+0.22956537f,
+0.2310581f,
+0.23255031f,
+0.23404196f,
+0.23553306f,
+0.2370236f,
+0.23851359f,
+0.24000302f,
+0.24149189f,
+0.24298018f,
+0.2444679f,
+0.24595505f,
+0.24744162f,
+0.24892761f,
+0.250413f,
+0.2518978f,
+0.25338204f,
+0.25486566f,
+0.25634868f,
+0.2578311f,
+0.25931292f,
+0.2607941f,
+0.2622747f,
+0.26375468f,
+0.26523403f,
+0.26671276f,
+0.26819086f,
+0.2696683f,
+0.27114516f,
+0.27262136f,
+0.2740969f,
+0.27557182f,
+0.27704608f,
+0.2785197f,
+0.27999264f,
+0.28146494f,
+0.28293657f,
+0.28440754f,
+0.28587783f,
+0.28734746f,
+0.28881641f,
+0.290284677f,
+0.29175226f,
+0.29321916f,
+0.29468537f,
+0.2961509f,
+0.2976157f,
+0.29907983f,
+0.30054324f,
+0.30200595f,
+0.30346795f,
+0.30492923f,
+0.3063898f,
+0.30784964f,
+0.30930876f,
+0.31076715f,
+0.3122248f,
+0.31368174f,
+0.31513793f,
+0.31659338f,
+0.3180481f,
+0.31950203f,
+0.320955232f,
+0.3224077f,
+0.32385937f,
+0.3253103f,
+0.32676045f,
+0.32820984f,
+0.32965846f,
+0.3311063f,
+0.33255337f,
+0.33399965f,
+0.33544515f,
+0.33688985f,
+0.33833377f,
+0.33977688f,
+0.341219202f,
+0.34266072f,
+0.34410143f,
+0.34554132f,
+0.34698041f,
+0.34841868f,
+0.34985613f,
+0.35129276f,
+0.35272856f,
+0.35416353f,
+0.35559766f,
+0.35703096f,
+0.3584634f,
+0.35989504f,
+0.3613258f,
+0.36275572f,
+0.3641848f,
+0.365612998f,
+0.36704035f,
+0.36846683f,
+0.36989245f,
+0.3713172f,
+0.37274107f,
+0.37416406f,
+0.37558618f,
+0.37700741f,
+0.37842775f,
+0.3798472f,
+0.38126577f,
+0.38268343f,
+0.3841002f,
+0.38551605f,
+0.386931f,
+0.388345047f,
+0.38975817f,
+0.39117038f,
+0.39258167f,
+0.39399204f,
+0.39540148f,
+0.39681f,
+0.39821756f,
+0.3996242f,
+0.401029897f,
+0.40243465f,
+0.40383846f,
+0.4052413f,
+0.4066432f,
+0.40804416f,
+0.40944415f,
+0.41084317f,
+0.41224123f,
+0.41363831f,
+0.4150344f,
+0.41642956f,
+0.4178237f,
+0.4192169f,
+0.4206091f,
+0.42200027f,
+0.42339047f,
+0.42477968f,
+0.42616789f,
+0.42755509f,
+0.42894129f,
+0.4303265f,
+0.43171066f,
+0.43309382f,
+0.43447596f,
+0.4358571f,
+0.43723717f,
+0.43861624f,
+0.43999427f,
+0.44137127f,
+0.44274723f,
+0.44412214f,
+0.44549602f,
+0.44686884f,
+0.4482406f,
+0.44961133f,
+0.450981f,
+0.452349587f,
+0.4537171f,
+0.45508359f,
+0.45644898f,
+0.4578133f,
+0.45917655f,
+0.46053871f,
+0.4618998f,
+0.4632598f,
+0.46461869f,
+0.4659765f,
+0.4673332f,
+0.46868882f,
+0.47004333f,
+0.47139674f,
+0.47274903f,
+0.4741002f,
+0.47545028f,
+0.47679923f,
+0.47814706f,
+0.47949376f,
+0.48083933f,
+0.48218377f,
+0.483527079f,
+0.48486925f,
+0.4862103f,
+0.48755016f,
+0.4888889f,
+0.49022648f,
+0.4915629f,
+0.4928982f,
+0.4942323f,
+0.49556526f,
+0.49689705f,
+0.49822767f,
+0.4995571f,
+0.50088538f,
+0.50221247f,
+0.50353838f,
+0.5048631f,
+0.50618665f,
+0.507509f,
+0.50883014f,
+0.5101501f,
+0.51146885f,
+0.5127864f,
+0.51410274f,
+0.5154179f,
+0.5167318f,
+0.518044504f,
+0.519356f,
+0.52066625f,
+0.5219753f,
+0.5232831f,
+0.52458968f,
+0.525895f,
+0.52719913f,
+0.528502f,
+0.52980362f,
+0.531104f,
+0.5324031f,
+0.533701f,
+0.53499762f,
+0.53629298f,
+0.537587076f,
+0.53887991f,
+0.54017147f,
+0.54146177f,
+0.5427508f,
+0.54403853f,
+0.545325f,
+0.5466102f,
+0.54789406f,
+0.54917666f,
+0.55045797f,
+0.55173799f,
+0.5530167f,
+0.5542941f,
+0.55557023f,
+0.556845f,
+0.5581185f,
+0.5593907f,
+0.56066158f,
+0.56193112f,
+0.56319934f,
+0.56446624f,
+0.5657318f,
+0.56699605f,
+0.56825895f,
+0.56952052f,
+0.57078075f,
+0.5720396f,
+0.57329717f,
+0.5745534f,
+0.57580819f,
+0.57706167f,
+0.578313796f,
+0.5795646f,
+0.58081396f,
+0.582062f,
+0.58330865f,
+0.58455394f,
+0.58579786f,
+0.58704039f,
+0.58828155f,
+0.5895213f,
+0.5907597f,
+0.59199669f,
+0.5932323f,
+0.5944665f,
+0.5956993f,
+0.5969307f,
+0.5981607f,
+0.5993893f,
+0.60061648f,
+0.6018422f,
+0.6030666f,
+0.60428953f,
+0.60551104f,
+0.6067311f,
+0.6079498f,
+0.60916701f,
+0.6103828f,
+0.6115972f,
+0.6128101f,
+0.61402156f,
+0.6152316f,
+0.6164402f,
+0.6176473f,
+0.618853f,
+0.6200572f,
+0.62126f,
+0.62246128f,
+0.6236611f,
+0.6248595f,
+0.6260564f,
+0.6272518f,
+0.62844577f,
+0.62963824f,
+0.6308292f,
+0.63201874f,
+0.6332068f,
+0.6343933f,
+0.63557832f,
+0.63676186f,
+0.6379439f,
+0.63912444f,
+0.6403035f,
+0.641481013f,
+0.64265703f,
+0.64383154f,
+0.6450045f,
+0.646176013f,
+0.64734597f,
+0.6485144f,
+0.6496813f,
+0.65084668f,
+0.652010531f,
+0.65317284f,
+0.6543336f,
+0.65549285f,
+0.65665055f,
+0.6578067f,
+0.6589613f,
+0.66011434f,
+0.66126584f,
+0.6624158f,
+0.66356416f,
+0.664711f,
+0.66585623f,
+0.66699992f,
+0.668142f,
+0.6692826f,
+0.67042156f,
 0.671559f,
-0.653173f,
-0.634393f,
-0.615232f,
-0.595699f,
-0.575808f,
-0.55557f,
-0.534998f,
-0.514103f,
-0.492898f,
-0.471397f,
-0.449611f,
-0.427555f,
-0.405241f,
-0.382683f,
-0.359895f,
-0.33689f,
-0.313682f,
-0.290285f,
-0.266713f,
-0.24298f,
-0.219101f,
-0.19509f,
-0.170962f,
-0.14673f,
-0.122411f,
-0.098017f,
-0.073565f,
-0.049068f,
-0.024541f,
-0.0f,
--0.024541f,
--0.049068f,
--0.073565f,
--0.098017f,
--0.122411f,
--0.14673f,
--0.170962f,
--0.19509f,
--0.219101f,
--0.24298f,
--0.266713f,
--0.290285f,
--0.313682f,
--0.33689f,
--0.359895f,
--0.382683f,
--0.405241f,
--0.427555f,
--0.449611f,
--0.471397f,
--0.492898f,
--0.514103f,
--0.534998f,
--0.55557f,
--0.575808f,
--0.595699f,
--0.615232f,
--0.634393f,
--0.653173f,
--0.671559f,
--0.689541f,
--0.707107f,
--0.724247f,
--0.740951f,
--0.757209f,
--0.77301f,
--0.788346f,
--0.803208f,
--0.817585f,
--0.83147f,
--0.844854f,
--0.857729f,
--0.870087f,
--0.881921f,
--0.893224f,
--0.903989f,
--0.91421f,
--0.92388f,
--0.932993f,
--0.941544f,
--0.949528f,
--0.95694f,
--0.963776f,
--0.970031f,
--0.975702f,
--0.980785f,
--0.985278f,
--0.989177f,
--0.99248f,
--0.995185f,
--0.99729f,
--0.998795f,
--0.999699f,
--1.0f,
--0.999699f,
--0.998795f,
--0.99729f,
--0.995185f,
--0.99248f,
--0.989177f,
--0.985278f,
--0.980785f,
--0.975702f,
--0.970031f,
--0.963776f,
--0.95694f,
--0.949528f,
--0.941544f,
--0.932993f,
--0.92388f,
--0.91421f,
--0.903989f,
--0.893224f,
--0.881921f,
--0.870087f,
--0.857729f,
--0.844854f,
--0.83147f,
--0.817585f,
--0.803208f,
--0.788346f,
--0.77301f,
--0.757209f,
--0.740951f,
--0.724247f,
--0.707107f,
--0.689541f,
--0.671559f,
--0.653173f,
--0.634393f,
--0.615232f,
--0.595699f,
--0.575808f,
--0.55557f,
--0.534998f,
--0.514103f,
--0.492898f,
--0.471397f,
--0.449611f,
--0.427555f,
--0.405241f,
--0.382683f,
--0.359895f,
--0.33689f,
--0.313682f,
--0.290285f,
--0.266713f,
--0.24298f,
--0.219101f,
--0.19509f,
--0.170962f,
--0.14673f,
--0.122411f,
--0.098017f,
--0.073565f,
--0.049068f,
--0.024541f
+0.67269477f,
+0.673829f,
+0.6749616f,
+0.6760927f,
+0.6772222f,
+0.67835004f,
+0.6794763f,
+0.680601f,
+0.6817241f,
+0.68284555f,
+0.6839654f,
+0.6850837f,
+0.6862003f,
+0.68731534f,
+0.68842875f,
+0.68954054f,
+0.6906507f,
+0.691759258f,
+0.69286617f,
+0.69397146f,
+0.6950751f,
+0.6961771f,
+0.6972775f,
+0.69837625f,
+0.6994733f,
+0.7005688f,
+0.7016626f,
+0.70275474f,
+0.70384524f,
+0.70493408f,
+0.70602126f,
+0.70710678f,
+0.7081906f,
+0.7092728f,
+0.71035335f,
+0.7114322f,
+0.7125094f,
+0.71358487f,
+0.7146587f,
+0.71573083f,
+0.7168013f,
+0.71787005f,
+0.7189371f,
+0.72000251f,
+0.7210662f,
+0.7221282f,
+0.723188489f,
+0.7242471f,
+0.72530397f,
+0.726359155f,
+0.72741263f,
+0.72846439f,
+0.7295144f,
+0.73056277f,
+0.7316094f,
+0.7326543f,
+0.7336974f,
+0.7347389f,
+0.73577859f,
+0.7368166f,
+0.7378528f,
+0.7388873f,
+0.7399201f,
+0.7409511f,
+0.74198041f,
+0.74300795f,
+0.74403374f,
+0.74505779f,
+0.7460801f,
+0.7471006f,
+0.74811938f,
+0.7491364f,
+0.75015165f,
+0.75116513f,
+0.75217685f,
+0.7531868f,
+0.754195f,
+0.7552014f,
+0.756206f,
+0.7572088f,
+0.7582099f,
+0.7592092f,
+0.7602067f,
+0.7612024f,
+0.7621963f,
+0.7631884f,
+0.76417874f,
+0.765167266f,
+0.766154f,
+0.7671389f,
+0.768122f,
+0.76910334f,
+0.77008284f,
+0.7710605f,
+0.7720364f,
+0.77301045f,
+0.7739827f,
+0.7749531f,
+0.7759217f,
+0.7768885f,
+0.7778534f,
+0.7788165f,
+0.77977779f,
+0.7807372f,
+0.7816948f,
+0.7826506f,
+0.7836045f,
+0.784556597f,
+0.78550683f,
+0.7864552f,
+0.78740175f,
+0.7883464f,
+0.78928925f,
+0.7902302f,
+0.79116933f,
+0.79210658f,
+0.79304196f,
+0.7939755f,
+0.79490713f,
+0.7958369f,
+0.7967648f,
+0.79769084f,
+0.798615f,
+0.79953727f,
+0.80045766f,
+0.80137617f,
+0.8022928f,
+0.8032075f,
+0.80412038f,
+0.80503133f,
+0.8059404f,
+0.8068476f,
+0.80775282f,
+0.80865618f,
+0.8095576f,
+0.810457198f,
+0.81135485f,
+0.8122506f,
+0.8131444f,
+0.8140363f,
+0.8149263f,
+0.81581441f,
+0.8167006f,
+0.8175848f,
+0.81846713f,
+0.8193475f,
+0.82022598f,
+0.8211025f,
+0.82197712f,
+0.8228498f,
+0.8237205f,
+0.8245893f,
+0.82545615f,
+0.82632106f,
+0.827184f,
+0.82804505f,
+0.8289041f,
+0.8297612f,
+0.8306164f,
+0.8314696f,
+0.83232087f,
+0.8331702f,
+0.8340175f,
+0.8348629f,
+0.8357063f,
+0.83654773f,
+0.8373872f,
+0.8382247f,
+0.83906024f,
+0.8398938f,
+0.84072537f,
+0.841555f,
+0.8423826f,
+0.84320824f,
+0.8440319f,
+0.8448536f,
+0.84567325f,
+0.8464909f,
+0.8473066f,
+0.84812034f,
+0.848932f,
+0.84974177f,
+0.85054948f,
+0.8513552f,
+0.8521589f,
+0.8529606f,
+0.8537603f,
+0.854558f,
+0.85535366f,
+0.85614733f,
+0.85693898f,
+0.8577286f,
+0.8585162f,
+0.8593018f,
+0.86008539f,
+0.86086694f,
+0.8616465f,
+0.86242396f,
+0.8631994f,
+0.86397286f,
+0.86474426f,
+0.8655136f,
+0.866281f,
+0.86704625f,
+0.8678095f,
+0.8685707f,
+0.86932987f,
+0.87008699f,
+0.87084206f,
+0.8715951f,
+0.87234606f,
+0.873095f,
+0.8738418f,
+0.87458665f,
+0.8753294f,
+0.8760701f,
+0.8768087f,
+0.8775453f,
+0.8782798f,
+0.8790122f,
+0.8797426f,
+0.8804709f,
+0.8811971f,
+0.8819213f,
+0.88264334f,
+0.88336334f,
+0.88408126f,
+0.8847971f,
+0.88551086f,
+0.88622253f,
+0.88693212f,
+0.88763962f,
+0.888345033f,
+0.88904836f,
+0.8897496f,
+0.89044872f,
+0.89114576f,
+0.8918407f,
+0.89253356f,
+0.8932243f,
+0.893913f,
+0.8945995f,
+0.89528392f,
+0.89596625f,
+0.8966465f,
+0.89732458f,
+0.8980006f,
+0.8986745f,
+0.89934624f,
+0.9000159f,
+0.9006834f,
+0.9013488f,
+0.90201214f,
+0.9026733f,
+0.90333237f,
+0.9039893f,
+0.9046441f,
+0.90529676f,
+0.905947298f,
+0.9065957f,
+0.907242f,
+0.9078861f,
+0.9085281f,
+0.909168f,
+0.9098057f,
+0.9104413f,
+0.91107473f,
+0.91170603f,
+0.91233518f,
+0.9129622f,
+0.91358705f,
+0.9142098f,
+0.9148303f,
+0.9154487f,
+0.916065f,
+0.9166791f,
+0.917291f,
+0.9179008f,
+0.9185084f,
+0.9191139f,
+0.91971715f,
+0.9203183f,
+0.9209172f,
+0.92151404f,
+0.92210867f,
+0.9227011f,
+0.92329142f,
+0.9238795f,
+0.9244655f,
+0.92504924f,
+0.9256308f,
+0.9262102f,
+0.9267875f,
+0.9273625f,
+0.9279354f,
+0.9285061f,
+0.9290746f,
+0.9296409f,
+0.93020502f,
+0.93076696f,
+0.9313267f,
+0.9318843f,
+0.9324396f,
+0.9329928f,
+0.9335438f,
+0.93409255f,
+0.93463913f,
+0.9351835f,
+0.9357257f,
+0.93626567f,
+0.93680344f,
+0.937339f,
+0.93787238f,
+0.93840353f,
+0.9389325f,
+0.9394592f,
+0.93998375f,
+0.94050607f,
+0.94102618f,
+0.94154407f,
+0.94205974f,
+0.9425732f,
+0.9430844f,
+0.94359346f,
+0.94410026f,
+0.9446048f,
+0.9451072f,
+0.9456073f,
+0.94610523f,
+0.9466009f,
+0.9470944f,
+0.9475856f,
+0.9480746f,
+0.94856135f,
+0.9490459f,
+0.94952818f,
+0.95000825f,
+0.95048607f,
+0.95096167f,
+0.951435f,
+0.95190614f,
+0.952375f,
+0.95284165f,
+0.953306f,
+0.9537682f,
+0.9542281f,
+0.95468575f,
+0.9551412f,
+0.955594334f,
+0.95604525f,
+0.9564939f,
+0.95694034f,
+0.9573845f,
+0.95782641f,
+0.9582661f,
+0.95870347f,
+0.95913862f,
+0.959571513f,
+0.9600021f,
+0.9604305f,
+0.9608566f,
+0.96128049f,
+0.961702077f,
+0.9621214f,
+0.9625385f,
+0.96295327f,
+0.9633658f,
+0.96377607f,
+0.96418406f,
+0.9645898f,
+0.96499325f,
+0.96539444f,
+0.9657934f,
+0.96619f,
+0.9665844f,
+0.96697647f,
+0.9673663f,
+0.9677538f,
+0.9681391f,
+0.9685221f,
+0.9689028f,
+0.96928124f,
+0.96965739f,
+0.97003125f,
+0.97040284f,
+0.97077214f,
+0.97113916f,
+0.9715039f,
+0.9718663f,
+0.9722265f,
+0.97258437f,
+0.97293995f,
+0.97329325f,
+0.97364425f,
+0.97399296f,
+0.97433938f,
+0.9746835f,
+0.97502535f,
+0.97536489f,
+0.9757021f,
+0.9760371f,
+0.97636973f,
+0.97670009f,
+0.97702814f,
+0.9773539f,
+0.97767736f,
+0.9779985f,
+0.9783174f,
+0.97863392f,
+0.9789482f,
+0.97926012f,
+0.9795698f,
+0.9798771f,
+0.9801821f,
+0.98048486f,
+0.98078528f,
+0.9810834f,
+0.9813792f,
+0.9816727f,
+0.9819639f,
+0.9822527f,
+0.9825393f,
+0.98282355f,
+0.9831055f,
+0.9833851f,
+0.9836624f,
+0.983937413f,
+0.9842101f,
+0.98448046f,
+0.9847485f,
+0.985014231f,
+0.98527764f,
+0.9855387f,
+0.9857975f,
+0.98605396f,
+0.9863081f,
+0.9865599f,
+0.9868094f,
+0.98705657f,
+0.9873014f,
+0.98754394f,
+0.98778414f,
+0.988022f,
+0.9882576f,
+0.9884908f,
+0.98872169f,
+0.98895026f,
+0.9891765f,
+0.98940043f,
+0.989622f,
+0.9898413f,
+0.9900582f,
+0.9902728f,
+0.9904851f,
+0.990695f,
+0.99090264f,
+0.991107914f,
+0.99131086f,
+0.99151147f,
+0.99170975f,
+0.9919057f,
+0.9920993f,
+0.9922906f,
+0.992479535f,
+0.9926661f,
+0.9928504f,
+0.99303235f,
+0.9932119f,
+0.9933892f,
+0.9935641f,
+0.99373672f,
+0.993907f,
+0.9940749f,
+0.99424045f,
+0.99440368f,
+0.9945646f,
+0.99472312f,
+0.9948793f,
+0.9950332f,
+0.9951847f,
+0.9953339f,
+0.9954808f,
+0.99562526f,
+0.9957674f,
+0.99590723f,
+0.9960447f,
+0.9961798f,
+0.9963126f,
+0.99644305f,
+0.9965711f,
+0.9966969f,
+0.9968203f,
+0.996941358f,
+0.99706007f,
+0.9971764f,
+0.99729046f,
+0.99740213f,
+0.99751146f,
+0.99761844f,
+0.99772307f,
+0.99782535f,
+0.9979253f,
+0.99802287f,
+0.9981181f,
+0.998211f,
+0.99830154f,
+0.9983897f,
+0.99847558f,
+0.99855907f,
+0.99864022f,
+0.99871901f,
+0.99879546f,
+0.99886955f,
+0.9989413f,
+0.9990107f,
+0.99907773f,
+0.9991424f,
+0.99920476f,
+0.99926475f,
+0.99932238f,
+0.99937767f,
+0.9994306f,
+0.9994812f,
+0.9995294f,
+0.9995753f,
+0.9996188f,
+0.99966f,
+0.9996988f,
+0.9997353f,
+0.9997694f,
+0.99980117f,
+0.9998306f,
+0.99985764f,
+0.99988235f,
+0.9999047f,
+0.9999247f,
+0.99994235f,
+0.9999576f,
+0.9999706f,
+0.99998118f,
+0.9999894f,
+0.9999953f,
+0.9999988f,
+1.0f
 };
 // </editor-fold>
-static const float cosineTable[TABLE_SIZE] = 
-// <editor-fold defaultstate="collapsed" desc="Cosine Table">
+#elif(SINCOS_METHOD == MCLIB_SINCOS_CORDIC)
+/******************************************************************************/
+/*      CORDIC rotation angles atan(2^-i) as binary angle (PI = 2^31)         */
+/******************************************************************************/
+static const __attribute__ ((tcm)) int32_t cordicAtanTable[CORDIC_ITERATIONS] =
 {
-1.0f,
-0.999699f,
-0.998795f,
-0.99729f,
-0.995185f,
-0.99248f,
-0.989177f,
-0.985278f,
-0.980785f,
-0.975702f,
-0.970031f,
-0.963776f,
-0.95694f,
-0.949528f,
-0.941544f,
-0.932993f,
-0.92388f,
-0.91421f,
-0.903989f,
-0.893224f,
-0.881921f,
-0.870087f,
-0.857729f,
-0.844854f,
-0.83147f,
-0.817585f,
-0.803208f,
-0.788346f,
-0.77301f,
-0.757209f,
-0.740951f,
-0.724247f,
-0.707107f,
-0.689541f,
-0.671559f,
-0.653173f,
-0.634393f,
-0.615232f,
-0.595699f,
-0.575808f,
-0.55557f,
-0.534998f,
-0.514103f,
-0.492898f,
-0.471397f,
-0.449611f,
-0.427555f,
-0.405241f,
-0.382683f,
-0.359895f,
-0.33689f,
-0.313682f,
-0.290285f,
-0.266713f,
-0.24298f,
-0.219101f,
-0.19509f,
-0.170962f,
-0.14673f,
-0.122411f,
-0.098017f,
-0.073565f,
-0.049068f,
-0.024541f,
-0.0f,
--0.024541f,
--0.049068f,
--0.073565f,
--0.098017f,
--0.122411f,
--0.14673f,
--0.170962f,
--0.19509f,
--0.219101f,
--0.24298f,
--0.266713f,
--0.290285f,
--0.313682f,
--0.33689f,
--0.359895f,
--0.382683f,
--0.405241f,
--0.427555f,
--0.449611f,
--0.471397f,
--0.492898f,
--0.514103f,
--0.534998f,
--0.55557f,
--0.575808f,
--0.595699f,
--0.615232f,
--0.634393f,
--0.653173f,
--0.671559f,
--0.689541f,
--0.707107f,
--0.724247f,
--0.740951f,
--0.757209f,
--0.77301f,
--0.788346f,
--0.803208f,
--0.817585f,
--0.83147f,
--0.844854f,
--0.857729f,
--0.870087f,
--0.881921f,
--0.893224f,
--0.903989f,
--0.91421f,
--0.92388f,
--0.932993f,
--0.941544f,
--0.949528f,
--0.95694f,
--0.963776f,
--0.970031f,
--0.975702f,
--0.980785f,
--0.985278f,
--0.989177f,
--0.99248f,
--0.995185f,
--0.99729f,
--0.998795f,
--0.999699f,
--1.0f,
--0.999699f,
--0.998795f,
--0.99729f,
--0.995185f,
--0.99248f,
--0.989177f,
--0.985278f,
--0.980785f,
--0.975702f,
--0.970031f,
--0.963776f,
--0.95694f,
--0.949528f,
--0.941544f,
--0.932993f,
--0.92388f,
--0.91421f,
--0.903989f,
--0.893224f,
--0.881921f,
--0.870087f,
--0.857729f,
--0.844854f,
--0.83147f,
--0.817585f,
--0.803208f,
--0.788346f,
--0.77301f,
--0.757209f,
--0.740951f,
--0.724247f,
--0.707107f,
--0.689541f,
--0.671559f,
--0.653173f,
--0.634393f,
--0.615232f,
--0.595699f,
--0.575808f,
--0.55557f,
--0.534998f,
--0.514103f,
--0.492898f,
--0.471397f,
--0.449611f,
--0.427555f,
--0.405241f,
--0.382683f,
--0.359895f,
--0.33689f,
--0.313682f,
--0.290285f,
--0.266713f,
--0.24298f,
--0.219101f,
--0.19509f,
--0.170962f,
--0.14673f,
--0.122411f,
--0.098017f,
--0.073565f,
--0.049068f,
--0.024541f,
-0.0f,
-0.024541f,
-0.049068f,
-0.073565f,
-0.098017f,
-0.122411f,
-0.14673f,
-0.170962f,
-0.19509f,
-0.219101f,
-0.24298f,
-0.266713f,
-0.290285f,
-0.313682f,
-0.33689f,
-0.359895f,
-0.382683f,
-0.405241f,
-0.427555f,
-0.449611f,
-0.471397f,
-0.492898f,
-0.514103f,
-0.534998f,
-0.55557f,
-0.575808f,
-0.595699f,
-0.615232f,
-0.634393f,
-0.653173f,
-0.671559f,
-0.689541f,
-0.707107f,
-0.724247f,
-0.740951f,
-0.757209f,
-0.77301f,
-0.788346f,
-0.803208f,
-0.817585f,
-0.83147f,
-0.844854f,
-0.857729f,
-0.870087f,
-0.881921f,
-0.893224f,
-0.903989f,
-0.91421f,
-0.92388f,
-0.932993f,
-0.941544f,
-0.949528f,
-0.95694f,
-0.963776f,
-0.970031f,
-0.975702f,
-0.980785f,
-0.985278f,
-0.989177f,
-0.99248f,
-0.995185f,
-0.99729f,
-0.998795f,
-0.999699f
+    536870912L, 316933406L, 167458907L, 85004756L,
+    42667331L,  21354465L,  10679838L,  5340245L,
+    2670163L,   1335087L,   667544L,    333772L,
+    166886L,    83443L,     41722L,     20861L,
+    10430L,     5215L,      2608L,      1304L,
+    652L,       326L,       163L,       81L
 };
-// </editor-fold>
+#endif
 
+#if(SINCOS_METHOD == MCLIB_SINCOS_LUT)
 /******************************************************************************/
-/* Function name: MCLIB_ClarkeTransform                                                      */
+/* Function name: MCLIB_SinCosCalc                                                      */
 /* Function parameters: None                                                  */
 /* Function return: None                                                      */
-/* Description: Clarke Transformation                                         */
+/* Description: Calculates the sin and cosine of angle based upon             */
+/*              interpolation technique from the quarter wave table.          */
 /******************************************************************************/
- void MCLIB_ClarkeTransform(MCLIB_I_ABC* input, MCLIB_I_ALPHA_BETA* output)
+ void MCLIB_SinCosCalc(MCLIB_POSITION* position )
 {
-    output->iAlpha = input->ia;
-    output->iBeta = (input->ia * ONE_BY_SQRT3) + (input->ib * TWO_BY_SQRT3);
-}
+    /* IMPORTANT:
+       DO NOT PASS "SincosParm.angle" > 2*PI or < 0. There is no software check
+
+       The angle is scaled once to table steps; the integer part selects the
+       quadrant and the table entry, the fractional part is the interpolation
+       weight. In each quadrant sine and cosine are either the rising
+       (sin(x)) or the falling (cos(x)) side of the quarter wave:
+       y = y0 + (y1 - y0)*frac */
+
+    uint32_t index;
+    uint32_t quadrant;
+    float x, frac, rise, fall;
+
+    x = position->angle * SINE_TABLE_INDEX_SCALE;
+    index = (uint32_t)x;
+    frac = x - (float)index;
 
+    quadrant = (index >> SINE_TABLE_SHIFT) & 0x3U;
+    index &= (SINE_TABLE_SIZE - 1U);
+
+    /* Rising side sin(x) and falling side cos(x) of the first quadrant */
+    rise = sineTable[index] + ((sineTable[index + 1U] - sineTable[index]) * frac);
+    fall = sineTable[SINE_TABLE_SIZE - index]
+         + ((sineTable[SINE_TABLE_SIZE - index - 1U] - sineTable[SINE_TABLE_SIZE - index]) * frac);
+
+    switch(quadrant)
+    {
+        case 0U:
+            position->sineAngle = rise;
+            position->cosAngle  = fall;
+            break;
+        case 1U:
+            position->sineAngle = fall;
+            position->cosAngle  = -rise;
+            break;
+        case 2U:
+            position->sineAngle = -rise;
+            position->cosAngle  = -fall;
+            break;
+        default:
+            position->sineAngle = -fall;
+            position->cosAngle  = rise;
+            break;
+    }
+}
+#else
 /******************************************************************************/
-/* Function name: MCLIB_ParkTransform                                                        */
-/* Function parameters: None                                                  */
+/* Function name: MCLIB_SinCosQuadrant                                        */
+/* Function parameters: position, quadrant, sine and cosine of the reduced    */
+/*                      angle                                                 */
 /* Function return: None                                                      */
-/* Description: Park Transformation.                                          */
+/* Description: Maps sine and cosine of the angle reduced to [-PI/4, PI/4]    */
+/*              back to the quadrant of the original angle.                   */
 /******************************************************************************/
- void MCLIB_ParkTransform(MCLIB_I_ALPHA_BETA* input, MCLIB_POSITION* position, MCLIB_I_DQ* output)
+__STATIC_INLINE void MCLIB_SinCosQuadrant(MCLIB_POSITION* position, uint32_t quadrant, float sinR, float cosR)
 {
-    output->id =  gMCLIBCurrentAlphaBeta.iAlpha * position->cosAngle
-                        + gMCLIBCurrentAlphaBeta.iBeta * position->sineAngle;
-  	output->iq = -gMCLIBCurrentAlphaBeta.iAlpha * position->sineAngle
-                        + gMCLIBCurrentAlphaBeta.iBeta * position->cosAngle;
+    switch(quadrant & 0x3U)
+    {
+        case 0U:
+            position->sineAngle = sinR;
+            position->cosAngle  = cosR;
+            break;
+        case 1U:
+            position->sineAngle = cosR;
+            position->cosAngle  = -sinR;
+            break;
+        case 2U:
+            position->sineAngle = -sinR;
+            position->cosAngle  = -cosR;
+            break;
+        default:
+            position->sineAngle = -cosR;
+            position->cosAngle  = sinR;
+            break;
+    }
 }
 
+#if(SINCOS_METHOD == MCLIB_SINCOS_POLY)
 /******************************************************************************/
-/* Function name: MCLIB_InvParkTransform                                                     */
+/* Function name: MCLIB_SinCosCalc                                            */
 /* Function parameters: None                                                  */
 /* Function return: None                                                      */
-/* Description: Inverse Park Transformation.                                  */
+/* Description: Calculates the sin and cosine of angle with minimax           */
+/*              polynomials. The angle is reduced to [-PI/4, PI/4] and both   */
+/*              series are evaluated with fused multiply-add.                 */
 /******************************************************************************/
-void MCLIB_InvParkTransform(MCLIB_V_DQ* input, MCLIB_POSITION* position, MCLIB_V_ALPHA_BETA* output)
+ void MCLIB_SinCosCalc(MCLIB_POSITION* position )
 {
-    output->vAlpha =  input->vd * position->cosAngle - input->vq * position->sineAngle;
-    output->vBeta  =  input->vd * position->sineAngle + input->vq * position->cosAngle;
-}
+    /* IMPORTANT:
+       DO NOT PASS "SincosParm.angle" > 2*PI or < 0. There is no software check */
+
+    uint32_t quadrant;
+    float r, r2, sinR, cosR;
+
+    quadrant = (uint32_t)((position->angle * SINCOS_QUADRANT_SCALE) + 0.5f);
+    r = fmaf(-(float)quadrant, SINCOS_QUADRANT_ANGLE, position->angle);
+    r2 = r * r;
+
+    /* sin(r) = r + r^3 * (S1 + r^2 * (S2 + r^2 * S3)) */
+    sinR = fmaf(r2, SINCOS_POLY_S3, SINCOS_POLY_S2);
+    sinR = fmaf(r2, sinR, SINCOS_POLY_S1);
+    sinR = fmaf(r2 * r, sinR, r);
+
+    /* cos(r) = 1 - r^2/2 + r^4 * (C1 + r^2 * (C2 + r^2 * C3)) */
+    cosR = fmaf(r2, SINCOS_POLY_C3, SINCOS_POLY_C2);
+    cosR = fmaf(r2, cosR, SINCOS_POLY_C1);
+    cosR = fmaf(r2 * r2, cosR, fmaf(-0.5f, r2, 1.0f));
 
+    MCLIB_SinCosQuadrant(position, quadrant, sinR, cosR);
+}
+#elif(SINCOS_METHOD == MCLIB_SINCOS_CORDIC)
 /******************************************************************************/
-/* Function name: MCLIB_SinCosCalc                                                      */
+/* Function name: MCLIB_SinCosCalc                                            */
 /* Function parameters: None                                                  */
 /* Function return: None                                                      */
-/* Description: Calculates the sin and cosine of angle based upon             */
-/*              interpolation technique from the table.                       */
+/* Description: Calculates the sin and cosine of angle with a fixed number    */
+/*              of CORDIC rotations. The angle is reduced to [-PI/4, PI/4];   */
+/*              the rotation direction is applied with sign masks so that     */
+/*              every call executes the same instructions.                    */
 /******************************************************************************/
  void MCLIB_SinCosCalc(MCLIB_POSITION* position )
 {
     /* IMPORTANT:
-       DO NOT PASS "SincosParm.angle" > 2*PI. There is no software check
-
-       Since we are using "float", it is not possible to get an index of array
-       directly. Almost every time, we will need to do interpolation, as per
-       following equation: -
-       y = y0 + (y1 - y0)*((x - x0)/(x1 - x0)) */
+       DO NOT PASS "SincosParm.angle" > 2*PI or < 0. There is no software check */
 
-    uint32_t y0_Index;
-    uint32_t y0_IndexNext;
-    float x0, x1, y0, y1, temp;
+    uint32_t quadrant;
+    uint32_t i;
+    int32_t x, y, z, dx, dy, da, sign;
 
-    y0_Index = (uint32_t)((float)(position->angle / ANGLE_STEP));
-    y0_IndexNext = y0_Index + 1U;
+    quadrant = (uint32_t)((position->angle * SINCOS_QUADRANT_SCALE) + 0.5f);
+    z = (int32_t)(fmaf(-(float)quadrant, SINCOS_QUADRANT_ANGLE, position->angle) * CORDIC_ANGLE_SCALE);
 
-    if(y0_IndexNext >= TABLE_SIZE )
+    x = CORDIC_GAIN_INV_Q30;
+    y = 0;
+    for(i = 0U; i < CORDIC_ITERATIONS; i++)
     {
-        y0_IndexNext = 0U;
-        x1 = TOTAL_SINE_TABLE_ANGLE;
-    }
-    else
-    {
-        x1 = (((float)y0_IndexNext) * (ANGLE_STEP));
+        /* sign is 0 for z >= 0 (rotate forward) and -1 for z < 0 (rotate back) */
+        sign = z >> 31;
+        dx = ((y >> i) ^ sign) - sign;
+        dy = ((x >> i) ^ sign) - sign;
+        da = (cordicAtanTable[i] ^ sign) - sign;
+        x -= dx;
+        y += dy;
+        z -= da;
     }
 
-    x0 = ((float)y0_Index * ANGLE_STEP);
-
-    /* Since below calculation is same for sin & cosine, we can do it once and reuse. */
-    temp = ((position->angle - x0) / (x1 - x0));
-    /*==============  Find Sine now  =============================================*/
-    y0 = sineTable[y0_Index];
-    y1 = sineTable[y0_IndexNext];
-    position->sineAngle = y0 + ((y1 - y0) * temp);
-   /*==============  Find Cosine now  =============================================*/
-    y0 = cosineTable[y0_Index];
-    y1 = cosineTable[y0_IndexNext];
-    position->cosAngle = y0 + ((y1 - y0) * temp);
+    MCLIB_SinCosQuadrant(position, quadrant, (float)y * CORDIC_Q30_TO_FLOAT, (float)x * CORDIC_Q30_TO_FLOAT);
 }
+#else
+#error "SINCOS_METHOD must be MCLIB_SINCOS_LUT, MCLIB_SINCOS_POLY or MCLIB_SINCOS_CORDIC"
+#endif
+#endif
 
+#if(SINCOS_BENCHMARK == true)
 /******************************************************************************/
-/* Function name: MCLIB_PIControl                                                   */
-/* Function parameters: pParm - PI parameter structure                                                  */
+/* Function name: MCLIB_SinCosBenchmark                                       */
+/* Function parameters: result - benchmark results                            */
 /* Function return: None                                                      */
-/* Description:                                                               */
-/* Execute PI control                                                         */
+/* Description: Times MCLIB_SinCosCalc with the DWT cycle counter over a      */
+/*              sweep of the full circle and measures its worst error against */
+/*              the C library. Cycle counts include the call overhead. The    */
+/*              caller starts the DWT cycle counter.                          */
 /******************************************************************************/
- void MCLIB_PIControl( MCLIB_PI *pParm)
+void MCLIB_SinCosBenchmark( MCLIB_SINCOS_BENCHMARK* result )
 {
-	float Err;
-	float Out;
-	float Exc;
-
-	Err  = pParm->inRef - pParm->inMeas;
-	Out  = pParm->dSum + pParm->kp * Err;
-
-	/* Limit checking for PI output */
-	if( Out > pParm->outMax ){
-        pParm->out = pParm->outMax;}
-	else if( Out < pParm->outMin ){
-        pParm->out = pParm->outMin;}
-	else{
-        pParm->out = Out;}
-
-	Exc = Out - pParm->out;
-	pParm->dSum = pParm->dSum + pParm->ki * Err - pParm->kc * Exc;
+    MCLIB_POSITION position;
+    uint32_t i;
+    uint32_t start;
+    uint32_t cycles;
+    uint32_t cyclesTotal = 0U;
+    float error;
+
+    result->cyclesMin = 0xFFFFFFFFU;
+    result->cyclesMax = 0U;
+    result->maxError = 0.0f;
+
+    for(i = 0U; i < SINCOS_BENCHMARK_POINTS; i++)
+    {
+        position.angle = (float)i * (TOTAL_SINE_TABLE_ANGLE / (float)SINCOS_BENCHMARK_POINTS);
+
+        start = DWT->CYCCNT;
+        MCLIB_SinCosCalc(&position);
+        cycles = DWT->CYCCNT - start;
+
+        cyclesTotal += cycles;
+        if(cycles < result->cyclesMin)
+        {
+            result->cyclesMin = cycles;
+        }
+        if(cycles > result->cyclesMax)
+        {
+            result->cyclesMax = cycles;
+        }
+
+        error = fmaxf(fabsf(position.sineAngle - sinf(position.angle)),
+                      fabsf(position.cosAngle - cosf(position.angle)));
+        if(error > result->maxError)
+        {
+            result->maxError = error;
+        }
+    }
+    result->cyclesAvg = cyclesTotal / SINCOS_BENCHMARK_POINTS;
 }
+#endif
 
+#if(SVPWM_METHOD == MCLIB_SVPWM_SECTOR)
 /******************************************************************************/
 /* Function name: MCLIB_SVPWMTimeCalc                                                   */
 /* Function parameters: None                                                  */
@@ -720,9 +1372,9 @@ void MCLIB_InvParkTransform(MCLIB_V_DQ* input, MCLIB_POSITION* position, MCLIB_V
 /******************************************************************************/
 __STATIC_INLINE void MCLIB_SVPWMTimeCalc(MCLIB_SVPWM* svm)
 {
-    svm->t1 = (gMCLIBSVPWM.period) * svm->t1;
-    svm->t2 = (gMCLIBSVPWM.period) * svm->t2;
-    svm->t_c = (gMCLIBSVPWM.period - svm->t1 - svm->t2)/2.0f;
+    svm->t1 = svm->period * svm->t1;
+    svm->t2 = svm->period * svm->t2;
+    svm->t_c = (svm->period - svm->t1 - svm->t2) * 0.5f;
     svm->t_b = svm->t_c + svm->t2;
     svm->t_a = svm->t_b + svm->t1;
 }
@@ -734,11 +1386,11 @@ __STATIC_INLINE void MCLIB_SVPWMTimeCalc(MCLIB_SVPWM* svm)
 /* Description: Determines sector based upon three reference vectors amplitude*/
 /*              and updates duty.                                             */
 /******************************************************************************/
- void MCLIB_SVPWMGen( MCLIB_V_ALPHA_BETA* vAlphaBeta, MCLIB_SVPWM* svm )
+ void MCLIB_SVPWMGen( const MCLIB_V_ALPHA_BETA* restrict vAlphaBeta, MCLIB_SVPWM* restrict svm )
 {
     svm->vr1 = vAlphaBeta->vBeta;
-    svm->vr2 = (-vAlphaBeta->vBeta/2.0f + SQRT3_BY2 * vAlphaBeta->vAlpha);
-    svm->vr3 = (-vAlphaBeta->vBeta/2.0f - SQRT3_BY2 * vAlphaBeta->vAlpha);
+    svm->vr2 = (-vAlphaBeta->vBeta * 0.5f + SQRT3_BY2 * vAlphaBeta->vAlpha);
+    svm->vr3 = (-vAlphaBeta->vBeta * 0.5f - SQRT3_BY2 * vAlphaBeta->vAlpha);
 
 	if( svm->vr1 >= 0.0f )
 	{
@@ -822,6 +1474,51 @@ __STATIC_INLINE void MCLIB_SVPWMTimeCalc(MCLIB_SVPWM* svm)
 		}
 	}
 }
+#elif(SVPWM_METHOD == MCLIB_SVPWM_MINMAX)
+/******************************************************************************/
+/* Function name: MCLIB_SVPWMGen                                              */
+/* Function parameters: vAlphaBeta - alpha/beta voltage reference in %,       */
+/*                      svm - SVPWM structure, period in timer counts         */
+/* Function return: None                                                      */
+/* Description: Space vector modulation by common mode injection. The inverse */
+/*              Clarke phase voltages are shifted by -(max + min)/2, which    */
+/*              gives the same duties as the six sector tree. Min/max map to  */
+/*              VMINNM/VMAXNM, so execution time does not depend on the       */
+/*              voltage vector. Only dPWM1..3 are written.                    */
+/******************************************************************************/
+ void MCLIB_SVPWMGen( const MCLIB_V_ALPHA_BETA* restrict vAlphaBeta, MCLIB_SVPWM* restrict svm )
+{
+    float scale;
+    float va;
+    float vb;
+    float vc;
+    float vMax;
+    float vMin;
+    float offset;
+    float duty;
+
+    /* Inverse Clarke, scaled to timer counts */
+    scale = svm->period * ONE_BY_SQRT3;
+    va = vAlphaBeta->vAlpha * scale;
+    vb = ((-0.5f * vAlphaBeta->vAlpha) + (SQRT3_BY2 * vAlphaBeta->vBeta)) * scale;
+    vc = ((-0.5f * vAlphaBeta->vAlpha) - (SQRT3_BY2 * vAlphaBeta->vBeta)) * scale;
+
+    /* Common mode injection: centre the phase voltages in the PWM period */
+    vMax = fmaxf(fmaxf(va, vb), vc);
+    vMin = fminf(fminf(va, vb), vc);
+    offset = 0.5f * (svm->period - vMax - vMin);
+
+    /* Over modulation can give negative duties; limit them to zero */
+    duty = fmaxf(va + offset, 0.0f);
+    svm->dPWM1 = (uint32_t)duty;
+    duty = fmaxf(vb + offset, 0.0f);
+    svm->dPWM2 = (uint32_t)duty;
+    duty = fmaxf(vc + offset, 0.0f);
+    svm->dPWM3 = (uint32_t)duty;
+}
+#else
+#error "SVPWM_METHOD: unknown SVPWM implementation"
+#endif
 
 
 /*******************************************************************************
@@ -54,6 +54,7 @@
 */
 
 #include <stddef.h>
+#include <stdint.h>
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
@@ -84,8 +85,21 @@ extern "C" {
 #define ANGLE_OFFSET_MIN          ((float)(M_PI_2)/(float)(32767))
 
 #define TOTAL_SINE_TABLE_ANGLE      (float)(2.0f*(float)M_PI)
-#define ANGLE_STEP                  (TOTAL_SINE_TABLE_ANGLE/(float)TABLE_SIZE)
-#define TABLE_SIZE  256U
+#define SINE_TABLE_SHIFT            (10U)
+#define SINE_TABLE_SIZE             (1UL << SINE_TABLE_SHIFT)  /* Entries per quarter wave */
+#define SINE_TABLE_INDEX_SCALE      ((float)(4UL * SINE_TABLE_SIZE) / TOTAL_SINE_TABLE_ANGLE)
+
+/* Sine/cosine implementations, selected by SINCOS_METHOD in "userparams.h" */
+#define MCLIB_SINCOS_LUT            (0U)    /* Interpolated quarter wave table */
+#define MCLIB_SINCOS_POLY           (1U)    /* Minimax polynomial evaluated with FMA */
+#define MCLIB_SINCOS_CORDIC         (2U)    /* Fixed iteration fixed point CORDIC */
+
+/* SVPWM implementations, selected by SVPWM_METHOD in "userparams.h" */
+#define MCLIB_SVPWM_SECTOR          (0U)    /* Six sector decision tree */
+#define MCLIB_SVPWM_MINMAX          (1U)    /* Branch free min/max common mode injection */
+
+#define SINCOS_QUADRANT_SCALE       ((float)(2.0f/(float)M_PI))
+#define SINCOS_QUADRANT_ANGLE       ((float)((float)M_PI/2.0f))
 
 
 
@@ -164,6 +178,14 @@ typedef struct
     uint32_t dPWM3;
 } MCLIB_SVPWM;
 
+typedef struct
+{
+    uint32_t cyclesMin;     /* Fastest call, in CPU cycles */
+    uint32_t cyclesMax;     /* Slowest call, in CPU cycles */
+    uint32_t cyclesAvg;     /* Average over all calls, in CPU cycles */
+    float    maxError;      /* Max sine/cosine error against the C library */
+} MCLIB_SINCOS_BENCHMARK;
+
 extern MCLIB_PI     gPIParmQ;        /* Iq PI controllers */
 extern MCLIB_PI     gPIParmD;        /* Id PI controllers */
 extern MCLIB_PI     gPIParmQref;     /* Speed PI controllers */
@@ -181,12 +203,84 @@ extern MCLIB_SVPWM gMCLIBSVPWM;
 // Section: Interface Routines
 // *****************************************************************************
 // *****************************************************************************
- void MCLIB_ClarkeTransform(MCLIB_I_ABC* input, MCLIB_I_ALPHA_BETA* output);
- void MCLIB_ParkTransform(MCLIB_I_ALPHA_BETA* input, MCLIB_POSITION* position, MCLIB_I_DQ* output);
- void MCLIB_InvParkTransform(MCLIB_V_DQ* input, MCLIB_POSITION* position, MCLIB_V_ALPHA_BETA* output);
+/* The library only works on the structures it is given: the global
+   instances above belong to the application, any number of motors can
+   share the same code. Arguments of one call must not overlap. */
  void MCLIB_SinCosCalc(MCLIB_POSITION* position );
- void MCLIB_PIControl( MCLIB_PI *pParm);
- void MCLIB_SVPWMGen( MCLIB_V_ALPHA_BETA* vAlphaBeta, MCLIB_SVPWM* svm );
+ void MCLIB_SVPWMGen( const MCLIB_V_ALPHA_BETA* restrict vAlphaBeta, MCLIB_SVPWM* restrict svm );
+ void MCLIB_SinCosBenchmark( MCLIB_SINCOS_BENCHMARK* result );
+
+/******************************************************************************/
+/* Function name: MCLIB_ClarkeTransform                                       */
+/* Function parameters: input - phase currents, output - alpha/beta currents  */
+/* Function return: None                                                      */
+/* Description: Clarke Transformation                                         */
+/******************************************************************************/
+static inline void MCLIB_ClarkeTransform(const MCLIB_I_ABC* restrict input, MCLIB_I_ALPHA_BETA* restrict output)
+{
+    output->iAlpha = input->ia;
+    output->iBeta = (input->ia * ONE_BY_SQRT3) + (input->ib * TWO_BY_SQRT3);
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_ParkTransform                                         */
+/* Function parameters: input - alpha/beta currents, position - sin/cos of    */
+/*                      the rotor angle, output - d/q currents                */
+/* Function return: None                                                      */
+/* Description: Park Transformation.                                          */
+/******************************************************************************/
+static inline void MCLIB_ParkTransform(const MCLIB_I_ALPHA_BETA* restrict input,
+                                       const MCLIB_POSITION* restrict position,
+                                       MCLIB_I_DQ* restrict output)
+{
+    output->id =  input->iAlpha * position->cosAngle
+                        + input->iBeta * position->sineAngle;
+    output->iq = -input->iAlpha * position->sineAngle
+                        + input->iBeta * position->cosAngle;
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_InvParkTransform                                      */
+/* Function parameters: input - d/q voltages, position - sin/cos of the rotor */
+/*                      angle, output - alpha/beta voltages                   */
+/* Function return: None                                                      */
+/* Description: Inverse Park Transformation.                                  */
+/******************************************************************************/
+static inline void MCLIB_InvParkTransform(const MCLIB_V_DQ* restrict input,
+                                          const MCLIB_POSITION* restrict position,
+                                          MCLIB_V_ALPHA_BETA* restrict output)
+{
+    output->vAlpha =  input->vd * position->cosAngle - input->vq * position->sineAngle;
+    output->vBeta  =  input->vd * position->sineAngle + input->vq * position->cosAngle;
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_PIControl                                             */
+/* Function parameters: pParm - PI parameter structure                        */
+/* Function return: None                                                      */
+/* Description:                                                               */
+/* Execute PI control                                                         */
+/******************************************************************************/
+static inline void MCLIB_PIControl( MCLIB_PI *pParm)
+{
+	float Err;
+	float Out;
+	float Exc;
+
+	Err  = pParm->inRef - pParm->inMeas;
+	Out  = pParm->dSum + pParm->kp * Err;
+
+	/* Limit checking for PI output */
+	if( Out > pParm->outMax ){
+        pParm->out = pParm->outMax;}
+	else if( Out < pParm->outMin ){
+        pParm->out = pParm->outMin;}
+	else{
+        pParm->out = Out;}
+
+	Exc = Out - pParm->out;
+	pParm->dSum = pParm->dSum + pParm->ki * Err - pParm->kc * Exc;
+}
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
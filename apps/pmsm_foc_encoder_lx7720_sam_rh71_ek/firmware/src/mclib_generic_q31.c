@@ -0,0 +1,745 @@
+/*******************************************************************************
+  Main Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mclib_generic_q31.c
+
+  Summary:
+    This file contains the motor control algorithm functions in Q31.
+
+  Description:
+    This file contains the motor control algorithm functions like clarke transform,
+    park transform. This library is implemented with Q31 fixed point data type
+    and uses the Cortex-M7 saturating DSP instructions when available.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"                // SYS function prototypes
+#include "mclib_generic_q31.h"
+#include "userparams.h"
+#include "math.h"
+
+/******************************************************************************/
+/* Defines                                                                    */
+/******************************************************************************/
+#define SINE_TABLE_Q31_SHIFT        (10U)
+#define SINE_TABLE_Q31_SIZE         (1UL << SINE_TABLE_Q31_SHIFT)  /* Entries per quarter wave */
+#define SINE_TABLE_Q31_FRAC_BITS    (30U - SINE_TABLE_Q31_SHIFT)   /* Angle bits below the index */
+
+#if(Q31_BENCHMARK == true)
+#define Q31_BENCHMARK_POINTS        (1024U)
+#define Q31_BENCHMARK_CURRENT       (0.5f)      /* Phase current amplitude, per unit */
+#define Q31_BENCHMARK_IQ_REF        (0.2f)      /* Iq reference, per unit */
+#endif
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+__STATIC_INLINE int32_t MCLIB_Q31Add(int32_t op1, int32_t op2);
+__STATIC_INLINE int32_t MCLIB_Q31Sub(int32_t op1, int32_t op2);
+__STATIC_INLINE int32_t MCLIB_Q31Mul(int32_t op1, int32_t op2);
+__STATIC_INLINE int32_t MCLIB_Q31Sat(int64_t value);
+__STATIC_INLINE void MCLIB_SVPWMTimeCalc_Q31(MCLIB_SVPWM_Q31* svm);
+__STATIC_INLINE uint32_t MCLIB_SVPWMDuty_Q31(int32_t time);
+#if(Q31_BENCHMARK == true)
+__STATIC_INLINE void MCLIB_ChainCyclesAdd(const uint32_t* stamp, MCLIB_CHAIN_CYCLES* cycles);
+__STATIC_INLINE void MCLIB_ChainCyclesAverage(MCLIB_CHAIN_CYCLES* cycles);
+#endif
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+
+MCLIB_PI_Q31                gPIParmQQ31;        /* Iq PI controllers */
+MCLIB_PI_Q31                gPIParmDQ31;        /* Id PI controllers */
+MCLIB_I_ABC_Q31             gMCLIBCurrentABCQ31;
+MCLIB_I_ALPHA_BETA_Q31      gMCLIBCurrentAlphaBetaQ31;
+MCLIB_I_DQ_Q31              gMCLIBCurrentDQQ31;
+MCLIB_POSITION_Q31          gMCLIBPositionQ31;
+MCLIB_V_DQ_Q31              gMCLIBVoltageDQQ31;
+MCLIB_V_ALPHA_BETA_Q31      gMCLIBVoltageAlphaBetaQ31;
+MCLIB_SVPWM_Q31             gMCLIBSVPWMQ31;
+
+/******************************************************************************/
+/*      Quarter wave SIN Table in Q31  1024 + 1                               */
+/*      Entry k holds sin(k * PI / (2 * SINE_TABLE_Q31_SIZE)), the last       */
+/*      entry closes the quarter wave so that interpolation never wraps.      */
+/******************************************************************************/
+static const __attribute__ ((tcm)) int32_t sineTableQ31[SINE_TABLE_Q31_SIZE + 1U] =
+// <editor-fold defaultstate="collapsed" desc="Sine Table Q31">
+{
+    0L, 3294197L, 6588387L, 9882561L, 13176712L, 16470832L, 19764913L, 23058947L,
+    26352928L, 29646846L, 32940695L, 36234466L, 39528151L, 42821744L, 46115236L, 49408620L,
+    52701887L, 55995030L, 59288042L, 62580914L, 65873638L, 69166208L, 72458615L, 75750851L,
+    79042909L, 82334782L, 85626460L, 88917937L, 92209205L, 95500255L, 98791081L, 102081675L,
+    105372028L, 108662134L, 111951983L, 115241570L, 118530885L, 121819921L, 125108670L, 128397125L,
+    131685278L, 134973122L, 138260647L, 141547847L, 144834714L, 148121241L, 151407418L, 154693240L,
+    157978697L, 161263783L, 164548489L, 167832808L, 171116733L, 174400254L, 177683365L, 180966058L,
+    184248325L, 187530159L, 190811551L, 194092495L, 197372981L, 200653003L, 203932553L, 207211624L,
+    210490206L, 213768293L, 217045878L, 220322951L, 223599506L, 226875535L, 230151030L, 233425984L,
+    236700388L, 239974235L, 243247518L, 246520228L, 249792358L, 253063900L, 256334847L, 259605191L,
+    262874923L, 266144038L, 269412525L, 272680379L, 275947592L, 279214155L, 282480061L, 285745302L,
+    289009871L, 292273760L, 295536961L, 298799466L, 302061269L, 305322361L, 308582734L, 311842381L,
+    315101295L, 318359466L, 321616889L, 324873555L, 328129457L, 331384586L, 334638936L, 337892498L,
+    341145265L, 344397230L, 347648383L, 350898719L, 354148230L, 357396906L, 360644742L, 363891730L,
+    367137861L, 370383128L, 373627523L, 376871039L, 380113669L, 383355404L, 386596237L, 389836160L,
+    393075166L, 396313247L, 399550396L, 402786604L, 406021865L, 409256170L, 412489512L, 415721883L,
+    418953276L, 422183684L, 425413098L, 428641511L, 431868915L, 435095303L, 438320667L, 441545000L,
+    444768294L, 447990541L, 451211734L, 454431865L, 457650927L, 460868912L, 464085813L, 467301622L,
+    470516330L, 473729932L, 476942419L, 480153784L, 483364019L, 486573117L, 489781069L, 492987869L,
+    496193509L, 499397982L, 502601279L, 505803394L, 509004318L, 512204045L, 515402566L, 518599875L,
+    521795963L, 524990824L, 528184449L, 531376831L, 534567963L, 537757837L, 540946445L, 544133781L,
+    547319836L, 550504604L, 553688076L, 556870245L, 560051104L, 563230645L, 566408860L, 569585743L,
+    572761285L, 575935480L, 579108320L, 582279796L, 585449903L, 588618632L, 591785976L, 594951927L,
+    598116479L, 601279623L, 604441352L, 607601658L, 610760536L, 613917975L, 617073971L, 620228514L,
+    623381598L, 626533215L, 629683357L, 632832018L, 635979190L, 639124865L, 642269036L, 645411696L,
+    648552838L, 651692453L, 654830535L, 657967075L, 661102068L, 664235505L, 667367379L, 670497682L,
+    673626408L, 676753549L, 679879097L, 683003045L, 686125387L, 689246113L, 692365218L, 695482694L,
+    698598533L, 701712728L, 704825272L, 707936158L, 711045377L, 714152924L, 717258790L, 720362968L,
+    723465451L, 726566232L, 729665303L, 732762657L, 735858287L, 738952186L, 742044345L, 745134758L,
+    748223418L, 751310318L, 754395449L, 757478806L, 760560380L, 763640164L, 766718151L, 769794334L,
+    772868706L, 775941259L, 779011986L, 782080880L, 785147934L, 788213141L, 791276492L, 794337982L,
+    797397602L, 800455346L, 803511207L, 806565177L, 809617249L, 812667415L, 815715670L, 818762005L,
+    821806413L, 824848888L, 827889422L, 830928007L, 833964638L, 836999305L, 840032004L, 843062726L,
+    846091463L, 849118210L, 852142959L, 855165703L, 858186435L, 861205147L, 864221832L, 867236484L,
+    870249095L, 873259659L, 876268167L, 879274614L, 882278992L, 885281293L, 888281512L, 891279640L,
+    894275671L, 897269597L, 900261413L, 903251110L, 906238681L, 909224120L, 912207419L, 915188572L,
+    918167572L, 921144411L, 924119082L, 927091579L, 930061894L, 933030021L, 935995952L, 938959681L,
+    941921200L, 944880503L, 947837582L, 950792431L, 953745043L, 956695411L, 959643527L, 962589385L,
+    965532978L, 968474300L, 971413342L, 974350098L, 977284562L, 980216726L, 983146583L, 986074127L,
+    988999351L, 991922248L, 994842810L, 997761031L, 1000676905L, 1003590424L, 1006501581L, 1009410370L,
+    1012316784L, 1015220816L, 1018122458L, 1021021705L, 1023918550L, 1026812985L, 1029705004L, 1032594600L,
+    1035481766L, 1038366495L, 1041248781L, 1044128617L, 1047005996L, 1049880912L, 1052753357L, 1055623324L,
+    1058490808L, 1061355801L, 1064218296L, 1067078288L, 1069935768L, 1072790730L, 1075643169L, 1078493076L,
+    1081340445L, 1084185270L, 1087027544L, 1089867259L, 1092704411L, 1095538991L, 1098370993L, 1101200410L,
+    1104027237L, 1106851465L, 1109673089L, 1112492101L, 1115308496L, 1118122267L, 1120933406L, 1123741908L,
+    1126547765L, 1129350972L, 1132151521L, 1134949406L, 1137744621L, 1140537158L, 1143327011L, 1146114174L,
+    1148898640L, 1151680403L, 1154459456L, 1157235792L, 1160009405L, 1162780288L, 1165548435L, 1168313840L,
+    1171076495L, 1173836395L, 1176593533L, 1179347902L, 1182099496L, 1184848308L, 1187594332L, 1190337562L,
+    1193077991L, 1195815612L, 1198550419L, 1201282407L, 1204011567L, 1206737894L, 1209461382L, 1212182024L,
+    1214899813L, 1217614743L, 1220326809L, 1223036002L, 1225742318L, 1228445750L, 1231146291L, 1233843935L,
+    1236538675L, 1239230506L, 1241919421L, 1244605414L, 1247288478L, 1249968606L, 1252645794L, 1255320034L,
+    1257991320L, 1260659646L, 1263325005L, 1265987392L, 1268646800L, 1271303222L, 1273956653L, 1276607086L,
+    1279254516L, 1281898935L, 1284540337L, 1287178717L, 1289814068L, 1292446384L, 1295075659L, 1297701886L,
+    1300325060L, 1302945174L, 1305562222L, 1308176198L, 1310787095L, 1313394909L, 1315999631L, 1318601257L,
+    1321199781L, 1323795195L, 1326387494L, 1328976672L, 1331562723L, 1334145641L, 1336725419L, 1339302052L,
+    1341875533L, 1344445857L, 1347013017L, 1349577007L, 1352137822L, 1354695455L, 1357249901L, 1359801152L,
+    1362349204L, 1364894050L, 1367435685L, 1369974101L, 1372509294L, 1375041258L, 1377569986L, 1380095472L,
+    1382617710L, 1385136696L, 1387652422L, 1390164882L, 1392674072L, 1395179984L, 1397682613L, 1400181954L,
+    1402678000L, 1405170745L, 1407660183L, 1410146309L, 1412629117L, 1415108601L, 1417584755L, 1420057574L,
+    1422527051L, 1424993180L, 1427455956L, 1429915374L, 1432371426L, 1434824109L, 1437273414L, 1439719338L,
+    1442161874L, 1444601017L, 1447036760L, 1449469098L, 1451898025L, 1454323536L, 1456745625L, 1459164286L,
+    1461579514L, 1463991302L, 1466399645L, 1468804538L, 1471205974L, 1473603949L, 1475998456L, 1478389489L,
+    1480777044L, 1483161115L, 1485541696L, 1487918781L, 1490292364L, 1492662441L, 1495029006L, 1497392053L,
+    1499751576L, 1502107570L, 1504460029L, 1506808949L, 1509154322L, 1511496145L, 1513834411L, 1516169114L,
+    1518500250L, 1520827813L, 1523151797L, 1525472197L, 1527789007L, 1530102222L, 1532411837L, 1534717846L,
+    1537020244L, 1539319024L, 1541614183L, 1543905714L, 1546193612L, 1548477872L, 1550758488L, 1553035455L,
+    1555308768L, 1557578421L, 1559844408L, 1562106725L, 1564365367L, 1566620327L, 1568871601L, 1571119183L,
+    1573363068L, 1575603251L, 1577839726L, 1580072489L, 1582301533L, 1584526854L, 1586748447L, 1588966306L,
+    1591180426L, 1593390801L, 1595597428L, 1597800299L, 1599999411L, 1602194758L, 1604386335L, 1606574136L,
+    1608758157L, 1610938393L, 1613114838L, 1615287487L, 1617456335L, 1619621377L, 1621782608L, 1623940023L,
+    1626093616L, 1628243383L, 1630389319L, 1632531418L, 1634669676L, 1636804087L, 1638934646L, 1641061349L,
+    1643184191L, 1645303166L, 1647418269L, 1649529496L, 1651636841L, 1653740300L, 1655839867L, 1657935539L,
+    1660027308L, 1662115172L, 1664199124L, 1666279161L, 1668355276L, 1670427466L, 1672495725L, 1674560049L,
+    1676620432L, 1678676870L, 1680729357L, 1682777890L, 1684822463L, 1686863072L, 1688899711L, 1690932376L,
+    1692961062L, 1694985765L, 1697006479L, 1699023199L, 1701035922L, 1703044642L, 1705049355L, 1707050055L,
+    1709046739L, 1711039401L, 1713028037L, 1715012642L, 1716993211L, 1718969740L, 1720942225L, 1722910659L,
+    1724875040L, 1726835361L, 1728791620L, 1730743810L, 1732691928L, 1734635968L, 1736575927L, 1738511799L,
+    1740443581L, 1742371267L, 1744294853L, 1746214334L, 1748129707L, 1750040966L, 1751948107L, 1753851126L,
+    1755750017L, 1757644777L, 1759535401L, 1761421885L, 1763304224L, 1765182414L, 1767056450L, 1768926328L,
+    1770792044L, 1772653593L, 1774510970L, 1776364172L, 1778213194L, 1780058032L, 1781898681L, 1783735137L,
+    1785567396L, 1787395453L, 1789219305L, 1791038946L, 1792854372L, 1794665580L, 1796472565L, 1798275323L,
+    1800073849L, 1801868139L, 1803658189L, 1805443995L, 1807225553L, 1809002858L, 1810775906L, 1812544694L,
+    1814309216L, 1816069469L, 1817825449L, 1819577151L, 1821324572L, 1823067707L, 1824806552L, 1826541103L,
+    1828271356L, 1829997307L, 1831718951L, 1833436286L, 1835149306L, 1836858008L, 1838562388L, 1840262441L,
+    1841958164L, 1843649553L, 1845336604L, 1847019312L, 1848697674L, 1850371686L, 1852041343L, 1853706643L,
+    1855367581L, 1857024153L, 1858676355L, 1860324183L, 1861967634L, 1863606704L, 1865241388L, 1866871683L,
+    1868497586L, 1870119091L, 1871736196L, 1873348897L, 1874957189L, 1876561070L, 1878160535L, 1879755580L,
+    1881346202L, 1882932397L, 1884514161L, 1886091491L, 1887664383L, 1889232832L, 1890796837L, 1892356392L,
+    1893911494L, 1895462140L, 1897008325L, 1898550047L, 1900087301L, 1901620084L, 1903148392L, 1904672222L,
+    1906191570L, 1907706433L, 1909216806L, 1910722688L, 1912224073L, 1913720958L, 1915213340L, 1916701216L,
+    1918184581L, 1919663432L, 1921137767L, 1922607581L, 1924072871L, 1925533633L, 1926989864L, 1928441561L,
+    1929888720L, 1931331338L, 1932769411L, 1934202936L, 1935631910L, 1937056329L, 1938476190L, 1939891490L,
+    1941302225L, 1942708392L, 1944109987L, 1945507008L, 1946899451L, 1948287312L, 1949670589L, 1951049279L,
+    1952423377L, 1953792881L, 1955157788L, 1956518093L, 1957873796L, 1959224890L, 1960571375L, 1961913246L,
+    1963250501L, 1964583136L, 1965911148L, 1967234535L, 1968553292L, 1969867417L, 1971176906L, 1972481757L,
+    1973781967L, 1975077532L, 1976368450L, 1977654717L, 1978936331L, 1980213288L, 1981485585L, 1982753220L,
+    1984016189L, 1985274489L, 1986528118L, 1987777073L, 1989021350L, 1990260946L, 1991495860L, 1992726087L,
+    1993951625L, 1995172471L, 1996388622L, 1997600076L, 1998806829L, 2000008879L, 2001206222L, 2002398857L,
+    2003586779L, 2004769987L, 2005948478L, 2007122248L, 2008291295L, 2009455617L, 2010615210L, 2011770073L,
+    2012920201L, 2014065592L, 2015206245L, 2016342155L, 2017473321L, 2018599739L, 2019721407L, 2020838323L,
+    2021950484L, 2023057887L, 2024160529L, 2025258408L, 2026351522L, 2027439867L, 2028523442L, 2029602243L,
+    2030676269L, 2031745516L, 2032809982L, 2033869665L, 2034924562L, 2035974670L, 2037019988L, 2038060512L,
+    2039096241L, 2040127172L, 2041153301L, 2042174628L, 2043191150L, 2044202863L, 2045209767L, 2046211857L,
+    2047209133L, 2048201592L, 2049189231L, 2050172048L, 2051150040L, 2052123207L, 2053091544L, 2054055050L,
+    2055013723L, 2055967560L, 2056916560L, 2057860719L, 2058800036L, 2059734508L, 2060664133L, 2061588910L,
+    2062508835L, 2063423908L, 2064334124L, 2065239484L, 2066139983L, 2067035621L, 2067926394L, 2068812302L,
+    2069693342L, 2070569511L, 2071440808L, 2072307231L, 2073168777L, 2074025446L, 2074877233L, 2075724139L,
+    2076566160L, 2077403294L, 2078235540L, 2079062896L, 2079885360L, 2080702930L, 2081515603L, 2082323379L,
+    2083126254L, 2083924228L, 2084717298L, 2085505463L, 2086288720L, 2087067068L, 2087840505L, 2088609029L,
+    2089372638L, 2090131331L, 2090885105L, 2091633960L, 2092377892L, 2093116901L, 2093850985L, 2094580142L,
+    2095304370L, 2096023667L, 2096738032L, 2097447464L, 2098151960L, 2098851519L, 2099546139L, 2100235819L,
+    2100920556L, 2101600350L, 2102275199L, 2102945101L, 2103610054L, 2104270057L, 2104925109L, 2105575208L,
+    2106220352L, 2106860540L, 2107495770L, 2108126041L, 2108751352L, 2109371700L, 2109987085L, 2110597505L,
+    2111202959L, 2111803444L, 2112398960L, 2112989506L, 2113575080L, 2114155680L, 2114731305L, 2115301954L,
+    2115867626L, 2116428319L, 2116984031L, 2117534762L, 2118080511L, 2118621275L, 2119157054L, 2119687847L,
+    2120213651L, 2120734467L, 2121250292L, 2121761126L, 2122266967L, 2122767814L, 2123263666L, 2123754522L,
+    2124240380L, 2124721240L, 2125197100L, 2125667960L, 2126133817L, 2126594672L, 2127050522L, 2127501367L,
+    2127947206L, 2128388038L, 2128823862L, 2129254676L, 2129680480L, 2130101272L, 2130517052L, 2130927819L,
+    2131333572L, 2131734309L, 2132130030L, 2132520734L, 2132906420L, 2133287087L, 2133662734L, 2134033361L,
+    2134398966L, 2134759548L, 2135115107L, 2135465642L, 2135811153L, 2136151637L, 2136487095L, 2136817525L,
+    2137142927L, 2137463301L, 2137778644L, 2138088958L, 2138394240L, 2138694490L, 2138989708L, 2139279892L,
+    2139565043L, 2139845159L, 2140120240L, 2140390284L, 2140655293L, 2140915264L, 2141170197L, 2141420092L,
+    2141664948L, 2141904764L, 2142139541L, 2142369276L, 2142593971L, 2142813624L, 2143028234L, 2143237802L,
+    2143442326L, 2143641807L, 2143836244L, 2144025635L, 2144209982L, 2144389283L, 2144563539L, 2144732748L,
+    2144896910L, 2145056025L, 2145210092L, 2145359112L, 2145503083L, 2145642006L, 2145775880L, 2145904705L,
+    2146028480L, 2146147205L, 2146260881L, 2146369505L, 2146473080L, 2146571603L, 2146665076L, 2146753497L,
+    2146836866L, 2146915184L, 2146988450L, 2147056664L, 2147119825L, 2147177934L, 2147230991L, 2147278995L,
+    2147321946L, 2147359845L, 2147392690L, 2147420483L, 2147443222L, 2147460908L, 2147473542L, 2147481121L,
+    2147483647L
+};
+// </editor-fold>
+
+/******************************************************************************/
+/* Function name: MCLIB_Q31Add                                                */
+/* Function parameters: op1, op2 - Q31 operands                               */
+/* Function return: Saturated sum                                             */
+/* Description: Saturating addition (QADD)                                    */
+/******************************************************************************/
+__STATIC_INLINE int32_t MCLIB_Q31Add(int32_t op1, int32_t op2)
+{
+#if (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+    return __QADD(op1, op2);
+#else
+    return MCLIB_Q31Sat((int64_t)op1 + (int64_t)op2);
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_Q31Sub                                                */
+/* Function parameters: op1, op2 - Q31 operands                               */
+/* Function return: Saturated difference                                      */
+/* Description: Saturating subtraction (QSUB)                                 */
+/******************************************************************************/
+__STATIC_INLINE int32_t MCLIB_Q31Sub(int32_t op1, int32_t op2)
+{
+#if (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+    return __QSUB(op1, op2);
+#else
+    return MCLIB_Q31Sat((int64_t)op1 - (int64_t)op2);
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_Q31Mul                                                */
+/* Function parameters: op1, op2 - Q31 operands                               */
+/* Function return: Saturated Q31 product                                     */
+/* Description: Most significant word multiply (SMMUL) followed by a          */
+/*              saturating doubling, so that -1 * -1 does not wrap.           */
+/******************************************************************************/
+__STATIC_INLINE int32_t MCLIB_Q31Mul(int32_t op1, int32_t op2)
+{
+    int32_t high = (int32_t)(((int64_t)op1 * (int64_t)op2) >> 32);
+    return MCLIB_Q31Add(high, high);
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_Q31Sat                                                */
+/* Function parameters: value - 64-bit intermediate result, |value| < 2^62    */
+/* Function return: value limited to the Q31 range                            */
+/* Description: Saturation of a 64-bit intermediate to Q31. In range, the     */
+/*              bits above bit 31 are all copies of the sign: SSAT of the     */
+/*              high word to one bit leaves them unchanged, otherwise it      */
+/*              gives the sign of the limit.                                  */
+/******************************************************************************/
+__STATIC_INLINE int32_t MCLIB_Q31Sat(int64_t value)
+{
+#if (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+    int32_t high = (int32_t)(value >> 31);
+    int32_t sign = __SSAT(high, 1U);
+
+    return (high == sign) ? (int32_t)value : (sign ^ Q31_MAX);
+#else
+    int32_t result;
+
+    if(value > (int64_t)Q31_MAX)
+    {
+        result = Q31_MAX;
+    }
+    else if(value < (int64_t)Q31_MIN)
+    {
+        result = Q31_MIN;
+    }
+    else
+    {
+        result = (int32_t)value;
+    }
+    return result;
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_ClarkeTransform_Q31                                   */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Clarke Transformation                                         */
+/******************************************************************************/
+ void MCLIB_ClarkeTransform_Q31(const MCLIB_I_ABC_Q31* restrict input, MCLIB_I_ALPHA_BETA_Q31* restrict output)
+{
+    int32_t ibScaled;
+
+    /* 2/sqrt(3) does not fit in Q31: ib * 2/sqrt(3) = 2 * (ib * 1/sqrt(3)) */
+    ibScaled = MCLIB_Q31Mul(input->ib, ONE_BY_SQRT3_Q31);
+
+    output->iAlpha = input->ia;
+    output->iBeta = MCLIB_Q31Add(MCLIB_Q31Mul(input->ia, ONE_BY_SQRT3_Q31),
+                                 MCLIB_Q31Add(ibScaled, ibScaled));
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_ParkTransform_Q31                                     */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Park Transformation.                                          */
+/******************************************************************************/
+ void MCLIB_ParkTransform_Q31(const MCLIB_I_ALPHA_BETA_Q31* restrict input, const MCLIB_POSITION_Q31* restrict position, MCLIB_I_DQ_Q31* restrict output)
+{
+    output->id = MCLIB_Q31Add(MCLIB_Q31Mul(input->iAlpha, position->cosAngle),
+                              MCLIB_Q31Mul(input->iBeta, position->sineAngle));
+    output->iq = MCLIB_Q31Sub(MCLIB_Q31Mul(input->iBeta, position->cosAngle),
+                              MCLIB_Q31Mul(input->iAlpha, position->sineAngle));
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_InvParkTransform_Q31                                  */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Inverse Park Transformation.                                  */
+/******************************************************************************/
+void MCLIB_InvParkTransform_Q31(const MCLIB_V_DQ_Q31* restrict input, const MCLIB_POSITION_Q31* restrict position, MCLIB_V_ALPHA_BETA_Q31* restrict output)
+{
+    output->vAlpha = MCLIB_Q31Sub(MCLIB_Q31Mul(input->vd, position->cosAngle),
+                                  MCLIB_Q31Mul(input->vq, position->sineAngle));
+    output->vBeta  = MCLIB_Q31Add(MCLIB_Q31Mul(input->vd, position->sineAngle),
+                                  MCLIB_Q31Mul(input->vq, position->cosAngle));
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_SinCosCalc_Q31                                        */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Calculates the sin and cosine of the binary angle based upon  */
+/*              interpolation technique from the quarter wave table. The two  */
+/*              upper angle bits select the quadrant, the next bits the table */
+/*              entry and the remaining bits the interpolation weight.        */
+/******************************************************************************/
+ void MCLIB_SinCosCalc_Q31(MCLIB_POSITION_Q31* position )
+{
+    uint32_t index;
+    uint32_t quadrant;
+    int32_t frac, rise, fall;
+
+    quadrant = position->angle >> 30U;
+    index = (position->angle >> SINE_TABLE_Q31_FRAC_BITS) & (SINE_TABLE_Q31_SIZE - 1U);
+    frac = (int32_t)((position->angle << (SINE_TABLE_Q31_SHIFT + 2U)) >> 1U);
+
+    /* Rising side sin(x) and falling side cos(x) of the first quadrant */
+    rise = sineTableQ31[index]
+         + MCLIB_Q31Mul(sineTableQ31[index + 1U] - sineTableQ31[index], frac);
+    fall = sineTableQ31[SINE_TABLE_Q31_SIZE - index]
+         + MCLIB_Q31Mul(sineTableQ31[SINE_TABLE_Q31_SIZE - index - 1U] - sineTableQ31[SINE_TABLE_Q31_SIZE - index], frac);
+
+    switch(quadrant)
+    {
+        case 0U:
+            position->sineAngle = rise;
+            position->cosAngle  = fall;
+            break;
+        case 1U:
+            position->sineAngle = fall;
+            position->cosAngle  = -rise;
+            break;
+        case 2U:
+            position->sineAngle = -rise;
+            position->cosAngle  = -fall;
+            break;
+        default:
+            position->sineAngle = -fall;
+            position->cosAngle  = rise;
+            break;
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_PIControl_Q31                                         */
+/* Function parameters: pParm - PI parameter structure                        */
+/* Function return: None                                                      */
+/* Description:                                                               */
+/* Execute PI control with output saturation and back calculation anti-windup */
+/* The output excess fed back is limited to 1.0, the Q31 range.               */
+/******************************************************************************/
+ void MCLIB_PIControl_Q31( MCLIB_PI_Q31 *pParm)
+{
+    int32_t Err;
+    int64_t Out;
+    int32_t Exc;
+    int64_t Prop;
+
+    Err  = MCLIB_Q31Sub(pParm->inRef, pParm->inMeas);
+    Prop = ((int64_t)pParm->kp * (int64_t)Err) >> (31U - pParm->kpShift);
+    /* Kept in 64 bits: an output beyond 1.0 still gives its full excess */
+    Out  = (int64_t)pParm->dSum + Prop;
+
+    /* Limit checking for PI output */
+    if( Out > (int64_t)pParm->outMax ){
+        pParm->out = pParm->outMax;}
+    else if( Out < (int64_t)pParm->outMin ){
+        pParm->out = pParm->outMin;}
+    else{
+        pParm->out = (int32_t)Out;}
+
+    /* Integral and back calculation terms are added before saturating */
+    Exc = MCLIB_Q31Sat(Out - (int64_t)pParm->out);
+    pParm->dSum = MCLIB_Q31Sat(((int64_t)pParm->dSum + (int64_t)MCLIB_Q31Mul(pParm->ki, Err))
+                               - (int64_t)MCLIB_Q31Mul(pParm->kc, Exc));
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_PIParamToQ31                                          */
+/* Function parameters: pParm - float PI structure, inScale - physical value  */
+/*                      of 1.0 at the PI input, pParmQ31 - Q31 PI structure   */
+/* Function return: None                                                      */
+/* Description: Converts gains and limits of a float PI controller, whose     */
+/*              output is already per unit, to the Q31 controller. Kp above   */
+/*              1.0 is represented with kpShift, Ki and Kc are limited to 1.0 */
+/******************************************************************************/
+ void MCLIB_PIParamToQ31( const MCLIB_PI* restrict pParm, float inScale, MCLIB_PI_Q31* restrict pParmQ31)
+{
+    float kp = pParm->kp * inScale;
+    uint32_t shift = 0U;
+
+    while((kp >= 1.0f) && (shift < 30U))
+    {
+        kp *= 0.5f;
+        shift++;
+    }
+
+    pParmQ31->kp = MCLIB_FloatToQ31(kp);
+    pParmQ31->kpShift = shift;
+    pParmQ31->ki = MCLIB_FloatToQ31(pParm->ki * inScale);
+    pParmQ31->kc = MCLIB_FloatToQ31(pParm->kc);
+    pParmQ31->outMax = MCLIB_FloatToQ31(pParm->outMax);
+    pParmQ31->outMin = MCLIB_FloatToQ31(pParm->outMin);
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_SVPWMDuty_Q31                                         */
+/* Function parameters: time - vector time in counts                          */
+/* Function return: Duty in counts                                            */
+/* Description: Over modulation can give negative times; they are limited to  */
+/*              zero like the float to unsigned conversion of the FPU does.   */
+/******************************************************************************/
+__STATIC_INLINE uint32_t MCLIB_SVPWMDuty_Q31(int32_t time)
+{
+    return (time > 0) ? (uint32_t)time : 0U;
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_SVPWMTimeCalc_Q31                                     */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Calculates time to apply vector a,b,c                         */
+/******************************************************************************/
+__STATIC_INLINE void MCLIB_SVPWMTimeCalc_Q31(MCLIB_SVPWM_Q31* svm)
+{
+    svm->t1 = (int32_t)(((int64_t)svm->period * (int64_t)svm->t1) >> 31);
+    svm->t2 = (int32_t)(((int64_t)svm->period * (int64_t)svm->t2) >> 31);
+    svm->t_c = ((int32_t)svm->period - svm->t1 - svm->t2) >> 1;
+    svm->t_b = svm->t_c + svm->t2;
+    svm->t_a = svm->t_b + svm->t1;
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_SVPWMGen_Q31                                          */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Determines sector based upon three reference vectors amplitude*/
+/*              and updates duty.                                             */
+/******************************************************************************/
+ void MCLIB_SVPWMGen_Q31( const MCLIB_V_ALPHA_BETA_Q31* restrict vAlphaBeta, MCLIB_SVPWM_Q31* restrict svm )
+{
+    int32_t halfBeta = vAlphaBeta->vBeta >> 1;
+    int32_t alphaScaled = MCLIB_Q31Mul(SQRT3_BY2_Q31, vAlphaBeta->vAlpha);
+
+    svm->vr1 = vAlphaBeta->vBeta;
+    svm->vr2 = MCLIB_Q31Sub(alphaScaled, halfBeta);
+    svm->vr3 = MCLIB_Q31Sub(-alphaScaled, halfBeta);
+
+    if( svm->vr1 >= 0 )
+    {
+        // (xx1)
+        if( svm->vr2 >= 0 )
+        {
+            // (x11)
+            // Must be Sector 3 since Sector 7 not allowed
+            // Sector 3: (0,1,1)  0-60 degrees
+            svm->t1 = svm->vr2;
+            svm->t2 = svm->vr1;
+            MCLIB_SVPWMTimeCalc_Q31(svm);
+            svm->dPWM1 = MCLIB_SVPWMDuty_Q31(svm->t_a);
+            svm->dPWM2 = MCLIB_SVPWMDuty_Q31(svm->t_b);
+            svm->dPWM3 = MCLIB_SVPWMDuty_Q31(svm->t_c);
+        }
+        else
+        {
+            // (x01)
+            if( svm->vr3 >= 0 )
+            {
+                // Sector 5: (1,0,1)  120-180 degrees
+                svm->t1 = svm->vr1;
+                svm->t2 = svm->vr3;
+                MCLIB_SVPWMTimeCalc_Q31(svm);
+                svm->dPWM1 = MCLIB_SVPWMDuty_Q31(svm->t_c);
+                svm->dPWM2 = MCLIB_SVPWMDuty_Q31(svm->t_a);
+                svm->dPWM3 = MCLIB_SVPWMDuty_Q31(svm->t_b);
+            }
+            else
+            {
+                // Sector 1: (0,0,1)  60-120 degrees
+                svm->t1 = -svm->vr2;
+                svm->t2 = -svm->vr3;
+                MCLIB_SVPWMTimeCalc_Q31(svm);
+                svm->dPWM1 = MCLIB_SVPWMDuty_Q31(svm->t_b);
+                svm->dPWM2 = MCLIB_SVPWMDuty_Q31(svm->t_a);
+                svm->dPWM3 = MCLIB_SVPWMDuty_Q31(svm->t_c);
+            }
+        }
+    }
+    else
+    {
+        // (xx0)
+        if( svm->vr2 >= 0 )
+        {
+            // (x10)
+            if( svm->vr3 >= 0 )
+            {
+                // Sector 6: (1,1,0)  240-300 degrees
+                svm->t1 = svm->vr3;
+                svm->t2 = svm->vr2;
+                MCLIB_SVPWMTimeCalc_Q31(svm);
+                svm->dPWM1 = MCLIB_SVPWMDuty_Q31(svm->t_b);
+                svm->dPWM2 = MCLIB_SVPWMDuty_Q31(svm->t_c);
+                svm->dPWM3 = MCLIB_SVPWMDuty_Q31(svm->t_a);
+            }
+            else
+            {
+                // Sector 2: (0,1,0)  300-0 degrees
+                svm->t1 = -svm->vr3;
+                svm->t2 = -svm->vr1;
+                MCLIB_SVPWMTimeCalc_Q31(svm);
+                svm->dPWM1 = MCLIB_SVPWMDuty_Q31(svm->t_a);
+                svm->dPWM2 = MCLIB_SVPWMDuty_Q31(svm->t_c);
+                svm->dPWM3 = MCLIB_SVPWMDuty_Q31(svm->t_b);
+            }
+        }
+        else
+        {
+            // (x00)
+            // Must be Sector 4 since Sector 0 not allowed
+            // Sector 4: (1,0,0)  180-240 degrees
+            svm->t1 = -svm->vr1;
+            svm->t2 = -svm->vr2;
+            MCLIB_SVPWMTimeCalc_Q31(svm);
+            svm->dPWM1 = MCLIB_SVPWMDuty_Q31(svm->t_c);
+            svm->dPWM2 = MCLIB_SVPWMDuty_Q31(svm->t_b);
+            svm->dPWM3 = MCLIB_SVPWMDuty_Q31(svm->t_a);
+        }
+    }
+}
+
+
+#if(Q31_BENCHMARK == true)
+/******************************************************************************/
+/* Function name: MCLIB_ChainCyclesAdd                                        */
+/* Function parameters: stamp - cycle counter before each stage and after the */
+/*                      last one, cycles - cycle sums per stage               */
+/* Function return: None                                                      */
+/* Description: Adds the cycles of one pass of the current loop chain.        */
+/******************************************************************************/
+__STATIC_INLINE void MCLIB_ChainCyclesAdd(const uint32_t* stamp, MCLIB_CHAIN_CYCLES* cycles)
+{
+    cycles->sinCos += stamp[1] - stamp[0];
+    cycles->clarkePark += stamp[2] - stamp[1];
+    cycles->piControl += stamp[3] - stamp[2];
+    cycles->invPark += stamp[4] - stamp[3];
+    cycles->svpwm += stamp[5] - stamp[4];
+    cycles->total += stamp[5] - stamp[0];
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_ChainCyclesAverage                                    */
+/* Function parameters: cycles - cycle sums per stage                         */
+/* Function return: None                                                      */
+/* Description: Turns the cycle sums of all passes into averages.             */
+/******************************************************************************/
+__STATIC_INLINE void MCLIB_ChainCyclesAverage(MCLIB_CHAIN_CYCLES* cycles)
+{
+    cycles->sinCos /= Q31_BENCHMARK_POINTS;
+    cycles->clarkePark /= Q31_BENCHMARK_POINTS;
+    cycles->piControl /= Q31_BENCHMARK_POINTS;
+    cycles->invPark /= Q31_BENCHMARK_POINTS;
+    cycles->svpwm /= Q31_BENCHMARK_POINTS;
+    cycles->total /= Q31_BENCHMARK_POINTS;
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_Q31Benchmark                                          */
+/* Function parameters: pParm - float current PI controller, inScale -        */
+/*                      physical value of 1.0 at the PI input, result -      */
+/*                      benchmark results                                     */
+/* Function return: None                                                      */
+/* Description: Times the current loop chain of the float library and of the */
+/*              Q31 library with the DWT cycle counter, over a sweep of the   */
+/*              full circle with balanced phase currents. Both chains run on  */
+/*              local copies of the PI controller. Cycle counts include the   */
+/*              call overhead. The caller starts the DWT cycle counter.       */
+/******************************************************************************/
+void MCLIB_Q31Benchmark( const MCLIB_PI* restrict pParm, float inScale, MCLIB_Q31_BENCHMARK* restrict result )
+{
+    MCLIB_CHAIN_CYCLES floatCycles = {0};
+    MCLIB_CHAIN_CYCLES q31Cycles = {0};
+    MCLIB_POSITION position;
+    MCLIB_I_ABC currentABC;
+    MCLIB_I_ALPHA_BETA currentAlphaBeta;
+    MCLIB_I_DQ currentDQ;
+    MCLIB_V_DQ voltageDQ;
+    MCLIB_V_ALPHA_BETA voltageAlphaBeta;
+    MCLIB_SVPWM svm = {0};
+    MCLIB_PI piD = *pParm;
+    MCLIB_PI piQ = *pParm;
+    MCLIB_POSITION_Q31 positionQ31;
+    MCLIB_I_ABC_Q31 currentABCQ31;
+    MCLIB_I_ALPHA_BETA_Q31 currentAlphaBetaQ31;
+    MCLIB_I_DQ_Q31 currentDQQ31;
+    MCLIB_V_DQ_Q31 voltageDQQ31;
+    MCLIB_V_ALPHA_BETA_Q31 voltageAlphaBetaQ31;
+    MCLIB_SVPWM_Q31 svmQ31 = {0};
+    MCLIB_PI_Q31 piDQ31 = {0};
+    MCLIB_PI_Q31 piQQ31 = {0};
+    uint32_t stamp[6];
+    uint32_t i;
+    float angle;
+    float ia;
+    float ib;
+
+    piD.dSum = 0.0f;
+    piD.inRef = 0.0f;
+    piQ.dSum = 0.0f;
+    piQ.inRef = Q31_BENCHMARK_IQ_REF * inScale;
+    MCLIB_PIParamToQ31(pParm, inScale, &piDQ31);
+    MCLIB_PIParamToQ31(pParm, inScale, &piQQ31);
+    piQQ31.inRef = MCLIB_FloatToQ31(Q31_BENCHMARK_IQ_REF);
+    svm.period = (float)PWM_PERIOD_COUNT;
+    svmQ31.period = (uint32_t)PWM_PERIOD_COUNT;
+
+    for(i = 0U; i < Q31_BENCHMARK_POINTS; i++)
+    {
+        angle = (float)i * (TOTAL_SINE_TABLE_ANGLE / (float)Q31_BENCHMARK_POINTS);
+        ia = Q31_BENCHMARK_CURRENT * cosf(angle);
+        ib = Q31_BENCHMARK_CURRENT * cosf(angle - (TOTAL_SINE_TABLE_ANGLE / 3.0f));
+
+        /* Float chain, currents in physical units */
+        position.angle = angle;
+        currentABC.ia = ia * inScale;
+        currentABC.ib = ib * inScale;
+        currentABC.ic = -currentABC.ia - currentABC.ib;
+
+        stamp[0] = DWT->CYCCNT;
+        MCLIB_SinCosCalc(&position);
+        stamp[1] = DWT->CYCCNT;
+        MCLIB_ClarkeTransform(&currentABC, &currentAlphaBeta);
+        MCLIB_ParkTransform(&currentAlphaBeta, &position, &currentDQ);
+        stamp[2] = DWT->CYCCNT;
+        piD.inMeas = currentDQ.id;
+        MCLIB_PIControl(&piD);
+        piQ.inMeas = currentDQ.iq;
+        MCLIB_PIControl(&piQ);
+        voltageDQ.vd = piD.out;
+        voltageDQ.vq = piQ.out;
+        stamp[3] = DWT->CYCCNT;
+        MCLIB_InvParkTransform(&voltageDQ, &position, &voltageAlphaBeta);
+        stamp[4] = DWT->CYCCNT;
+        MCLIB_SVPWMGen(&voltageAlphaBeta, &svm);
+        stamp[5] = DWT->CYCCNT;
+        MCLIB_ChainCyclesAdd(stamp, &floatCycles);
+
+        /* Q31 chain, currents per unit */
+        positionQ31.angle = MCLIB_AngleToQ31(angle);
+        currentABCQ31.ia = MCLIB_FloatToQ31(ia);
+        currentABCQ31.ib = MCLIB_FloatToQ31(ib);
+        currentABCQ31.ic = -currentABCQ31.ia - currentABCQ31.ib;
+
+        stamp[0] = DWT->CYCCNT;
+        MCLIB_SinCosCalc_Q31(&positionQ31);
+        stamp[1] = DWT->CYCCNT;
+        MCLIB_ClarkeTransform_Q31(&currentABCQ31, &currentAlphaBetaQ31);
+        MCLIB_ParkTransform_Q31(&currentAlphaBetaQ31, &positionQ31, &currentDQQ31);
+        stamp[2] = DWT->CYCCNT;
+        piDQ31.inMeas = currentDQQ31.id;
+        MCLIB_PIControl_Q31(&piDQ31);
+        piQQ31.inMeas = currentDQQ31.iq;
+        MCLIB_PIControl_Q31(&piQQ31);
+        voltageDQQ31.vd = piDQ31.out;
+        voltageDQQ31.vq = piQQ31.out;
+        stamp[3] = DWT->CYCCNT;
+        MCLIB_InvParkTransform_Q31(&voltageDQQ31, &positionQ31, &voltageAlphaBetaQ31);
+        stamp[4] = DWT->CYCCNT;
+        MCLIB_SVPWMGen_Q31(&voltageAlphaBetaQ31, &svmQ31);
+        stamp[5] = DWT->CYCCNT;
+        MCLIB_ChainCyclesAdd(stamp, &q31Cycles);
+    }
+
+    MCLIB_ChainCyclesAverage(&floatCycles);
+    MCLIB_ChainCyclesAverage(&q31Cycles);
+    result->floatCycles = floatCycles;
+    result->q31Cycles = q31Cycles;
+}
+#endif
+
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,254 @@
+/*******************************************************************************
+ Motor Control Library Q31 interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mclib_generic_q31.h
+
+  Summary:
+    Motor control library interface, Q31 fixed point implementation
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    Q31 fixed point motor control library. It mirrors the float library
+    (mclib_generic_float.h) function by function: every routine takes the
+    same arguments, with Q31 counterparts of the float data structures.
+
+    Scaling:
+      - currents and voltages are per unit values in [-1, 1)
+      - angles are binary angles, 2^32 is one electrical revolution
+      - PWM periods and duties are timer counts
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MCLIB_GENERIC_Q31_H    // Guards against multiple inclusion
+#define MCLIB_GENERIC_Q31_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mclib_generic_float.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+#define Q31_ONE_FLOAT                 (2147483648.0f)     /* 1.0 in Q31, as float */
+#define Q31_TO_FLOAT                  ((float)(1.0f/2147483648.0f))
+#define Q31_MAX                       (0x7FFFFFFFL)
+#define Q31_MIN                       (-0x7FFFFFFFL - 1L)
+
+#define ONE_BY_SQRT3_Q31              (1239850262L)       /* 1/sqrt(3) */
+#define SQRT3_BY2_Q31                 (1859775393L)       /* sqrt(3)/2 */
+
+/* Radians in [0, 2*PI] to binary angle: 2^31 / PI */
+#define ANGLE_RAD_TO_Q31              ((float)(2147483648.0f/(float)M_PI))
+
+typedef struct
+{
+    int32_t ia;
+    int32_t ib;
+    int32_t ic;
+}MCLIB_I_ABC_Q31;
+
+typedef struct
+{
+    int32_t iAlpha;
+    int32_t iBeta;
+}MCLIB_I_ALPHA_BETA_Q31;
+
+typedef struct
+{
+    int32_t id;
+    int32_t iq;
+}MCLIB_I_DQ_Q31;
+
+typedef struct
+{
+    int32_t vAlpha;
+    int32_t vBeta;
+}MCLIB_V_ALPHA_BETA_Q31;
+
+typedef struct
+{
+    int32_t vd;
+    int32_t vq;
+}MCLIB_V_DQ_Q31;
+
+typedef struct
+{
+    uint32_t angle;         /* Binary angle, 2^32 = 2*PI */
+    int32_t  sineAngle;
+    int32_t  cosAngle;
+}MCLIB_POSITION_Q31;
+
+typedef struct
+{
+    int32_t   dSum;
+    int32_t   kp;           /* Proportional gain = kp * 2^kpShift */
+    int32_t   ki;
+    int32_t   kc;
+    int32_t   outMax;
+    int32_t   outMin;
+    int32_t   inRef;
+    int32_t   inMeas;
+    int32_t   out;
+    uint32_t  kpShift;
+
+} MCLIB_PI_Q31;
+
+typedef struct
+{
+    uint32_t period;
+    int32_t  vr1;
+    int32_t  vr2;
+    int32_t  vr3;
+    int32_t  t1;
+    int32_t  t2;
+    int32_t  t_a;
+    int32_t  t_b;
+    int32_t  t_c;
+    uint32_t dPWM1;
+    uint32_t dPWM2;
+    uint32_t dPWM3;
+} MCLIB_SVPWM_Q31;
+
+typedef struct
+{
+    uint32_t sinCos;        /* Sine/cosine */
+    uint32_t clarkePark;    /* Clarke and Park transforms */
+    uint32_t piControl;     /* Id and Iq PI controllers */
+    uint32_t invPark;       /* Inverse Park transform */
+    uint32_t svpwm;         /* Space vector modulation */
+    uint32_t total;         /* Whole current loop chain */
+} MCLIB_CHAIN_CYCLES;
+
+typedef struct
+{
+    MCLIB_CHAIN_CYCLES floatCycles;  /* Float library, average CPU cycles per call */
+    MCLIB_CHAIN_CYCLES q31Cycles;    /* Q31 library, average CPU cycles per call */
+} MCLIB_Q31_BENCHMARK;
+
+extern MCLIB_PI_Q31     gPIParmQQ31;       /* Iq PI controllers */
+extern MCLIB_PI_Q31     gPIParmDQ31;       /* Id PI controllers */
+
+extern MCLIB_I_ABC_Q31 gMCLIBCurrentABCQ31;
+extern MCLIB_I_ALPHA_BETA_Q31  gMCLIBCurrentAlphaBetaQ31;
+extern MCLIB_I_DQ_Q31 gMCLIBCurrentDQQ31;
+extern MCLIB_POSITION_Q31 gMCLIBPositionQ31;
+extern MCLIB_V_DQ_Q31 gMCLIBVoltageDQQ31;
+extern MCLIB_V_ALPHA_BETA_Q31 gMCLIBVoltageAlphaBetaQ31;
+extern MCLIB_SVPWM_Q31 gMCLIBSVPWMQ31;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+ void MCLIB_ClarkeTransform_Q31(const MCLIB_I_ABC_Q31* restrict input, MCLIB_I_ALPHA_BETA_Q31* restrict output);
+ void MCLIB_ParkTransform_Q31(const MCLIB_I_ALPHA_BETA_Q31* restrict input, const MCLIB_POSITION_Q31* restrict position, MCLIB_I_DQ_Q31* restrict output);
+ void MCLIB_InvParkTransform_Q31(const MCLIB_V_DQ_Q31* restrict input, const MCLIB_POSITION_Q31* restrict position, MCLIB_V_ALPHA_BETA_Q31* restrict output);
+ void MCLIB_SinCosCalc_Q31(MCLIB_POSITION_Q31* position );
+ void MCLIB_PIControl_Q31( MCLIB_PI_Q31 *pParm);
+ void MCLIB_SVPWMGen_Q31( const MCLIB_V_ALPHA_BETA_Q31* restrict vAlphaBeta, MCLIB_SVPWM_Q31* restrict svm );
+ void MCLIB_PIParamToQ31( const MCLIB_PI* restrict pParm, float inScale, MCLIB_PI_Q31* restrict pParmQ31);
+ void MCLIB_Q31Benchmark( const MCLIB_PI* restrict pParm, float inScale, MCLIB_Q31_BENCHMARK* restrict result );
+
+/* Saturating conversion of a per unit float to Q31 */
+static inline int32_t MCLIB_FloatToQ31(float value)
+{
+    int32_t result;
+
+    if(value >= 1.0f)
+    {
+        result = Q31_MAX;
+    }
+    else if(value <= -1.0f)
+    {
+        result = Q31_MIN;
+    }
+    else
+    {
+        result = (int32_t)(value * Q31_ONE_FLOAT);
+    }
+    return result;
+}
+
+/* Conversion of a Q31 value to a per unit float */
+static inline float MCLIB_Q31ToFloat(int32_t value)
+{
+    return (float)value * Q31_TO_FLOAT;
+}
+
+/* Conversion of an angle in radians [0, 2*PI] to a binary angle */
+static inline uint32_t MCLIB_AngleToQ31(float angle)
+{
+    float x = angle * ANGLE_RAD_TO_Q31;
+
+    /* Upper half circle maps to negative values: avoids the uint32_t overflow */
+    if(x >= Q31_ONE_FLOAT)
+    {
+        x -= 2.0f * Q31_ONE_FLOAT;
+    }
+    return (uint32_t)(int32_t)x;
+}
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MCLIB_GENERIC_Q31_H
+
+/**
+ End of File
+*/
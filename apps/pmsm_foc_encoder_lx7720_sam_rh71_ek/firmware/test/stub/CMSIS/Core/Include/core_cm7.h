@@ -0,0 +1,106 @@
+/*******************************************************************************
+  Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    core_cm7.h
+
+  Summary:
+    Host stand-in for the CMSIS Cortex-M7 core header
+
+  Description:
+    This file provides the few core definitions used by the firmware
+    modules under test. The DWT cycle counter is a plain variable which the
+    tests advance to simulate elapsed CPU cycles. The saturating DSP
+    intrinsics are C models of the instructions, for the builds which
+    define __ARM_FEATURE_DSP.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef CORE_CM7_H    // Guards against multiple inclusion
+#define CORE_CM7_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+#define __STATIC_INLINE               static inline
+
+#define DWT_CTRL_CYCCNTENA_Msk        (1UL)
+
+typedef struct
+{
+    volatile uint32_t CTRL;         /* Control register */
+    volatile uint32_t CYCCNT;       /* Cycle count register */
+} DWT_Type;
+
+extern DWT_Type gStubDWT;
+
+#define DWT                           (&gStubDWT)
+
+/* SSAT: signed saturation of value to a width of sat bits */
+static inline int32_t __SSAT(int32_t value, uint32_t sat)
+{
+    int32_t max = (int32_t)((1UL << (sat - 1U)) - 1UL);
+    int32_t min = -max - 1;
+
+    return (value > max) ? max : ((value < min) ? min : value);
+}
+
+/* QADD: saturating 32 bit addition */
+static inline int32_t __QADD(int32_t op1, int32_t op2)
+{
+    int64_t sum = (int64_t)op1 + (int64_t)op2;
+
+    return (sum > INT32_MAX) ? INT32_MAX : ((sum < INT32_MIN) ? INT32_MIN : (int32_t)sum);
+}
+
+/* QSUB: saturating 32 bit subtraction */
+static inline int32_t __QSUB(int32_t op1, int32_t op2)
+{
+    int64_t difference = (int64_t)op1 - (int64_t)op2;
+
+    return (difference > INT32_MAX) ? INT32_MAX : ((difference < INT32_MIN) ? INT32_MIN : (int32_t)difference);
+}
+
+#endif //CORE_CM7_H
+
+/**
+ End of File
+*/
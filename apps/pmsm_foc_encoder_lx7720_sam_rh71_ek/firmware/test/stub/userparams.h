@@ -0,0 +1,107 @@
+/*******************************************************************************
+  Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    userparams.h
+
+  Summary:
+    Build time overrides of the user parameters for the host tests
+
+  Description:
+    This file includes the application userparams.h and replaces the
+    parameters which a test binary builds for several values. A test
+    selects a value with -DTEST_<PARAMETER>=<value>; without it the
+    application setting is kept. The preprocessor checks of userparams.h
+    run on the application settings.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef TEST_USERPARAMS_H    // Guards against multiple inclusion
+#define TEST_USERPARAMS_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include_next "userparams.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Parameter Overrides
+// *****************************************************************************
+// *****************************************************************************
+
+#ifdef TEST_SINCOS_METHOD
+#undef SINCOS_METHOD
+#define SINCOS_METHOD  (TEST_SINCOS_METHOD)
+#endif
+
+#ifdef TEST_SINCOS_BENCHMARK
+#undef SINCOS_BENCHMARK
+#define SINCOS_BENCHMARK  (TEST_SINCOS_BENCHMARK)
+#endif
+
+#ifdef TEST_Q31_BENCHMARK
+#undef Q31_BENCHMARK
+#define Q31_BENCHMARK  (TEST_Q31_BENCHMARK)
+#endif
+
+#ifdef TEST_NUM_POLE_PAIRS
+#undef NUM_POLE_PAIRS
+#define NUM_POLE_PAIRS  (TEST_NUM_POLE_PAIRS)
+#endif
+
+#ifdef TEST_ENCODER_PULSES_PER_REV
+#undef ENCODER_PULSES_PER_REV
+#define ENCODER_PULSES_PER_REV  (TEST_ENCODER_PULSES_PER_REV)
+#endif
+
+#ifdef TEST_ANGLE_PLL_BANDWIDTH_HZ
+#undef ANGLE_PLL_BANDWIDTH_HZ
+#define ANGLE_PLL_BANDWIDTH_HZ  (TEST_ANGLE_PLL_BANDWIDTH_HZ)
+#endif
+
+#ifdef TEST_SVPWM_METHOD
+#undef SVPWM_METHOD
+#define SVPWM_METHOD  (TEST_SVPWM_METHOD)
+#endif
+
+#ifdef TEST_ENABLE_FLYING_START
+#undef ENABLE_FLYING_START
+#define ENABLE_FLYING_START  (TEST_ENABLE_FLYING_START)
+#endif
+
+#endif //TEST_USERPARAMS_H
+
+/**
+ End of File
+*/
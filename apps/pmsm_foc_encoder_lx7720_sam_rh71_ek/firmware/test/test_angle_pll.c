@@ -0,0 +1,294 @@
+/*******************************************************************************
+  Test Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    test_angle_pll.c
+
+  Summary:
+    Speed noise and angle lag of the encoder angle tracking PLL
+
+  Description:
+    This file runs the angle tracking PLL on the quantized encoder angle of
+    a simulated rotor, for several loop bandwidths. At constant speed it
+    measures the speed noise and checks that the speed and angle errors
+    average out; a lower bandwidth must give less noise. Under constant
+    acceleration it measures the angle lag, which must match acceleration
+    / omegaN^2 of the type II loop; each bandwidth gets the acceleration
+    of a lag of several counts. The Makefile links one
+    build of mc_angle_pll.c per bandwidth, with its routines and state
+    renamed.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <math.h>
+#include "test_common.h"
+#include "definitions.h"
+#include "mc_angle_pll.h"
+#include "mc_encoder.h"
+#include "mc_motor_profile.h"
+#include "userparams.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+#if(ENABLE_ANGLE_PLL != true)
+#error "test_angle_pll needs ENABLE_ANGLE_PLL"
+#endif
+
+#define TEST_SPEED_RPM                (1037.3)      /* Constant speed run, mechanical, no whole */
+                                                    /* count per fast loop ratio */
+#define TEST_SETTLE_SEC               (0.5)         /* Lock time before a measurement */
+#define TEST_MEASURE_SEC              (1.0)         /* Averaging time */
+#define TEST_LAG_COUNTS               (4.0)         /* Expected lag of the acceleration runs */
+#define TEST_LAG_SETTLE               (15.0)        /* Acceleration run lock time, in 1 / omegaN */
+#define TEST_LAG_MEASURE              (20.0)        /* Acceleration run averaging time, in 1 / omegaN */
+#define TEST_MAX_MEAN_SPEED_ERROR     (0.005)       /* Of the speed */
+#define TEST_MAX_MEAN_ANGLE_ERROR     (0.1)         /* Of one count */
+#define TEST_MAX_LAG_ERROR            (0.02)        /* Of acceleration / omegaN^2 */
+
+/* Electrical angle of one encoder count */
+#define TEST_COUNT_ANGLE              ((2.0 * M_PI * (double)NUM_POLE_PAIRS) / (double)ENCODER_PULSES_PER_REV)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/* mc_angle_pll.c builds, one per bandwidth in Hz */
+#define TEST_PLL_BUILD(hz)                                                    \
+    extern MCAPP_ANGLE_PLL gAnglePLL##hz;                                     \
+    void MCAPP_AnglePLLReset##hz(float angle);                                \
+    void MCAPP_AnglePLLUpdate##hz(float angle);
+
+TEST_PLL_BUILD(25)
+TEST_PLL_BUILD(100)
+TEST_PLL_BUILD(400)
+
+typedef struct
+{
+    double           bandwidth;     /* Loop bandwidth (Hz) */
+    MCAPP_ANGLE_PLL* pll;           /* Loop state */
+    void (*reset)(float angle);
+    void (*update)(float angle);
+} TEST_PLL;
+
+static const TEST_PLL testPLL[] =
+{
+    {25.0,  &gAnglePLL25,  MCAPP_AnglePLLReset25,  MCAPP_AnglePLLUpdate25},
+    {100.0, &gAnglePLL100, MCAPP_AnglePLLReset100, MCAPP_AnglePLLUpdate100},
+    {400.0, &gAnglePLL400, MCAPP_AnglePLLReset400, MCAPP_AnglePLLUpdate400},
+};
+
+#define TEST_PLL_COUNT                (sizeof(testPLL) / sizeof(testPLL[0]))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulation
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_EncoderAngle                                           */
+/* Function parameters: position - rotor position in encoder counts           */
+/* Function return: Electrical angle of the last count passed (rad)           */
+/* Description: Angle as the fast loop computes it from the encoder count.    */
+/******************************************************************************/
+static float TEST_EncoderAngle(double position)
+{
+    uint32_t posCnt = MCAPP_EncoderCountWrap((int32_t)floor(position));
+
+    return (float)(posCnt * MOTOR_ENCODER_COUNT_TO_ANGLE_Q32) * MOTOR_ANGLE_Q32_TO_RAD;
+}
+
+/******************************************************************************/
+/* Function name: TEST_AngleError                                             */
+/* Function parameters: estimate - PLL angle, position - rotor position in    */
+/*                      encoder counts                                        */
+/* Function return: Estimate - true electrical angle, -PI to PI               */
+/* Description: Angle error against the unquantized rotor angle.              */
+/******************************************************************************/
+static double TEST_AngleError(float estimate, double position)
+{
+    double error = (double)estimate - (position * TEST_COUNT_ANGLE);
+
+    return error - (2.0 * M_PI * floor((error + M_PI) / (2.0 * M_PI)));
+}
+
+/******************************************************************************/
+/* Function name: TEST_Run                                                    */
+/* Function parameters: pll - loop under test, speed - initial speed,         */
+/*                      accel - acceleration, both in counts and seconds,     */
+/*                      settleSec - lock time, measureSec - averaging time,   */
+/*                      speedNoise - RMS speed error, speedMean - mean speed  */
+/*                      error (rad/s), angleMean - mean angle error (rad)     */
+/* Function return: None                                                      */
+/* Description: Locks the loop at standstill on the rotor angle, settles and  */
+/*              averages the errors. The updated angle is the prediction for  */
+/*              the next fast loop. The encoder truncates to the last count   */
+/*              passed, half a count is added back to the angle error.        */
+/******************************************************************************/
+static void TEST_Run(const TEST_PLL* pll, double speed, double accel, double settleSec, double measureSec,
+                     double* speedNoise, double* speedMean, double* angleMean)
+{
+    uint32_t settleSteps = (uint32_t)(settleSec / (double)FAST_LOOP_TIME_SEC);
+    uint32_t measureSteps = (uint32_t)(measureSec / (double)FAST_LOOP_TIME_SEC);
+    double time, position, speedError;
+    double sumSquare = 0.0;
+    double sumSpeed = 0.0;
+    double sumAngle = 0.0;
+    uint32_t i;
+
+    pll->reset(TEST_EncoderAngle(0.0));
+    for(i = 1U; i <= (settleSteps + measureSteps); i++)
+    {
+        time = (double)i * (double)FAST_LOOP_TIME_SEC;
+        position = (speed * time) + (0.5 * accel * time * time);
+        pll->update(TEST_EncoderAngle(position));
+
+        if(i > settleSteps)
+        {
+            speedError = (double)pll->pll->speed - ((speed + (accel * time)) * TEST_COUNT_ANGLE);
+            sumSquare += speedError * speedError;
+            sumSpeed += speedError;
+            time += (double)FAST_LOOP_TIME_SEC;
+            position = (speed * time) + (0.5 * accel * time * time);
+            sumAngle += TEST_AngleError(pll->pll->angle, position) + (0.5 * TEST_COUNT_ANGLE);
+        }
+    }
+    *speedNoise = sqrt(sumSquare / (double)measureSteps);
+    *speedMean = sumSpeed / (double)measureSteps;
+    *angleMean = sumAngle / (double)measureSteps;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Checks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_NoiseAndLag                                            */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Constant speed and constant acceleration run of every loop.   */
+/*              The acceleration of each loop makes it lag by                 */
+/*              TEST_LAG_COUNTS, far above the count quantization; the speed  */
+/*              runs from reverse to forward through the measurement.         */
+/******************************************************************************/
+static void TEST_NoiseAndLag(void)
+{
+    double speed = (TEST_SPEED_RPM / 60.0) * (double)ENCODER_PULSES_PER_REV;
+    double noise[TEST_PLL_COUNT];
+    double omegaN, accel, lag, expectedLag, speedMean, angleMean, unused;
+    uint32_t k;
+
+    printf("  %u pole pairs, %u counts per revolution, %.0f rpm, lag %.0f counts\n", (unsigned)NUM_POLE_PAIRS,
+           (unsigned)ENCODER_PULSES_PER_REV, TEST_SPEED_RPM, TEST_LAG_COUNTS);
+    for(k = 0U; k < TEST_PLL_COUNT; k++)
+    {
+        /* Constant speed: the errors average out, the noise remains */
+        TEST_Run(&testPLL[k], speed, 0.0, TEST_SETTLE_SEC, TEST_MEASURE_SEC, &noise[k], &speedMean, &angleMean);
+        TEST_CHECK(fabs(speedMean) < (TEST_MAX_MEAN_SPEED_ERROR * speed * TEST_COUNT_ANGLE),
+                   "%g Hz: mean speed error %g rad/s", testPLL[k].bandwidth, speedMean);
+        TEST_CHECK(fabs(angleMean) < (TEST_MAX_MEAN_ANGLE_ERROR * TEST_COUNT_ANGLE),
+                   "%g Hz: mean angle error %g rad", testPLL[k].bandwidth, angleMean);
+
+        /* Constant acceleration: a type II loop lags by accel / omegaN^2 */
+        omegaN = 2.0 * M_PI * testPLL[k].bandwidth;
+        accel = TEST_LAG_COUNTS * omegaN * omegaN;
+        TEST_Run(&testPLL[k], -0.5 * accel * ((TEST_LAG_SETTLE + TEST_LAG_MEASURE) / omegaN), accel,
+                 TEST_LAG_SETTLE / omegaN, TEST_LAG_MEASURE / omegaN, &unused, &speedMean, &angleMean);
+        lag = -angleMean;
+        expectedLag = TEST_LAG_COUNTS * TEST_COUNT_ANGLE;
+        TEST_CHECK(fabs(lag - expectedLag) < (TEST_MAX_LAG_ERROR * expectedLag),
+                   "%g Hz: lag %g rad, expected %g rad", testPLL[k].bandwidth, lag, expectedLag);
+
+        printf("  %5.0f Hz: speed noise %8.3f rad/s RMS, lag %.4g rad (expected %.4g)\n",
+               testPLL[k].bandwidth, noise[k], lag, expectedLag);
+        if(k > 0U)
+        {
+            TEST_CHECK(noise[k] > noise[k - 1U], "%g Hz is not noisier than %g Hz",
+                       testPLL[k].bandwidth, testPLL[k - 1U].bandwidth);
+        }
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Benchmarks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_Benchmark                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Host ns/call of one loop update on encoder angles.            */
+/******************************************************************************/
+static void TEST_Benchmark(void)
+{
+    static float angles[TEST_BENCH_INPUTS];
+    uint32_t i;
+
+    for(i = 0U; i < TEST_BENCH_INPUTS; i++)
+    {
+        angles[i] = TEST_EncoderAngle((double)i);
+    }
+    MCAPP_AnglePLLReset100(angles[0]);
+    TEST_BENCH("MCAPP_AnglePLLUpdate", MCAPP_AnglePLLUpdate100(angles[n & (TEST_BENCH_INPUTS - 1U)]));
+    testSink = gAnglePLL100.angle;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    TEST_NoiseAndLag();
+    TEST_Benchmark();
+    return TEST_Result("test_angle_pll");
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,176 @@
+/*******************************************************************************
+  Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    test_common.h
+
+  Summary:
+    Check, reference and timing helpers of the host tests
+
+  Description:
+    This file contains the helpers shared by the host test programs: the
+    check macro, which reports the failing file and line, a repeatable
+    pseudo random generator for the input sweeps and the ns/call timer of
+    the benchmarks. The timings are host timings; they compare the
+    implementations with each other, the target cycles are measured with
+    the DWT counter on the board.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef TEST_COMMON_H    // Guards against multiple inclusion
+#define TEST_COMMON_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_BENCH_CALLS              (1UL << 22)   /* Calls per benchmark */
+#define TEST_BENCH_INPUTS             (1024U)       /* Input table length, power of 2 */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t testChecks;             /* Checks executed */
+static uint32_t testFailures;           /* Checks failed */
+static uint32_t testRandomState = 1U;   /* Pseudo random generator state */
+static volatile float testSink;         /* Keeps the benchmarked results alive */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_Check                                                  */
+/* Function parameters: pass - check result, file, line - check location,    */
+/*                      format - printf message of a failure                  */
+/* Function return: None                                                      */
+/* Description: Counts a check and reports it when it fails.                  */
+/******************************************************************************/
+static inline void TEST_Check(bool pass, const char* file, int line, const char* format, ...)
+{
+    va_list args;
+
+    testChecks++;
+    if(pass == false)
+    {
+        testFailures++;
+        printf("%s:%d: FAIL: ", file, line);
+        va_start(args, format);
+        vprintf(format, args);
+        va_end(args);
+        printf("\n");
+    }
+    else
+    {
+        /* No Operation*/
+    }
+}
+
+#define TEST_CHECK(condition, ...)    TEST_Check((condition), __FILE__, __LINE__, __VA_ARGS__)
+
+/******************************************************************************/
+/* Function name: TEST_Result                                                 */
+/* Function parameters: name - test program name                              */
+/* Function return: Process exit code, 0 when every check passed              */
+/* Description: Prints the check summary of the test program.                 */
+/******************************************************************************/
+static inline int TEST_Result(const char* name)
+{
+    printf("%s: %u checks, %u failed\n", name, (unsigned)testChecks, (unsigned)testFailures);
+    return (testFailures == 0U) ? 0 : 1;
+}
+
+/******************************************************************************/
+/* Function name: TEST_Random                                                 */
+/* Function parameters: None                                                  */
+/* Function return: Pseudo random number, 0 to 1                              */
+/* Description: xorshift32 generator, every run sweeps the same inputs.       */
+/******************************************************************************/
+static inline double TEST_Random(void)
+{
+    testRandomState ^= testRandomState << 13;
+    testRandomState ^= testRandomState >> 17;
+    testRandomState ^= testRandomState << 5;
+    return (double)testRandomState / 4294967296.0;
+}
+
+/******************************************************************************/
+/* Function name: TEST_Seconds                                                */
+/* Function parameters: None                                                  */
+/* Function return: Monotonic time, in seconds                                */
+/* Description: Time base of the benchmarks.                                  */
+/******************************************************************************/
+static inline double TEST_Seconds(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec * 1.0e-9);
+}
+
+/* Times TEST_BENCH_CALLS executions of statement and prints ns/call. The
+   statement may use the call counter n, e.g. to walk an input table. */
+#define TEST_BENCH(name, statement)                                           \
+    do                                                                        \
+    {                                                                         \
+        uint32_t n;                                                           \
+        double start = TEST_Seconds();                                        \
+        for(n = 0U; n < TEST_BENCH_CALLS; n++)                                \
+        {                                                                     \
+            statement;                                                        \
+        }                                                                     \
+        printf("  %-28s %8.2f ns/call\n", (name),                             \
+               (TEST_Seconds() - start) * 1.0e9 / (double)TEST_BENCH_CALLS);  \
+    } while(0)
+
+#endif //TEST_COMMON_H
+
+/**
+ End of File
+*/
@@ -0,0 +1,331 @@
+/*******************************************************************************
+  Test Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    test_encoder.c
+
+  Summary:
+    Wrap properties of the encoder count and angle arithmetic
+
+  Description:
+    This file walks a simulated rotor back and forth over many wraps of the
+    16 bit QDEC counter, of the mechanical revolution and of the 32 bit
+    multi-turn position. The counts accumulated through MCAPP_QDECDelta and
+    MCAPP_EncoderCountUpdate must follow the rotor exactly, the mechanical
+    count must be the rotor count modulo one revolution and the binary
+    electrical angle must stay within rounding of the exact angle. The Makefile builds it for several pulse
+    and pole pair counts, including counts which do not divide each other.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <math.h>
+#include "test_common.h"
+#include "definitions.h"
+#include "mc_encoder.h"
+#include "mc_motor_profile.h"
+#include "userparams.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_WALK_STEPS               (4000000UL)   /* Fast loop passes per walk */
+#define TEST_FAST_LOOP_MAX_STEP       (64)          /* Counts per fast loop, above any rated speed */
+#define TEST_COAST_MAX_STEP           (QDEC_HALF_MODULUS - 1) /* Counts between two tracking reads */
+#define TEST_SEGMENT_MAX_STEPS        (20000U)      /* Passes at one speed */
+#define TEST_DELTA_STARTS             (64U)         /* Counter values swept with every delta */
+
+/* Angle rounding: the count to angle step is rounded to half an LSB, a
+   count below one revolution gathers at most half an LSB per count */
+#define TEST_MAX_ANGLE_ERROR_LSB      ((double)ENCODER_PULSES_PER_MREV / 2.0 + 1.0)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Reference Models
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: REF_Modulo                                                  */
+/* Function parameters: value - any count, modulus - positive modulus         */
+/* Function return: value modulo modulus, 0 to modulus - 1                    */
+/* Description: Floored modulo of the rotor count.                            */
+/******************************************************************************/
+static int64_t REF_Modulo(int64_t value, int64_t modulus)
+{
+    int64_t wrapped = value % modulus;
+
+    return (wrapped < 0) ? (wrapped + modulus) : wrapped;
+}
+
+/******************************************************************************/
+/* Function name: REF_AngleQ32                                                */
+/* Function parameters: posCnt - mechanical count                             */
+/* Function return: Exact binary electrical angle, rounded down               */
+/* Description: 2^32 * (posCnt * NUM_POLE_PAIRS modulo one revolution) / PPR. */
+/******************************************************************************/
+static uint32_t REF_AngleQ32(uint32_t posCnt)
+{
+    uint64_t phase = ((uint64_t)posCnt * (uint64_t)NUM_POLE_PAIRS) % (uint64_t)ENCODER_PULSES_PER_MREV;
+
+    return (uint32_t)((phase << 32U) / (uint64_t)ENCODER_PULSES_PER_MREV);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct
+{
+    uint16_t count;     /* Last QDEC count read */
+    uint32_t posCnt;    /* Mechanical count */
+    int32_t  position;  /* Multi-turn count, wraps modulo 2^32 */
+    uint32_t angleQ32;  /* Binary electrical angle */
+} TEST_ENCODER;
+
+/******************************************************************************/
+/* Function name: TEST_CountUpdate                                            */
+/* Function parameters: pEnc - encoder state, count - QDEC count              */
+/* Function return: None                                                      */
+/* Description: Count update of the fast loop and of the encoder tracking in  */
+/*              mc_app.c.                                                     */
+/******************************************************************************/
+static void TEST_CountUpdate(TEST_ENCODER* pEnc, uint16_t count)
+{
+    pEnc->angleQ32 = MCAPP_EncoderCountUpdate(MCAPP_QDECDelta(count, pEnc->count), &pEnc->posCnt, &pEnc->position);
+    pEnc->count = count;
+}
+
+/******************************************************************************/
+/* Function name: TEST_RandomStep                                             */
+/* Function parameters: maxStep - largest step                                */
+/* Function return: Random count step, -maxStep to maxStep                    */
+/* Description: Uniform signed step.                                          */
+/******************************************************************************/
+static int32_t TEST_RandomStep(int32_t maxStep)
+{
+    return (int32_t)floor(TEST_Random() * (double)((2 * maxStep) + 1)) - maxStep;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Checks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_QDECDelta                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Every change within half the counter range, from counter      */
+/*              values at and around both ends of the range.                  */
+/******************************************************************************/
+static void TEST_QDECDelta(void)
+{
+    uint32_t failures = 0U;
+    int64_t start;
+    int32_t delta, result;
+    uint32_t s;
+
+    for(s = 0U; s < TEST_DELTA_STARTS; s++)
+    {
+        switch(s)
+        {
+            case 0U:  start = 0;                              break;
+            case 1U:  start = 1;                              break;
+            case 2U:  start = QDEC_HALF_MODULUS;              break;
+            case 3U:  start = QDEC_COUNTER_MODULUS - 1;       break;
+            default:  start = (int64_t)floor(TEST_Random() * (double)QDEC_COUNTER_MODULUS); break;
+        }
+        for(delta = -QDEC_HALF_MODULUS; delta <= QDEC_HALF_MODULUS; delta++)
+        {
+            result = MCAPP_QDECDelta((uint16_t)REF_Modulo(start + delta, QDEC_COUNTER_MODULUS), (uint16_t)start);
+            if(result != delta)
+            {
+                if(failures == 0U)
+                {
+                    TEST_CHECK(false, "count %d, delta %d unwraps to %d", (int)start, (int)delta, (int)result);
+                }
+                failures++;
+            }
+        }
+    }
+    TEST_CHECK(failures == 0U, "%u deltas unwrapped wrong", (unsigned)failures);
+}
+
+/******************************************************************************/
+/* Function name: TEST_Walk                                                   */
+/* Function parameters: name - printed name, maxStep - largest step between    */
+/*                      two reads                                             */
+/* Function return: None                                                      */
+/* Description: Random walk of the rotor at random speeds in both directions, */
+/*              started just below the counter and position wraps. Checks     */
+/*              the accumulated counts and the angle after every read.        */
+/******************************************************************************/
+static void TEST_Walk(const char* name, int32_t maxStep)
+{
+    TEST_ENCODER enc;
+    int64_t rotor = (int64_t)INT32_MAX - (64 * (int64_t)maxStep);
+    int32_t speed = 0;
+    uint32_t segment = 0U;
+    uint32_t countWraps = 0U;
+    uint32_t failures = 0U;
+    double maxAngleError = 0.0;
+    double angleError;
+    uint16_t count;
+    uint32_t i;
+
+    /* Aligned at rotor count: the multi-turn position is the rotor count */
+    enc.count = (uint16_t)REF_Modulo(rotor, QDEC_COUNTER_MODULUS);
+    enc.posCnt = (uint32_t)REF_Modulo(rotor, ENCODER_PULSES_PER_MREV);
+    enc.position = (int32_t)(uint32_t)rotor;
+    for(i = 0U; i < TEST_WALK_STEPS; i++)
+    {
+        if(segment == 0U)
+        {
+            speed = TEST_RandomStep(maxStep);
+            segment = 1U + (uint32_t)(TEST_Random() * (double)TEST_SEGMENT_MAX_STEPS);
+        }
+        segment--;
+        rotor += speed;
+        count = (uint16_t)REF_Modulo(rotor, QDEC_COUNTER_MODULUS);
+        if(((speed > 0) && (count < enc.count)) || ((speed < 0) && (count > enc.count)))
+        {
+            countWraps++;
+        }
+        TEST_CountUpdate(&enc, count);
+
+        angleError = fabs((double)(int32_t)(enc.angleQ32 - REF_AngleQ32(enc.posCnt)));
+        maxAngleError = fmax(maxAngleError, angleError);
+        if((enc.position != (int32_t)(uint32_t)rotor) ||
+           (enc.posCnt != (uint32_t)REF_Modulo(rotor, ENCODER_PULSES_PER_MREV)) ||
+           (angleError > TEST_MAX_ANGLE_ERROR_LSB))
+        {
+            if(failures == 0U)
+            {
+                TEST_CHECK(false, "%s: rotor %lld, position %d, count %u, angle error %g LSB", name,
+                           (long long)rotor, (int)enc.position, (unsigned)enc.posCnt, angleError);
+            }
+            failures++;
+        }
+    }
+    TEST_CHECK(failures == 0U, "%s: %u reads wrong", name, (unsigned)failures);
+    TEST_CHECK(countWraps > 100U, "%s: only %u counter wraps", name, (unsigned)countWraps);
+    printf("  %-12s %6u counter wraps, max angle error %.3g LSB (%.2e rad)\n", name,
+           (unsigned)countWraps, maxAngleError, maxAngleError * (double)MOTOR_ANGLE_Q32_TO_RAD);
+}
+
+/******************************************************************************/
+/* Function name: TEST_AngleSteps                                             */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: One count moves the angle by one step within rounding, also   */
+/*              across the mechanical revolution wrap.                        */
+/******************************************************************************/
+static void TEST_AngleSteps(void)
+{
+    double step = 4294967296.0 * (double)NUM_POLE_PAIRS / (double)ENCODER_PULSES_PER_MREV;
+    double stepError, maxStepError = 0.0;
+    uint32_t posCnt, next;
+
+    for(posCnt = 0U; posCnt < (uint32_t)ENCODER_PULSES_PER_MREV; posCnt++)
+    {
+        next = MCAPP_EncoderCountWrap((int32_t)posCnt + 1);
+        stepError = fabs(remainder((double)((next * MOTOR_ENCODER_COUNT_TO_ANGLE_Q32) -
+                                            (posCnt * MOTOR_ENCODER_COUNT_TO_ANGLE_Q32)) - step, 4294967296.0));
+        maxStepError = fmax(maxStepError, stepError);
+    }
+    TEST_CHECK(maxStepError <= (TEST_MAX_ANGLE_ERROR_LSB * 2.0), "angle step error %g LSB", maxStepError);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Benchmarks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_Benchmark                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Host ns/call of the count update, with fast loop steps and   */
+/*              with the steps of a coasting rotor.                           */
+/******************************************************************************/
+static void TEST_Benchmark(void)
+{
+    static uint16_t counts[TEST_BENCH_INPUTS];
+    static uint16_t coastCounts[TEST_BENCH_INPUTS];
+    TEST_ENCODER enc = {0U, 0U, 0, 0U};
+    uint32_t i;
+
+    counts[0] = 0U;
+    coastCounts[0] = 0U;
+    for(i = 1U; i < TEST_BENCH_INPUTS; i++)
+    {
+        counts[i] = (uint16_t)REF_Modulo((int64_t)counts[i - 1U] + TEST_RandomStep(TEST_FAST_LOOP_MAX_STEP),
+                                         QDEC_COUNTER_MODULUS);
+        coastCounts[i] = (uint16_t)REF_Modulo((int64_t)coastCounts[i - 1U] + TEST_RandomStep(TEST_COAST_MAX_STEP),
+                                              QDEC_COUNTER_MODULUS);
+    }
+    TEST_BENCH("count update, fast loop", TEST_CountUpdate(&enc, counts[n & (TEST_BENCH_INPUTS - 1U)]));
+    TEST_BENCH("count update, coasting", TEST_CountUpdate(&enc, coastCounts[n & (TEST_BENCH_INPUTS - 1U)]));
+    testSink = (float)enc.angleQ32;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    printf("  %u pulses per revolution, %u pole pairs\n", (unsigned)ENCODER_PULSES_PER_REV, (unsigned)NUM_POLE_PAIRS);
+    TEST_QDECDelta();
+    TEST_Walk("fast loop", TEST_FAST_LOOP_MAX_STEP);
+    TEST_Walk("tracking", TEST_COAST_MAX_STEP);
+    TEST_AngleSteps();
+    TEST_Benchmark();
+    return TEST_Result("test_encoder");
+}
+
+/*******************************************************************************
+ End of File
+*/
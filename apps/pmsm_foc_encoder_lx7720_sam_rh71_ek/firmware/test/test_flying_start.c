@@ -0,0 +1,296 @@
+/*******************************************************************************
+  Test Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    test_flying_start.c
+
+  Summary:
+    Flying start speed measurement and current loop takeover
+
+  Description:
+    This file coasts a simulated rotor, measures its speed with the flying
+    start windows on the stub DWT cycle counter and restarts the current
+    loops on a dq model of the motor. With the q-axis integrator loaded with
+    the back EMF of the measured speed, as MCAPP_FlyingStart in mc_app.c
+    does, the restart must draw almost no current; from a zeroed integrator
+    the back EMF drives a braking current well above MAX_CURRENT. Speeds are
+    checked both ways round, and below FLYING_START_MIN_SPEED_RPM.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <math.h>
+#include "test_common.h"
+#include "definitions.h"
+#include "mclib_generic_float.h"
+#include "mc_flying_start.h"
+#include "mc_motor_profile.h"
+#include "userparams.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+#if(ENABLE_FLYING_START != true)
+#error "test_flying_start needs ENABLE_FLYING_START"
+#endif
+
+#define TEST_COAST_SEC                (0.025)       /* Coast before the restart: two windows */
+#define TEST_BACKGROUND_SEC           (100.0e-6)    /* Background task period while stopped */
+#define TEST_RESTART_SEC              (0.02)        /* Current loop run after the restart */
+#define TEST_SUBSTEPS                 (16U)         /* Model integration steps per fast loop */
+#define TEST_START_CYCLES             (0xFFFF0000U) /* The cycle counter wraps in the first window */
+#define TEST_MAX_FLYING_CURRENT       (0.1)         /* Of MAX_CURRENT */
+
+/* Speed resolution of one window: one count */
+#define TEST_WINDOW_SPEED_STEP        ((2.0 * M_PI * (double)NUM_POLE_PAIRS) / \
+                                       ((double)ENCODER_PULSES_PER_REV * (double)FLYING_START_WINDOW_MS * 1.0e-3))
+
+/* Motor model: peak phase volts per electrical rad/s from the line to line
+   back EMF constant per mechanical krpm */
+#define TEST_FLUX                     (((double)MOTOR_BEMF_CONST_V_PEAK_LL_KRPM_MECH / sqrt(3.0)) / \
+                                       (1000.0 * (2.0 * M_PI / 60.0) * (double)NUM_POLE_PAIRS))
+
+static const double testSpeedsRPM[] = {200.0, 500.0, 1000.0, -500.0, -1000.0};
+
+#define TEST_SPEED_COUNT              (sizeof(testSpeedsRPM) / sizeof(testSpeedsRPM[0]))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Reference Models
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct
+{
+    double id;          /* d-axis current (A) */
+    double iq;          /* q-axis current (A) */
+} REF_MOTOR;
+
+/******************************************************************************/
+/* Function name: REF_MotorStep                                               */
+/* Function parameters: pMotor - currents, vd, vq - dq phase voltages (V),    */
+/*                      omega - electrical speed (rad/s), time - step (s)     */
+/* Function return: None                                                      */
+/* Description: Surface PMSM in the rotor frame, at constant speed: the       */
+/*              rotor inertia is far above what a restart transient moves.    */
+/******************************************************************************/
+static void REF_MotorStep(REF_MOTOR* pMotor, double vd, double vq, double omega, double time)
+{
+    double r = (double)MOTOR_PER_PHASE_RESISTANCE;
+    double l = (double)MOTOR_PER_PHASE_INDUCTANCE;
+    double didt = (vd - (r * pMotor->id) + (omega * l * pMotor->iq)) / l;
+    double diqdt = (vq - (r * pMotor->iq) - (omega * l * pMotor->id) - (omega * TEST_FLUX)) / l;
+
+    pMotor->id += didt * time;
+    pMotor->iq += diqdt * time;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_Coast                                                  */
+/* Function parameters: speedRPM - rotor speed, mechanical                    */
+/* Function return: Start speed of the catch, electrical rad/s                */
+/* Description: Stops the motor at zero loop speed and runs the background    */
+/*              measurement on the encoder count of the coasting rotor.       */
+/******************************************************************************/
+static float TEST_Coast(double speedRPM)
+{
+    double countRate = (speedRPM / 60.0) * (double)ENCODER_PULSES_PER_REV;
+    uint32_t steps = (uint32_t)(TEST_COAST_SEC / TEST_BACKGROUND_SEC);
+    int32_t position0 = 123456;
+    double time;
+    uint32_t i;
+
+    gStubDWT.CYCCNT = TEST_START_CYCLES;
+    MCAPP_FlyingStartReset(0.0f, position0);
+    for(i = 1U; i <= steps; i++)
+    {
+        time = (double)i * TEST_BACKGROUND_SEC;
+        gStubDWT.CYCCNT = TEST_START_CYCLES + (uint32_t)(time * (double)CPU_FREQUENCY);
+        MCAPP_FlyingStartMeasure(position0 + (int32_t)floor(countRate * time));
+    }
+    return MCAPP_FlyingStartCatch();
+}
+
+/******************************************************************************/
+/* Function name: TEST_Restart                                                */
+/* Function parameters: speedRPM - rotor speed, mechanical, vq - q-axis       */
+/*                      integrator at the restart, per unit                   */
+/* Function return: Peak current magnitude after the restart (A)              */
+/* Description: Zero current references on the current loops of mc_app.c:     */
+/*              the currents of one fast loop give the voltages of the next.  */
+/******************************************************************************/
+static double TEST_Restart(double speedRPM, float vq)
+{
+    double omega = speedRPM * (2.0 * M_PI / 60.0) * (double)NUM_POLE_PAIRS;
+    uint32_t steps = (uint32_t)(TEST_RESTART_SEC / (double)FAST_LOOP_TIME_SEC);
+    REF_MOTOR motor = {0.0, 0.0};
+    MCLIB_PI piD = {0};
+    MCLIB_PI piQ = {0};
+    double peak = 0.0;
+    uint32_t i, k;
+
+    piD.kp = D_CURRCNTR_PTERM;
+    piD.ki = D_CURRCNTR_ITERM;
+    piD.kc = D_CURRCNTR_CTERM;
+    piD.outMax = D_CURRCNTR_OUTMAX;
+    piD.outMin = -D_CURRCNTR_OUTMAX;
+    piQ.kp = Q_CURRCNTR_PTERM;
+    piQ.ki = Q_CURRCNTR_ITERM;
+    piQ.kc = Q_CURRCNTR_CTERM;
+    piQ.outMax = Q_CURRCNTR_OUTMAX;
+    piQ.outMin = -Q_CURRCNTR_OUTMAX;
+    piQ.dSum = vq;
+
+    for(i = 0U; i < steps; i++)
+    {
+        piD.inMeas = (float)motor.id;
+        piQ.inMeas = (float)motor.iq;
+        MCLIB_PIControl(&piD);
+        MCLIB_PIControl(&piQ);
+        for(k = 0U; k < TEST_SUBSTEPS; k++)
+        {
+            REF_MotorStep(&motor, (double)piD.out * (double)MOTOR_PHASE_VOLTS_PER_UNIT,
+                          (double)piQ.out * (double)MOTOR_PHASE_VOLTS_PER_UNIT, omega,
+                          (double)FAST_LOOP_TIME_SEC / (double)TEST_SUBSTEPS);
+            peak = fmax(peak, hypot(motor.id, motor.iq));
+        }
+    }
+    return peak;
+}
+
+/******************************************************************************/
+/* Function name: TEST_FeedForward                                            */
+/* Function parameters: speed - start speed, electrical rad/s                 */
+/* Function return: q-axis integrator at the restart, per unit                */
+/* Description: Back EMF of the start speed, limited to the q-axis output, as */
+/*              MCAPP_FlyingStart in mc_app.c loads it.                       */
+/******************************************************************************/
+static float TEST_FeedForward(float speed)
+{
+    return fmaxf(fminf(speed * (MOTOR_BEMF_CONST_VPK_PH_PER_RAD_PER_SEC_ELEC / MOTOR_PHASE_VOLTS_PER_UNIT),
+                       Q_CURRCNTR_OUTMAX), -Q_CURRCNTR_OUTMAX);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Checks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_Catch                                                  */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Measured speed within one count per window, restart current   */
+/*              with and without the back EMF feed forward.                   */
+/******************************************************************************/
+static void TEST_Catch(void)
+{
+    double speedRPM, omega, flying, cold;
+    float speed;
+    uint32_t catches;
+    uint32_t k;
+
+    for(k = 0U; k < TEST_SPEED_COUNT; k++)
+    {
+        speedRPM = testSpeedsRPM[k];
+        omega = speedRPM * (2.0 * M_PI / 60.0) * (double)NUM_POLE_PAIRS;
+        catches = gFlyingStart.catches;
+        speed = TEST_Coast(speedRPM);
+        TEST_CHECK(fabs((double)speed - omega) <= TEST_WINDOW_SPEED_STEP,
+                   "%g rpm: measured %g rad/s, rotor %g rad/s", speedRPM, (double)speed, omega);
+        TEST_CHECK(gFlyingStart.catches == (catches + 1U), "%g rpm: not counted as a catch", speedRPM);
+
+        flying = TEST_Restart(speedRPM, TEST_FeedForward(speed));
+        cold = TEST_Restart(speedRPM, 0.0f);
+        TEST_CHECK(flying < (TEST_MAX_FLYING_CURRENT * (double)MAX_CURRENT),
+                   "%g rpm: flying start peak %g A", speedRPM, flying);
+        TEST_CHECK(cold > (double)MAX_CURRENT, "%g rpm: cold start peak only %g A", speedRPM, cold);
+        printf("  %6.0f rpm: measured %8.2f rad/s (rotor %8.2f), peak current flying %.4f A, cold %.3f A\n",
+               speedRPM, (double)speed, omega, flying, cold);
+    }
+
+    /* Below the min speed the loops start from zero */
+    catches = gFlyingStart.catches;
+    speed = TEST_Coast((double)FLYING_START_MIN_SPEED_RPM / 2.0);
+    TEST_CHECK((speed == 0.0f) && (gFlyingStart.startSpeed == 0.0f), "slow rotor caught at %g rad/s", (double)speed);
+    TEST_CHECK(gFlyingStart.catches == catches, "slow rotor counted as a catch");
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Benchmarks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_Benchmark                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Host ns/call of the background measurement.                   */
+/******************************************************************************/
+static void TEST_Benchmark(void)
+{
+    gStubDWT.CYCCNT = 0U;
+    MCAPP_FlyingStartReset(0.0f, 0);
+    TEST_BENCH("MCAPP_FlyingStartMeasure", gStubDWT.CYCCNT += 10000U; MCAPP_FlyingStartMeasure((int32_t)n));
+    testSink = gFlyingStart.speed;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    TEST_Catch();
+    TEST_Benchmark();
+    return TEST_Result("test_flying_start");
+}
+
+/*******************************************************************************
+ End of File
+*/
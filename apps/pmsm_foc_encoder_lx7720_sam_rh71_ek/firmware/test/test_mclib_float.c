@@ -0,0 +1,476 @@
+/*******************************************************************************
+  Test Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    test_mclib_float.c
+
+  Summary:
+    Golden model checks of the floating point motor control library
+
+  Description:
+    This file checks the floating point library against a double
+    precision reference: sine/cosine, Clarke, Park, inverse Park, the PI
+    controller and the space vector modulation. Each check sweeps the
+    input range the control loop uses and reports the worst error found.
+    The benchmarks print the host ns/call of every routine.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <math.h>
+#include "test_common.h"
+#include "definitions.h"
+#include "mclib_generic_float.h"
+#include "userparams.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_SINCOS_POINTS            (1UL << 20)   /* Angles over the full circle */
+#define TEST_SINCOS_MAX_ERROR         (1.0e-6)      /* Interpolation error of the 4096 point table */
+
+#define TEST_GRID_STEPS               (200U)        /* Steps over -1 to 1 per input */
+#define TEST_TRANSFORM_MAX_ERROR      (1.0e-6)      /* Single precision rounding, inputs within +-1 */
+#define TEST_PARK_ANGLES              (360U)        /* Rotor angles of the Park checks */
+
+#define TEST_SVPWM_MAGNITUDES         (64U)         /* Voltage magnitude steps, 0 to 1 */
+#define TEST_SVPWM_ANGLES             (3600U)       /* Voltage angle steps, 0.1 degree */
+#define TEST_SVPWM_MAX_ERROR          (1.01)        /* Truncation to timer counts plus rounding */
+
+#define TEST_PI_STEPS                 (100000U)     /* Steps of the PI sequences */
+#define TEST_PI_MAX_ERROR             (1.0e-5)      /* Output against the double reference */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Reference Models
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: REF_SVPWM                                                   */
+/* Function parameters: vAlpha, vBeta - voltage reference, 1.0 is the largest */
+/*                      undistorted amplitude, period - PWM period in counts, */
+/*                      duty - phase duties in counts                         */
+/* Function return: None                                                      */
+/* Description: Space vector modulation as inverse Clarke plus min/max common */
+/*              mode injection, in double precision.                          */
+/******************************************************************************/
+static void REF_SVPWM(double vAlpha, double vBeta, double period, double duty[3])
+{
+    double v[3];
+    double vMax;
+    double vMin;
+    uint32_t i;
+
+    v[0] = vAlpha / sqrt(3.0);
+    v[1] = ((-0.5 * vAlpha) + (0.5 * sqrt(3.0) * vBeta)) / sqrt(3.0);
+    v[2] = ((-0.5 * vAlpha) - (0.5 * sqrt(3.0) * vBeta)) / sqrt(3.0);
+    vMax = fmax(fmax(v[0], v[1]), v[2]);
+    vMin = fmin(fmin(v[0], v[1]), v[2]);
+    for(i = 0U; i < 3U; i++)
+    {
+        duty[i] = period * (0.5 + v[i] - (0.5 * (vMax + vMin)));
+    }
+}
+
+/* Double precision copy of the PI controller with back calculation */
+typedef struct
+{
+    double dSum;
+    double out;
+} REF_PI;
+
+/******************************************************************************/
+/* Function name: REF_PIControl                                               */
+/* Function parameters: ref - reference state, pParm - gains and limits of    */
+/*                      the controller under test, inRef, inMeas - inputs     */
+/* Function return: None                                                      */
+/* Description: PI step with output limits and anti windup back calculation.  */
+/******************************************************************************/
+static void REF_PIControl(REF_PI* ref, const MCLIB_PI* pParm, double inRef, double inMeas)
+{
+    double err = inRef - inMeas;
+    double out = ref->dSum + ((double)pParm->kp * err);
+
+    ref->out = fmin(fmax(out, (double)pParm->outMin), (double)pParm->outMax);
+    ref->dSum += ((double)pParm->ki * err) - ((double)pParm->kc * (out - ref->out));
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Checks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_SinCos                                                 */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Sine and cosine against the C library over the full circle.   */
+/******************************************************************************/
+static void TEST_SinCos(void)
+{
+    MCLIB_POSITION position;
+    double error;
+    double maxError = 0.0;
+    double maxNorm = 0.0;
+    uint32_t i;
+
+    for(i = 0U; i < TEST_SINCOS_POINTS; i++)
+    {
+        position.angle = (float)((2.0 * M_PI * (double)i) / (double)TEST_SINCOS_POINTS);
+        MCLIB_SinCosCalc(&position);
+
+        error = fmax(fabs((double)position.sineAngle - sin((double)position.angle)),
+                     fabs((double)position.cosAngle - cos((double)position.angle)));
+        maxError = fmax(maxError, error);
+        maxNorm = fmax(maxNorm, fabs(((double)position.sineAngle * (double)position.sineAngle)
+                                   + ((double)position.cosAngle * (double)position.cosAngle) - 1.0));
+    }
+    printf("  sin/cos max error            %.3g\n", maxError);
+    TEST_CHECK(maxError < TEST_SINCOS_MAX_ERROR, "sin/cos error %g", maxError);
+    TEST_CHECK(maxNorm < (2.0 * TEST_SINCOS_MAX_ERROR), "sin^2 + cos^2 - 1 = %g", maxNorm);
+}
+
+/******************************************************************************/
+/* Function name: TEST_Clarke                                                 */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Clarke transformation against the double reference.           */
+/******************************************************************************/
+static void TEST_Clarke(void)
+{
+    MCLIB_I_ABC abc;
+    MCLIB_I_ALPHA_BETA alphaBeta;
+    double beta;
+    double maxError = 0.0;
+    uint32_t i, j;
+
+    for(i = 0U; i <= TEST_GRID_STEPS; i++)
+    {
+        for(j = 0U; j <= TEST_GRID_STEPS; j++)
+        {
+            abc.ia = (float)(-1.0 + ((2.0 * (double)i) / (double)TEST_GRID_STEPS));
+            abc.ib = (float)(-1.0 + ((2.0 * (double)j) / (double)TEST_GRID_STEPS));
+            abc.ic = -abc.ia - abc.ib;
+            MCLIB_ClarkeTransform(&abc, &alphaBeta);
+
+            beta = ((double)abc.ia + (2.0 * (double)abc.ib)) / sqrt(3.0);
+            maxError = fmax(maxError, fabs((double)alphaBeta.iAlpha - (double)abc.ia));
+            maxError = fmax(maxError, fabs((double)alphaBeta.iBeta - beta));
+        }
+    }
+    printf("  Clarke max error             %.3g\n", maxError);
+    TEST_CHECK(maxError < TEST_TRANSFORM_MAX_ERROR, "Clarke error %g", maxError);
+}
+
+/******************************************************************************/
+/* Function name: TEST_Park                                                   */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Park and inverse Park against the double reference, with the  */
+/*              library sine/cosine: the round trip returns the input and the */
+/*              rotation keeps the vector magnitude.                          */
+/******************************************************************************/
+static void TEST_Park(void)
+{
+    MCLIB_POSITION position;
+    MCLIB_I_ALPHA_BETA iAlphaBeta;
+    MCLIB_I_DQ iDQ;
+    MCLIB_V_DQ vDQ;
+    MCLIB_V_ALPHA_BETA vAlphaBeta;
+    double s, c, id, iq, vAlpha, vBeta;
+    double maxError = 0.0;
+    double maxRoundTrip = 0.0;
+    double maxMagnitude = 0.0;
+    uint32_t k, i, j;
+
+    for(k = 0U; k < TEST_PARK_ANGLES; k++)
+    {
+        position.angle = (float)((2.0 * M_PI * (double)k) / (double)TEST_PARK_ANGLES);
+        MCLIB_SinCosCalc(&position);
+        s = (double)position.sineAngle;
+        c = (double)position.cosAngle;
+
+        for(i = 0U; i <= TEST_GRID_STEPS; i += 4U)
+        {
+            for(j = 0U; j <= TEST_GRID_STEPS; j += 4U)
+            {
+                iAlphaBeta.iAlpha = (float)(-1.0 + ((2.0 * (double)i) / (double)TEST_GRID_STEPS));
+                iAlphaBeta.iBeta = (float)(-1.0 + ((2.0 * (double)j) / (double)TEST_GRID_STEPS));
+                MCLIB_ParkTransform(&iAlphaBeta, &position, &iDQ);
+
+                /* Same sine/cosine values: the transforms alone are checked */
+                id = ((double)iAlphaBeta.iAlpha * c) + ((double)iAlphaBeta.iBeta * s);
+                iq = ((double)iAlphaBeta.iBeta * c) - ((double)iAlphaBeta.iAlpha * s);
+                maxError = fmax(maxError, fmax(fabs((double)iDQ.id - id), fabs((double)iDQ.iq - iq)));
+
+                vDQ.vd = iDQ.id;
+                vDQ.vq = iDQ.iq;
+                MCLIB_InvParkTransform(&vDQ, &position, &vAlphaBeta);
+                vAlpha = ((double)vDQ.vd * c) - ((double)vDQ.vq * s);
+                vBeta = ((double)vDQ.vd * s) + ((double)vDQ.vq * c);
+                maxError = fmax(maxError, fmax(fabs((double)vAlphaBeta.vAlpha - vAlpha),
+                                               fabs((double)vAlphaBeta.vBeta - vBeta)));
+
+                maxRoundTrip = fmax(maxRoundTrip, fmax(fabs((double)vAlphaBeta.vAlpha - (double)iAlphaBeta.iAlpha),
+                                                       fabs((double)vAlphaBeta.vBeta - (double)iAlphaBeta.iBeta)));
+                maxMagnitude = fmax(maxMagnitude, fabs(hypot((double)iDQ.id, (double)iDQ.iq)
+                                                     - hypot((double)iAlphaBeta.iAlpha, (double)iAlphaBeta.iBeta)));
+            }
+        }
+    }
+    printf("  Park/inverse Park max error  %.3g\n", maxError);
+    printf("  Park round trip max error    %.3g\n", maxRoundTrip);
+    TEST_CHECK(maxError < TEST_TRANSFORM_MAX_ERROR, "Park error %g", maxError);
+    TEST_CHECK(maxRoundTrip < (4.0 * (TEST_SINCOS_MAX_ERROR + TEST_TRANSFORM_MAX_ERROR)), "Park round trip error %g", maxRoundTrip);
+    TEST_CHECK(maxMagnitude < (4.0 * (TEST_SINCOS_MAX_ERROR + TEST_TRANSFORM_MAX_ERROR)), "Park magnitude error %g", maxMagnitude);
+}
+
+/******************************************************************************/
+/* Function name: TEST_SVPWM                                                  */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Space vector modulation over the linear range against the     */
+/*              double reference: duties within the period and within one     */
+/*              count of the reference, no step at the sector boundaries.     */
+/******************************************************************************/
+static void TEST_SVPWM(void)
+{
+    MCLIB_V_ALPHA_BETA vAlphaBeta;
+    MCLIB_SVPWM svm = {0};
+    double duty[3];
+    double magnitude, angle, error;
+    double maxError = 0.0;
+    double maxStep = 0.0;
+    uint32_t prevPWM[3] = {0U, 0U, 0U};
+    uint32_t pwm[3];
+    uint32_t m, k, i;
+
+    svm.period = (float)PWM_PERIOD_COUNT;
+    for(m = 0U; m <= TEST_SVPWM_MAGNITUDES; m++)
+    {
+        magnitude = (double)m / (double)TEST_SVPWM_MAGNITUDES;
+        for(k = 0U; k <= TEST_SVPWM_ANGLES; k++)
+        {
+            angle = (2.0 * M_PI * (double)k) / (double)TEST_SVPWM_ANGLES;
+            vAlphaBeta.vAlpha = (float)(magnitude * cos(angle));
+            vAlphaBeta.vBeta = (float)(magnitude * sin(angle));
+            MCLIB_SVPWMGen(&vAlphaBeta, &svm);
+            REF_SVPWM((double)vAlphaBeta.vAlpha, (double)vAlphaBeta.vBeta, (double)svm.period, duty);
+
+            pwm[0] = svm.dPWM1;
+            pwm[1] = svm.dPWM2;
+            pwm[2] = svm.dPWM3;
+            for(i = 0U; i < 3U; i++)
+            {
+                TEST_CHECK(pwm[i] <= (uint32_t)svm.period, "duty %u above the period, |V| %g angle %g",
+                           (unsigned)pwm[i], magnitude, angle);
+                error = fabs((double)pwm[i] - duty[i]);
+                maxError = fmax(maxError, error);
+
+                /* A 0.1 degree step moves a duty by period * |V| * 0.0017 at most */
+                if(k > 0U)
+                {
+                    maxStep = fmax(maxStep, fabs((double)pwm[i] - (double)prevPWM[i])
+                                            - (1.2 * (double)svm.period * magnitude * (2.0 * M_PI / (double)TEST_SVPWM_ANGLES)));
+                }
+                prevPWM[i] = pwm[i];
+            }
+        }
+    }
+    printf("  SVPWM max error              %.3g counts\n", maxError);
+    TEST_CHECK(maxError <= TEST_SVPWM_MAX_ERROR, "SVPWM duty error %g counts", maxError);
+    TEST_CHECK(maxStep <= 2.0, "SVPWM duty step %g counts above the voltage change", maxStep);
+}
+
+/******************************************************************************/
+/* Function name: TEST_PIRun                                                  */
+/* Function parameters: pParm - controller, inRef, inMeas - inputs, steps -   */
+/*                      number of steps                                       */
+/* Function return: Steps until the output leaves the upper limit, steps when */
+/*                  it stays there                                            */
+/* Description: Runs the controller with constant inputs.                     */
+/******************************************************************************/
+static uint32_t TEST_PIRun(MCLIB_PI* pParm, float inRef, float inMeas, uint32_t steps)
+{
+    uint32_t i;
+    uint32_t released = steps;
+
+    pParm->inRef = inRef;
+    pParm->inMeas = inMeas;
+    for(i = 0U; i < steps; i++)
+    {
+        MCLIB_PIControl(pParm);
+        if((released == steps) && (pParm->out < pParm->outMax))
+        {
+            released = i;
+        }
+    }
+    return released;
+}
+
+/******************************************************************************/
+/* Function name: TEST_PI                                                     */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: PI controller against the double reference over a random     */
+/*              sequence that saturates both limits, then the anti windup:    */
+/*              the integrator stays bounded under sustained saturation and   */
+/*              the output leaves the limit as soon as the error reverses.    */
+/******************************************************************************/
+static void TEST_PI(void)
+{
+    MCLIB_PI pi = {0};
+    REF_PI ref = {0.0, 0.0};
+    double maxError = 0.0;
+    double windupLimit;
+    uint32_t i;
+    uint32_t released;
+
+    pi.kp = 0.5f;
+    pi.ki = 0.05f;
+    pi.kc = 0.5f;
+    pi.outMax = 1.0f;
+    pi.outMin = -1.0f;
+    for(i = 0U; i < TEST_PI_STEPS; i++)
+    {
+        pi.inRef = (float)((TEST_Random() * 4.0) - 2.0);
+        pi.inMeas = (float)((TEST_Random() * 4.0) - 2.0);
+        MCLIB_PIControl(&pi);
+        REF_PIControl(&ref, &pi, (double)pi.inRef, (double)pi.inMeas);
+
+        TEST_CHECK((pi.out <= pi.outMax) && (pi.out >= pi.outMin), "PI output %g outside the limits", (double)pi.out);
+        maxError = fmax(maxError, fabs((double)pi.out - ref.out));
+    }
+    printf("  PI max error                 %.3g\n", maxError);
+    TEST_CHECK(maxError < TEST_PI_MAX_ERROR, "PI error %g", maxError);
+
+    /* Constant error e: back calculation settles at dSum = outMax - kp*e + ki*e/kc */
+    pi.dSum = 0.0f;
+    (void)TEST_PIRun(&pi, 1.0f, 0.0f, TEST_PI_STEPS);
+    windupLimit = (double)pi.outMax - (double)pi.kp + ((double)pi.ki / (double)pi.kc);
+    TEST_CHECK(fabs((double)pi.dSum - windupLimit) < TEST_PI_MAX_ERROR, "PI integrator %g, expected %g",
+               (double)pi.dSum, windupLimit);
+    released = TEST_PIRun(&pi, 0.0f, 0.2f, 10U);
+    TEST_CHECK(released == 0U, "PI output left the limit after %u steps", (unsigned)released);
+
+    /* Without back calculation the same sequence winds up */
+    pi.kc = 0.0f;
+    pi.dSum = 0.0f;
+    (void)TEST_PIRun(&pi, 1.0f, 0.0f, TEST_PI_STEPS);
+    released = TEST_PIRun(&pi, 0.0f, 0.2f, TEST_PI_STEPS);
+    TEST_CHECK(released > 1000U, "PI without anti windup left the limit after %u steps", (unsigned)released);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Benchmarks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_Benchmark                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Host ns/call of every library routine.                        */
+/******************************************************************************/
+static void TEST_Benchmark(void)
+{
+    static float angles[TEST_BENCH_INPUTS];
+    static float values[TEST_BENCH_INPUTS];
+    MCLIB_POSITION position;
+    MCLIB_I_ABC abc;
+    MCLIB_I_ALPHA_BETA iAlphaBeta;
+    MCLIB_I_DQ iDQ;
+    MCLIB_V_DQ vDQ;
+    MCLIB_V_ALPHA_BETA vAlphaBeta;
+    MCLIB_SVPWM svm = {0};
+    MCLIB_PI pi = {0};
+    uint32_t i;
+
+    for(i = 0U; i < TEST_BENCH_INPUTS; i++)
+    {
+        angles[i] = (float)((2.0 * M_PI * (double)i) / (double)TEST_BENCH_INPUTS);
+        values[i] = (float)((TEST_Random() * 1.2) - 0.6);
+    }
+    position.angle = angles[1];
+    MCLIB_SinCosCalc(&position);
+    svm.period = (float)PWM_PERIOD_COUNT;
+    pi.kp = 0.5f;
+    pi.ki = 0.05f;
+    pi.kc = 0.5f;
+    pi.outMax = 1.0f;
+    pi.outMin = -1.0f;
+
+    TEST_BENCH("MCLIB_SinCosCalc", position.angle = angles[n & (TEST_BENCH_INPUTS - 1U)];
+               MCLIB_SinCosCalc(&position); testSink = position.sineAngle);
+    TEST_BENCH("MCLIB_ClarkeTransform", abc.ia = values[n & (TEST_BENCH_INPUTS - 1U)];
+               abc.ib = values[(n + 1U) & (TEST_BENCH_INPUTS - 1U)];
+               MCLIB_ClarkeTransform(&abc, &iAlphaBeta); testSink = iAlphaBeta.iBeta);
+    TEST_BENCH("MCLIB_ParkTransform", iAlphaBeta.iAlpha = values[n & (TEST_BENCH_INPUTS - 1U)];
+               MCLIB_ParkTransform(&iAlphaBeta, &position, &iDQ); testSink = iDQ.iq);
+    TEST_BENCH("MCLIB_InvParkTransform", vDQ.vd = values[n & (TEST_BENCH_INPUTS - 1U)]; vDQ.vq = 0.5f;
+               MCLIB_InvParkTransform(&vDQ, &position, &vAlphaBeta); testSink = vAlphaBeta.vBeta);
+    TEST_BENCH("MCLIB_PIControl", pi.inRef = values[n & (TEST_BENCH_INPUTS - 1U)];
+               MCLIB_PIControl(&pi); testSink = pi.out);
+    TEST_BENCH("MCLIB_SVPWMGen", vAlphaBeta.vAlpha = values[n & (TEST_BENCH_INPUTS - 1U)];
+               vAlphaBeta.vBeta = values[(n + 7U) & (TEST_BENCH_INPUTS - 1U)];
+               MCLIB_SVPWMGen(&vAlphaBeta, &svm); testSink = (float)svm.dPWM1);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    TEST_SinCos();
+    TEST_Clarke();
+    TEST_Park();
+    TEST_SVPWM();
+    TEST_PI();
+    TEST_Benchmark();
+    return TEST_Result("test_mclib_float");
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,516 @@
+/*******************************************************************************
+  Test Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    test_mclib_q31.c
+
+  Summary:
+    Golden model checks of the Q31 motor control library
+
+  Description:
+    This file checks the Q31 library against a double precision
+    reference: Clarke, Park, inverse Park, sine/cosine, the PI controller
+    and the space vector modulation. The float library runs on the same
+    inputs, so both implementations are compared with the same reference;
+    the benchmarks print the host ns/call of both. The Makefile also builds
+    it with __ARM_FEATURE_DSP, which selects the saturating instructions.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <math.h>
+#include "test_common.h"
+#include "definitions.h"
+#include "mclib_generic_q31.h"
+#include "userparams.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_Q31_LSB                  (1.0 / 2147483648.0)
+
+#define TEST_GRID_STEPS               (200U)        /* Steps per input over the range */
+#define TEST_TRANSFORM_MAX_ERROR      (8.0 * TEST_Q31_LSB)  /* Truncating multiplies */
+#define TEST_ANGLES                   (1UL << 20)   /* Binary angles over the full circle */
+#define TEST_SINCOS_MAX_ERROR         (4.0e-7)      /* 4096 point linear interpolation */
+#define TEST_PARK_ANGLES              (360U)        /* Rotor angles of the Park checks */
+#define TEST_SVPWM_MAGNITUDES         (64U)         /* Voltage magnitude steps, 0 to 1 */
+#define TEST_SVPWM_ANGLES             (3600U)       /* Voltage angle steps, 0.1 degree */
+#define TEST_SVPWM_MAX_ERROR          (2.0)         /* Duty, in timer counts */
+#define TEST_PI_STEPS                 (100000U)     /* Steps of the PI sequences */
+#define TEST_PI_MAX_ERROR             (1.0e-6)      /* Output against the double reference */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Reference Models
+// *****************************************************************************
+// *****************************************************************************
+
+/* Q31 to double and back, rounded and limited */
+static double REF_FromQ31(int32_t value)
+{
+    return (double)value * TEST_Q31_LSB;
+}
+
+static int32_t REF_ToQ31(double value)
+{
+    return (int32_t)fmax(fmin(round(value / TEST_Q31_LSB), (double)Q31_MAX), (double)Q31_MIN);
+}
+
+/******************************************************************************/
+/* Function name: REF_SVPWM                                                   */
+/* Function parameters: vAlpha, vBeta - voltage reference, 1.0 is the largest */
+/*                      undistorted amplitude, period - PWM period in counts, */
+/*                      duty - phase duties in counts                         */
+/* Function return: None                                                      */
+/* Description: Space vector modulation as inverse Clarke plus min/max common */
+/*              mode injection, in double precision.                          */
+/******************************************************************************/
+static void REF_SVPWM(double vAlpha, double vBeta, double period, double duty[3])
+{
+    double v[3];
+    double vMax;
+    double vMin;
+    uint32_t i;
+
+    v[0] = vAlpha / sqrt(3.0);
+    v[1] = ((-0.5 * vAlpha) + (0.5 * sqrt(3.0) * vBeta)) / sqrt(3.0);
+    v[2] = ((-0.5 * vAlpha) - (0.5 * sqrt(3.0) * vBeta)) / sqrt(3.0);
+    vMax = fmax(fmax(v[0], v[1]), v[2]);
+    vMin = fmin(fmin(v[0], v[1]), v[2]);
+    for(i = 0U; i < 3U; i++)
+    {
+        duty[i] = period * (0.5 + v[i] - (0.5 * (vMax + vMin)));
+    }
+}
+
+/* Double precision copy of the PI controller with back calculation */
+typedef struct
+{
+    double dSum;
+    double out;
+} REF_PI;
+
+/******************************************************************************/
+/* Function name: REF_PIControl                                               */
+/* Function parameters: ref - reference state, pParm - gains and limits of    */
+/*                      the Q31 controller, inRef, inMeas - inputs            */
+/* Function return: None                                                      */
+/* Description: PI step with output limits and anti windup back calculation,  */
+/*              with the quantized gains of the Q31 controller. The excess    */
+/*              fed back is limited to the Q31 range like in the controller.  */
+/******************************************************************************/
+static void REF_PIControl(REF_PI* ref, const MCLIB_PI_Q31* pParm, double inRef, double inMeas)
+{
+    double err = inRef - inMeas;
+    double out = ref->dSum + (ldexp(REF_FromQ31(pParm->kp), (int)pParm->kpShift) * err);
+
+    ref->out = fmin(fmax(out, REF_FromQ31(pParm->outMin)), REF_FromQ31(pParm->outMax));
+    ref->dSum += (REF_FromQ31(pParm->ki) * err) - (REF_FromQ31(pParm->kc) * fmin(fmax(out - ref->out, -1.0), 1.0));
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Checks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_Clarke                                                 */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Clarke transformation against the double reference, phase    */
+/*              currents within +-0.5 so that beta stays within range.        */
+/******************************************************************************/
+static void TEST_Clarke(void)
+{
+    MCLIB_I_ABC_Q31 abcQ31;
+    MCLIB_I_ALPHA_BETA_Q31 alphaBetaQ31;
+    MCLIB_I_ABC abc;
+    MCLIB_I_ALPHA_BETA alphaBeta;
+    double ia, ib, beta;
+    double maxErrorQ31 = 0.0;
+    double maxError = 0.0;
+    uint32_t i, j;
+
+    for(i = 0U; i <= TEST_GRID_STEPS; i++)
+    {
+        for(j = 0U; j <= TEST_GRID_STEPS; j++)
+        {
+            abcQ31.ia = REF_ToQ31(-0.5 + ((double)i / (double)TEST_GRID_STEPS));
+            abcQ31.ib = REF_ToQ31(-0.5 + ((double)j / (double)TEST_GRID_STEPS));
+            abcQ31.ic = -abcQ31.ia - abcQ31.ib;
+            MCLIB_ClarkeTransform_Q31(&abcQ31, &alphaBetaQ31);
+
+            ia = REF_FromQ31(abcQ31.ia);
+            ib = REF_FromQ31(abcQ31.ib);
+            beta = (ia + (2.0 * ib)) / sqrt(3.0);
+            maxErrorQ31 = fmax(maxErrorQ31, fmax(fabs(REF_FromQ31(alphaBetaQ31.iAlpha) - ia),
+                                                 fabs(REF_FromQ31(alphaBetaQ31.iBeta) - beta)));
+
+            abc.ia = (float)ia;
+            abc.ib = (float)ib;
+            abc.ic = -abc.ia - abc.ib;
+            MCLIB_ClarkeTransform(&abc, &alphaBeta);
+            maxError = fmax(maxError, fabs((double)alphaBeta.iBeta - beta));
+        }
+    }
+    printf("  Clarke max error             Q31 %.3g, float %.3g\n", maxErrorQ31, maxError);
+    TEST_CHECK(maxErrorQ31 < TEST_TRANSFORM_MAX_ERROR, "Q31 Clarke error %g", maxErrorQ31);
+}
+
+/******************************************************************************/
+/* Function name: TEST_SinCos                                                 */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Sine and cosine of the binary angle against the double        */
+/*              precision sine/cosine over the full circle.                   */
+/******************************************************************************/
+static void TEST_SinCos(void)
+{
+    MCLIB_POSITION_Q31 positionQ31;
+    MCLIB_POSITION position;
+    double angle;
+    double maxErrorQ31 = 0.0;
+    double maxError = 0.0;
+    uint32_t i;
+
+    for(i = 0U; i < TEST_ANGLES; i++)
+    {
+        positionQ31.angle = i * (uint32_t)(4294967296.0 / (double)TEST_ANGLES) + (i & 0xFFFU);
+        angle = (double)positionQ31.angle * (2.0 * M_PI / 4294967296.0);
+        MCLIB_SinCosCalc_Q31(&positionQ31);
+        maxErrorQ31 = fmax(maxErrorQ31, fmax(fabs(REF_FromQ31(positionQ31.sineAngle) - sin(angle)),
+                                             fabs(REF_FromQ31(positionQ31.cosAngle) - cos(angle))));
+
+        position.angle = (float)angle;
+        MCLIB_SinCosCalc(&position);
+        maxError = fmax(maxError, fmax(fabs((double)position.sineAngle - sin((double)position.angle)),
+                                       fabs((double)position.cosAngle - cos((double)position.angle))));
+    }
+    printf("  sin/cos max error            Q31 %.3g, float %.3g\n", maxErrorQ31, maxError);
+    TEST_CHECK(maxErrorQ31 < TEST_SINCOS_MAX_ERROR, "Q31 sin/cos error %g", maxErrorQ31);
+
+    positionQ31.angle = MCLIB_AngleToQ31((float)(1.5 * M_PI));
+    TEST_CHECK(positionQ31.angle == 0xC0000000U, "binary angle of 3*PI/2 is 0x%08x", (unsigned)positionQ31.angle);
+}
+
+/******************************************************************************/
+/* Function name: TEST_Park                                                   */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Park and inverse Park against the double reference with the   */
+/*              same sine/cosine values, inputs within the unit circle.       */
+/******************************************************************************/
+static void TEST_Park(void)
+{
+    MCLIB_POSITION_Q31 positionQ31;
+    MCLIB_I_ALPHA_BETA_Q31 iAlphaBetaQ31;
+    MCLIB_I_DQ_Q31 iDQQ31;
+    MCLIB_V_DQ_Q31 vDQQ31;
+    MCLIB_V_ALPHA_BETA_Q31 vAlphaBetaQ31;
+    double s, c, alpha, beta, d, q;
+    double maxError = 0.0;
+    uint32_t k, i, j;
+
+    for(k = 0U; k < TEST_PARK_ANGLES; k++)
+    {
+        positionQ31.angle = (uint32_t)((4294967296.0 * (double)k) / (double)TEST_PARK_ANGLES);
+        MCLIB_SinCosCalc_Q31(&positionQ31);
+        s = REF_FromQ31(positionQ31.sineAngle);
+        c = REF_FromQ31(positionQ31.cosAngle);
+
+        for(i = 0U; i <= TEST_GRID_STEPS; i += 4U)
+        {
+            for(j = 0U; j <= TEST_GRID_STEPS; j += 4U)
+            {
+                /* Within +-0.7: the rotated vector stays below 1.0 */
+                alpha = -0.7 + ((1.4 * (double)i) / (double)TEST_GRID_STEPS);
+                beta = -0.7 + ((1.4 * (double)j) / (double)TEST_GRID_STEPS);
+                iAlphaBetaQ31.iAlpha = REF_ToQ31(alpha);
+                iAlphaBetaQ31.iBeta = REF_ToQ31(beta);
+                alpha = REF_FromQ31(iAlphaBetaQ31.iAlpha);
+                beta = REF_FromQ31(iAlphaBetaQ31.iBeta);
+                MCLIB_ParkTransform_Q31(&iAlphaBetaQ31, &positionQ31, &iDQQ31);
+                maxError = fmax(maxError, fmax(fabs(REF_FromQ31(iDQQ31.id) - ((alpha * c) + (beta * s))),
+                                               fabs(REF_FromQ31(iDQQ31.iq) - ((beta * c) - (alpha * s)))));
+
+                vDQQ31.vd = iAlphaBetaQ31.iAlpha;
+                vDQQ31.vq = iAlphaBetaQ31.iBeta;
+                d = alpha;
+                q = beta;
+                MCLIB_InvParkTransform_Q31(&vDQQ31, &positionQ31, &vAlphaBetaQ31);
+                maxError = fmax(maxError, fmax(fabs(REF_FromQ31(vAlphaBetaQ31.vAlpha) - ((d * c) - (q * s))),
+                                               fabs(REF_FromQ31(vAlphaBetaQ31.vBeta) - ((d * s) + (q * c)))));
+            }
+        }
+    }
+    printf("  Park/inverse Park max error  Q31 %.3g\n", maxError);
+    TEST_CHECK(maxError < TEST_TRANSFORM_MAX_ERROR, "Q31 Park error %g", maxError);
+}
+
+/******************************************************************************/
+/* Function name: TEST_SVPWM                                                  */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Space vector modulation over the linear range against the     */
+/*              double reference, duties within the period.                   */
+/******************************************************************************/
+static void TEST_SVPWM(void)
+{
+    MCLIB_V_ALPHA_BETA_Q31 vAlphaBetaQ31;
+    MCLIB_SVPWM_Q31 svmQ31 = {0};
+    MCLIB_V_ALPHA_BETA vAlphaBeta;
+    MCLIB_SVPWM svm = {0};
+    double duty[3];
+    double magnitude, angle;
+    double maxErrorQ31 = 0.0;
+    double maxError = 0.0;
+    uint32_t pwmQ31[3];
+    uint32_t pwm[3];
+    uint32_t m, k, i;
+
+    svmQ31.period = (uint32_t)PWM_PERIOD_COUNT;
+    svm.period = (float)PWM_PERIOD_COUNT;
+    for(m = 0U; m <= TEST_SVPWM_MAGNITUDES; m++)
+    {
+        magnitude = (double)m / (double)TEST_SVPWM_MAGNITUDES;
+        for(k = 0U; k < TEST_SVPWM_ANGLES; k++)
+        {
+            angle = (2.0 * M_PI * (double)k) / (double)TEST_SVPWM_ANGLES;
+            vAlphaBetaQ31.vAlpha = REF_ToQ31(magnitude * cos(angle));
+            vAlphaBetaQ31.vBeta = REF_ToQ31(magnitude * sin(angle));
+            MCLIB_SVPWMGen_Q31(&vAlphaBetaQ31, &svmQ31);
+            REF_SVPWM(REF_FromQ31(vAlphaBetaQ31.vAlpha), REF_FromQ31(vAlphaBetaQ31.vBeta), (double)svmQ31.period, duty);
+
+            vAlphaBeta.vAlpha = (float)REF_FromQ31(vAlphaBetaQ31.vAlpha);
+            vAlphaBeta.vBeta = (float)REF_FromQ31(vAlphaBetaQ31.vBeta);
+            MCLIB_SVPWMGen(&vAlphaBeta, &svm);
+
+            pwmQ31[0] = svmQ31.dPWM1;
+            pwmQ31[1] = svmQ31.dPWM2;
+            pwmQ31[2] = svmQ31.dPWM3;
+            pwm[0] = svm.dPWM1;
+            pwm[1] = svm.dPWM2;
+            pwm[2] = svm.dPWM3;
+            for(i = 0U; i < 3U; i++)
+            {
+                TEST_CHECK(pwmQ31[i] <= svmQ31.period, "Q31 duty %u above the period", (unsigned)pwmQ31[i]);
+                maxErrorQ31 = fmax(maxErrorQ31, fabs((double)pwmQ31[i] - duty[i]));
+                maxError = fmax(maxError, fabs((double)pwm[i] - duty[i]));
+            }
+        }
+    }
+    printf("  SVPWM max error              Q31 %.3g, float %.3g counts\n", maxErrorQ31, maxError);
+    TEST_CHECK(maxErrorQ31 <= TEST_SVPWM_MAX_ERROR, "Q31 SVPWM duty error %g counts", maxErrorQ31);
+}
+
+/******************************************************************************/
+/* Function name: TEST_PI                                                     */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: PI controller converted from the float gains, against the     */
+/*              double reference over a random sequence that saturates both   */
+/*              limits; the integrator stays bounded under saturation.        */
+/******************************************************************************/
+static void TEST_PI(void)
+{
+    MCLIB_PI pi = {0};
+    MCLIB_PI_Q31 piQ31 = {0};
+    REF_PI ref = {0.0, 0.0};
+    double maxError = 0.0;
+    double windupLimit;
+    uint32_t i;
+
+    /* Kp above 1.0 in per unit: exercises kpShift */
+    pi.kp = 0.5f;
+    pi.ki = 0.05f;
+    pi.kc = 0.5f;
+    pi.outMax = 0.9f;
+    pi.outMin = -0.9f;
+    MCLIB_PIParamToQ31(&pi, 4.0f, &piQ31);
+    TEST_CHECK(piQ31.kpShift == 2U, "kpShift %u", (unsigned)piQ31.kpShift);
+
+    for(i = 0U; i < TEST_PI_STEPS; i++)
+    {
+        piQ31.inRef = REF_ToQ31((TEST_Random() * 0.8) - 0.4);
+        piQ31.inMeas = REF_ToQ31((TEST_Random() * 0.8) - 0.4);
+        MCLIB_PIControl_Q31(&piQ31);
+        REF_PIControl(&ref, &piQ31, REF_FromQ31(piQ31.inRef), REF_FromQ31(piQ31.inMeas));
+
+        TEST_CHECK((piQ31.out <= piQ31.outMax) && (piQ31.out >= piQ31.outMin), "Q31 PI output outside the limits");
+        maxError = fmax(maxError, fabs(REF_FromQ31(piQ31.out) - ref.out));
+    }
+    printf("  PI max error                 Q31 %.3g\n", maxError);
+    TEST_CHECK(maxError < TEST_PI_MAX_ERROR, "Q31 PI error %g", maxError);
+
+    /* Constant error e: back calculation settles at dSum = outMax - kp*e + ki*e/kc */
+    piQ31.dSum = 0;
+    piQ31.inRef = REF_ToQ31(0.25);
+    piQ31.inMeas = 0;
+    for(i = 0U; i < TEST_PI_STEPS; i++)
+    {
+        MCLIB_PIControl_Q31(&piQ31);
+    }
+    windupLimit = REF_FromQ31(piQ31.outMax)
+                + (0.25 * ((REF_FromQ31(piQ31.ki) / REF_FromQ31(piQ31.kc)) - ldexp(REF_FromQ31(piQ31.kp), (int)piQ31.kpShift)));
+    TEST_CHECK(fabs(REF_FromQ31(piQ31.dSum) - windupLimit) < TEST_PI_MAX_ERROR, "Q31 PI integrator %g, expected %g",
+               REF_FromQ31(piQ31.dSum), windupLimit);
+    piQ31.inRef = 0;
+    piQ31.inMeas = REF_ToQ31(0.05);
+    MCLIB_PIControl_Q31(&piQ31);
+    TEST_CHECK(piQ31.out < piQ31.outMax, "Q31 PI output stays at the limit after the error reverses");
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Benchmarks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_ChainStages                                            */
+/* Function parameters: cycles - benchmark cycles of one library              */
+/* Function return: Sum of the stage averages                                 */
+/* Description: The rounded down stage averages add up to the chain average  */
+/*              at most.                                                      */
+/******************************************************************************/
+static uint32_t TEST_ChainStages(const MCLIB_CHAIN_CYCLES* cycles)
+{
+    return cycles->sinCos + cycles->clarkePark + cycles->piControl + cycles->invPark + cycles->svpwm;
+}
+
+/******************************************************************************/
+/* Function name: TEST_Benchmark                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Host ns/call of the Q31 and of the float routines, and the    */
+/*              power up benchmark of the target: the stub cycle counter does */
+/*              not run, only the consistency of its stages is checked.       */
+/******************************************************************************/
+static void TEST_Benchmark(void)
+{
+    static int32_t values[TEST_BENCH_INPUTS];
+    static float valuesFloat[TEST_BENCH_INPUTS];
+    MCLIB_POSITION_Q31 positionQ31 = {0U, 0, Q31_MAX};
+    MCLIB_I_ABC_Q31 abcQ31;
+    MCLIB_I_ALPHA_BETA_Q31 iAlphaBetaQ31;
+    MCLIB_I_DQ_Q31 iDQQ31;
+    MCLIB_V_DQ_Q31 vDQQ31;
+    MCLIB_V_ALPHA_BETA_Q31 vAlphaBetaQ31;
+    MCLIB_SVPWM_Q31 svmQ31 = {0};
+    MCLIB_PI_Q31 piQ31 = {0};
+    MCLIB_POSITION position = {0.0f, 0.0f, 1.0f};
+    MCLIB_I_ABC abc;
+    MCLIB_I_ALPHA_BETA iAlphaBeta;
+    MCLIB_I_DQ iDQ;
+    MCLIB_V_DQ vDQ;
+    MCLIB_V_ALPHA_BETA vAlphaBeta;
+    MCLIB_SVPWM svm = {0};
+    MCLIB_PI pi = {0};
+    MCLIB_Q31_BENCHMARK benchmark;
+    uint32_t i;
+
+    for(i = 0U; i < TEST_BENCH_INPUTS; i++)
+    {
+        valuesFloat[i] = (float)((TEST_Random() * 1.0) - 0.5);
+        values[i] = REF_ToQ31((double)valuesFloat[i]);
+    }
+    svmQ31.period = (uint32_t)PWM_PERIOD_COUNT;
+    svm.period = (float)PWM_PERIOD_COUNT;
+    pi.kp = 0.5f;
+    pi.ki = 0.05f;
+    pi.kc = 0.5f;
+    pi.outMax = 0.9f;
+    pi.outMin = -0.9f;
+    MCLIB_PIParamToQ31(&pi, 1.0f, &piQ31);
+
+#define TEST_IN(offset)    (((n) + (offset)) & (TEST_BENCH_INPUTS - 1U))
+    TEST_BENCH("MCLIB_SinCosCalc_Q31", positionQ31.angle = n * 0x9E3779B9U;
+               MCLIB_SinCosCalc_Q31(&positionQ31); testSink = (float)positionQ31.sineAngle);
+    TEST_BENCH("MCLIB_SinCosCalc", position.angle = (float)(n & 0xFFFU) * (TOTAL_SINE_TABLE_ANGLE / 4096.0f);
+               MCLIB_SinCosCalc(&position); testSink = position.sineAngle);
+    TEST_BENCH("MCLIB_ClarkeTransform_Q31", abcQ31.ia = values[TEST_IN(0U)]; abcQ31.ib = values[TEST_IN(1U)];
+               MCLIB_ClarkeTransform_Q31(&abcQ31, &iAlphaBetaQ31); testSink = (float)iAlphaBetaQ31.iBeta);
+    TEST_BENCH("MCLIB_ClarkeTransform", abc.ia = valuesFloat[TEST_IN(0U)]; abc.ib = valuesFloat[TEST_IN(1U)];
+               MCLIB_ClarkeTransform(&abc, &iAlphaBeta); testSink = iAlphaBeta.iBeta);
+    TEST_BENCH("MCLIB_ParkTransform_Q31", iAlphaBetaQ31.iAlpha = values[TEST_IN(0U)];
+               MCLIB_ParkTransform_Q31(&iAlphaBetaQ31, &positionQ31, &iDQQ31); testSink = (float)iDQQ31.iq);
+    TEST_BENCH("MCLIB_ParkTransform", iAlphaBeta.iAlpha = valuesFloat[TEST_IN(0U)];
+               MCLIB_ParkTransform(&iAlphaBeta, &position, &iDQ); testSink = iDQ.iq);
+    TEST_BENCH("MCLIB_InvParkTransform_Q31", vDQQ31.vd = values[TEST_IN(0U)]; vDQQ31.vq = values[TEST_IN(3U)];
+               MCLIB_InvParkTransform_Q31(&vDQQ31, &positionQ31, &vAlphaBetaQ31); testSink = (float)vAlphaBetaQ31.vBeta);
+    TEST_BENCH("MCLIB_InvParkTransform", vDQ.vd = valuesFloat[TEST_IN(0U)]; vDQ.vq = valuesFloat[TEST_IN(3U)];
+               MCLIB_InvParkTransform(&vDQ, &position, &vAlphaBeta); testSink = vAlphaBeta.vBeta);
+    TEST_BENCH("MCLIB_PIControl_Q31", piQ31.inRef = values[TEST_IN(0U)];
+               MCLIB_PIControl_Q31(&piQ31); testSink = (float)piQ31.out);
+    TEST_BENCH("MCLIB_PIControl", pi.inRef = valuesFloat[TEST_IN(0U)];
+               MCLIB_PIControl(&pi); testSink = pi.out);
+    TEST_BENCH("MCLIB_SVPWMGen_Q31", vAlphaBetaQ31.vAlpha = values[TEST_IN(0U)]; vAlphaBetaQ31.vBeta = values[TEST_IN(7U)];
+               MCLIB_SVPWMGen_Q31(&vAlphaBetaQ31, &svmQ31); testSink = (float)svmQ31.dPWM1);
+    TEST_BENCH("MCLIB_SVPWMGen", vAlphaBeta.vAlpha = valuesFloat[TEST_IN(0U)]; vAlphaBeta.vBeta = valuesFloat[TEST_IN(7U)];
+               MCLIB_SVPWMGen(&vAlphaBeta, &svm); testSink = (float)svm.dPWM1);
+#undef TEST_IN
+
+    MCLIB_Q31Benchmark(&pi, 1.0f, &benchmark);
+    TEST_CHECK(TEST_ChainStages(&benchmark.floatCycles) <= benchmark.floatCycles.total, "float chain cycles %u",
+               (unsigned)benchmark.floatCycles.total);
+    TEST_CHECK(TEST_ChainStages(&benchmark.q31Cycles) <= benchmark.q31Cycles.total, "Q31 chain cycles %u",
+               (unsigned)benchmark.q31Cycles.total);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    TEST_Clarke();
+    TEST_SinCos();
+    TEST_Park();
+    TEST_SVPWM();
+    TEST_PI();
+    TEST_Benchmark();
+    return TEST_Result("test_mclib_q31");
+}
+
+/*******************************************************************************
+ End of File
+*/
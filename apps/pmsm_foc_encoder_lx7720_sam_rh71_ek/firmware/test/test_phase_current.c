@@ -0,0 +1,254 @@
+/*******************************************************************************
+  Test Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    test_phase_current.c
+
+  Summary:
+    Equivalence of the divide free phase current scaling
+
+  Description:
+    This file checks the phase current scaling of the fast control loop:
+    the weighted sinc3 sum, less an offset in tenths of a count, times one
+    reciprocal. It is compared with the original divide by 10 and count
+    offset subtraction over the sinc3 range and the offset calibration
+    range, and with the double precision value. The scaling is the one of
+    mc_current_sense.h; the original is copied below as it was before the
+    fast path was made divide free.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <math.h>
+#include "test_common.h"
+#include "mc_current_sense.h"
+#include "mc_offset_calib.h"
+#include "userparams.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_LSB                      (0.000112 / 10.0)     /* Amps of one weighted sum count */
+#define TEST_RANDOM_SAMPLES           (4096U)       /* Random filter states per offset */
+#define TEST_MAX_ERROR_ORIGINAL       (1.0)         /* To the original, in LSB */
+#define TEST_MAX_ERROR_EXACT          (0.05)        /* To the double value, in LSB */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Reference Models
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: REF_PhaseCurrentOriginal                                    */
+/* Function parameters: sinc3 - filter outputs, offset - sinc3 counts         */
+/* Function return: Phase current in Amps                                     */
+/* Description: Original scaling: weighted average by a float divide, then    */
+/*              the offset in whole counts.                                   */
+/******************************************************************************/
+static float REF_PhaseCurrentOriginal(const MCAPP_SINC3* sinc3, uint32_t offset)
+{
+    float temp;
+    float phaseCurrent;
+
+    temp = 2.0f * (float)sinc3->sinc3_out;
+    temp += 4.0f * (float)sinc3->sinc3_out_p;
+    temp += 3.0f * (float)sinc3->sinc3_out_pp;
+    temp += (float)sinc3->sinc3_out_ppp;
+    phaseCurrent = ((float)temp / 10.0f);
+    phaseCurrent = phaseCurrent - (float)(offset);
+    return phaseCurrent * (float)(0.000112);
+}
+
+/******************************************************************************/
+/* Function name: TEST_PhaseCurrent                                           */
+/* Function parameters: sinc3 - filter outputs, offset - tenths of a count    */
+/* Function return: Phase current in Amps                                     */
+/* Description: Divide free scaling, MCAPP_PhaseCurrentSum and the scaling    */
+/*              of MCAPP_ControlLoopISR.                                      */
+/******************************************************************************/
+static float TEST_PhaseCurrent(MCAPP_SINC3* sinc3, uint32_t offset)
+{
+    return (float)MCAPP_PhaseCurrentSum(sinc3, offset) * CURRENT_SUM_TO_AMPS;
+}
+
+/******************************************************************************/
+/* Function name: REF_PhaseCurrentExact                                       */
+/* Function parameters: sinc3 - filter outputs, offset - tenths of a count    */
+/* Function return: Phase current in Amps                                     */
+/* Description: Double precision value of the weighted average less offset.   */
+/******************************************************************************/
+static double REF_PhaseCurrentExact(const MCAPP_SINC3* sinc3, uint32_t offset)
+{
+    double sum = (2.0 * (double)sinc3->sinc3_out) + (4.0 * (double)sinc3->sinc3_out_p)
+               + (3.0 * (double)sinc3->sinc3_out_pp) + (double)sinc3->sinc3_out_ppp;
+
+    return (sum - (double)offset) * TEST_LSB;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Checks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_RandomSinc3                                            */
+/* Function parameters: sinc3 - filter outputs                                */
+/* Function return: None                                                      */
+/* Description: Four random outputs over the sinc3 range.                     */
+/******************************************************************************/
+static void TEST_RandomSinc3(MCAPP_SINC3* sinc3)
+{
+    sinc3->sinc3_out = (uint32_t)(TEST_Random() * (double)(SIGMA_DELTA_SINC3_FULL_SCALE + 1U));
+    sinc3->sinc3_out_p = (uint32_t)(TEST_Random() * (double)(SIGMA_DELTA_SINC3_FULL_SCALE + 1U));
+    sinc3->sinc3_out_pp = (uint32_t)(TEST_Random() * (double)(SIGMA_DELTA_SINC3_FULL_SCALE + 1U));
+    sinc3->sinc3_out_ppp = (uint32_t)(TEST_Random() * (double)(SIGMA_DELTA_SINC3_FULL_SCALE + 1U));
+}
+
+/******************************************************************************/
+/* Function name: TEST_Original                                               */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Every whole count offset of the calibration range, random     */
+/*              filter states and the full sinc3 range with constant current: */
+/*              within one LSB of the original scaling.                       */
+/******************************************************************************/
+static void TEST_Original(void)
+{
+    MCAPP_SINC3 sinc3;
+    double error;
+    double maxError = 0.0;
+    uint32_t offset;
+    uint32_t i;
+
+    for(offset = CURRENT_OFFSET_MIN; offset <= CURRENT_OFFSET_MAX; offset++)
+    {
+        for(i = 0U; i < TEST_RANDOM_SAMPLES; i++)
+        {
+            TEST_RandomSinc3(&sinc3);
+            error = fabs((double)TEST_PhaseCurrent(&sinc3, CURRENT_OFFSET_SCALE * offset)
+                         - (double)REF_PhaseCurrentOriginal(&sinc3, offset)) / TEST_LSB;
+            maxError = fmax(maxError, error);
+        }
+    }
+    for(i = 0U; i <= SIGMA_DELTA_SINC3_FULL_SCALE; i++)
+    {
+        sinc3.sinc3_out = i;
+        sinc3.sinc3_out_p = i;
+        sinc3.sinc3_out_pp = i;
+        sinc3.sinc3_out_ppp = i;
+        offset = (CURRENT_OFFSET_MIN + CURRENT_OFFSET_MAX) / 2U;
+        error = fabs((double)TEST_PhaseCurrent(&sinc3, CURRENT_OFFSET_SCALE * offset)
+                     - (double)REF_PhaseCurrentOriginal(&sinc3, offset)) / TEST_LSB;
+        maxError = fmax(maxError, error);
+    }
+    printf("  max difference to the original  %.3g LSB\n", maxError);
+    TEST_CHECK(maxError <= TEST_MAX_ERROR_ORIGINAL, "difference to the original %g LSB", maxError);
+}
+
+/******************************************************************************/
+/* Function name: TEST_Exact                                                  */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Tracked offsets in tenths of a count: the scaling rounds only */
+/*              once, against the double precision value.                     */
+/******************************************************************************/
+static void TEST_Exact(void)
+{
+    MCAPP_SINC3 sinc3;
+    double error;
+    double maxError = 0.0;
+    uint32_t offset;
+    uint32_t i;
+
+    for(offset = CURRENT_OFFSET_SCALE * CURRENT_OFFSET_MIN; offset <= CURRENT_OFFSET_SCALE * CURRENT_OFFSET_MAX; offset++)
+    {
+        for(i = 0U; i < (TEST_RANDOM_SAMPLES / 16U); i++)
+        {
+            TEST_RandomSinc3(&sinc3);
+            error = fabs((double)TEST_PhaseCurrent(&sinc3, offset) - REF_PhaseCurrentExact(&sinc3, offset)) / TEST_LSB;
+            maxError = fmax(maxError, error);
+        }
+    }
+    printf("  max error to the exact value    %.3g LSB\n", maxError);
+    TEST_CHECK(maxError <= TEST_MAX_ERROR_EXACT, "error to the exact value %g LSB", maxError);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Benchmarks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_Benchmark                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Host ns/call of both scalings.                                */
+/******************************************************************************/
+static void TEST_Benchmark(void)
+{
+    static MCAPP_SINC3 samples[TEST_BENCH_INPUTS];
+    uint32_t i;
+
+    for(i = 0U; i < TEST_BENCH_INPUTS; i++)
+    {
+        TEST_RandomSinc3(&samples[i]);
+    }
+    TEST_BENCH("original, divide", testSink = REF_PhaseCurrentOriginal(&samples[n & (TEST_BENCH_INPUTS - 1U)], 12500U));
+    TEST_BENCH("weighted sum, reciprocal", testSink = TEST_PhaseCurrent(&samples[n & (TEST_BENCH_INPUTS - 1U)], 125000U));
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    TEST_Original();
+    TEST_Exact();
+    TEST_Benchmark();
+    return TEST_Result("test_phase_current");
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,181 @@
+/*******************************************************************************
+  Test Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    test_sincos.c
+
+  Summary:
+    Accuracy and throughput of the selectable sine/cosine
+
+  Description:
+    This file measures the sine/cosine selected by SINCOS_METHOD: the worst
+    error against the double precision sine/cosine over the full circle
+    and at the range ends, and the host ns/call. The Makefile builds it
+    once per implementation, each against its own error bound. The power
+    up benchmark of the target runs too, on the stub cycle counter.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <math.h>
+#include "test_common.h"
+#include "definitions.h"
+#include "mclib_generic_float.h"
+#include "userparams.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_SINCOS_POINTS            (1UL << 22)   /* Angles over the full circle */
+
+#if(SINCOS_METHOD == MCLIB_SINCOS_LUT)
+#define TEST_SINCOS_NAME              "LUT"
+#define TEST_SINCOS_MAX_ERROR         (7.0e-7)      /* 4096 point linear interpolation */
+#elif(SINCOS_METHOD == MCLIB_SINCOS_POLY)
+#define TEST_SINCOS_NAME              "POLY"
+#define TEST_SINCOS_MAX_ERROR         (3.0e-7)      /* Minimax fit plus FMA rounding */
+#elif(SINCOS_METHOD == MCLIB_SINCOS_CORDIC)
+#define TEST_SINCOS_NAME              "CORDIC"
+#define TEST_SINCOS_MAX_ERROR         (4.0e-7)      /* 24 rotations of the Q30 vector */
+#endif
+
+#if(SINCOS_BENCHMARK != true)
+#error "test_sincos runs the power up benchmark, build it with TEST_SINCOS_BENCHMARK=true"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Checks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_SinCosError                                            */
+/* Function parameters: angle - 0 to 2*PI                                     */
+/* Function return: Worst sine/cosine error at this angle                     */
+/* Description: Error against the double precision sine/cosine.              */
+/******************************************************************************/
+static double TEST_SinCosError(float angle)
+{
+    MCLIB_POSITION position;
+
+    position.angle = angle;
+    MCLIB_SinCosCalc(&position);
+    return fmax(fabs((double)position.sineAngle - sin((double)angle)),
+                fabs((double)position.cosAngle - cos((double)angle)));
+}
+
+/******************************************************************************/
+/* Function name: TEST_Accuracy                                               */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Worst error over the full circle, at the quadrant boundaries  */
+/*              and at both ends of the angle range.                          */
+/******************************************************************************/
+static void TEST_Accuracy(void)
+{
+    double maxError = 0.0;
+    float boundary;
+    uint32_t i;
+
+    for(i = 0U; i < TEST_SINCOS_POINTS; i++)
+    {
+        maxError = fmax(maxError, TEST_SinCosError((float)((2.0 * M_PI * (double)i) / (double)TEST_SINCOS_POINTS)));
+    }
+    for(i = 0U; i <= 4U; i++)
+    {
+        /* Both sides of each boundary, where the quadrant selection changes */
+        boundary = (float)((double)i * M_PI_2);
+        maxError = fmax(maxError, TEST_SinCosError(nextafterf(boundary, 0.0f)));
+        maxError = fmax(maxError, TEST_SinCosError(boundary));
+        maxError = fmax(maxError, TEST_SinCosError(nextafterf(boundary, 8.0f)));
+        boundary = (float)(((double)i + 0.5) * M_PI_2);
+        maxError = fmax(maxError, TEST_SinCosError(nextafterf(boundary, 0.0f)));
+        maxError = fmax(maxError, TEST_SinCosError(nextafterf(boundary, 8.0f)));
+    }
+    maxError = fmax(maxError, TEST_SinCosError(nextafterf((float)(2.0 * M_PI), 0.0f)));
+
+    printf("  %-6s max error              %.3g (bound %.3g)\n", TEST_SINCOS_NAME, maxError, TEST_SINCOS_MAX_ERROR);
+    TEST_CHECK(maxError < TEST_SINCOS_MAX_ERROR, TEST_SINCOS_NAME " sin/cos error %g", maxError);
+}
+
+/******************************************************************************/
+/* Function name: TEST_Throughput                                             */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Host ns/call, and the power up benchmark of the target: the   */
+/*              stub cycle counter does not run, its error result is checked. */
+/******************************************************************************/
+static void TEST_Throughput(void)
+{
+    static float angles[TEST_BENCH_INPUTS];
+    MCLIB_POSITION position;
+    MCLIB_SINCOS_BENCHMARK benchmark;
+    uint32_t i;
+
+    for(i = 0U; i < TEST_BENCH_INPUTS; i++)
+    {
+        angles[i] = (float)((2.0 * M_PI * (double)i) / (double)TEST_BENCH_INPUTS);
+    }
+    TEST_BENCH("MCLIB_SinCosCalc " TEST_SINCOS_NAME, position.angle = angles[n & (TEST_BENCH_INPUTS - 1U)];
+               MCLIB_SinCosCalc(&position); testSink = position.sineAngle + position.cosAngle);
+
+    MCLIB_SinCosBenchmark(&benchmark);
+    TEST_CHECK((benchmark.cyclesMin <= benchmark.cyclesAvg) && (benchmark.cyclesAvg <= benchmark.cyclesMax),
+               "benchmark cycles %u/%u/%u", (unsigned)benchmark.cyclesMin, (unsigned)benchmark.cyclesAvg,
+               (unsigned)benchmark.cyclesMax);
+    TEST_CHECK((double)benchmark.maxError < (TEST_SINCOS_MAX_ERROR + 2.0e-7), "benchmark error %g",
+               (double)benchmark.maxError);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    TEST_Accuracy();
+    TEST_Throughput();
+    return TEST_Result("test_sincos_" TEST_SINCOS_NAME);
+}
+
+/*******************************************************************************
+ End of File
+*/
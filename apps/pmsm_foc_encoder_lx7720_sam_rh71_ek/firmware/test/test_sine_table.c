@@ -0,0 +1,178 @@
+/*******************************************************************************
+  Test Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    test_sine_table.c
+
+  Summary:
+    Quarter wave table checks of the interpolated sine/cosine
+
+  Description:
+    This file checks the quarter wave table of the LUT sine/cosine: every
+    entry against the double precision sine, a strictly rising and concave
+    table without repeated spans, and the interpolated sine/cosine against
+    sinf/cosf over the full circle. The library source is included to
+    reach the static table.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <math.h>
+#include "test_common.h"
+#include "../src/mclib_generic_float.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+#if(SINCOS_METHOD != MCLIB_SINCOS_LUT)
+#error "test_sine_table checks the MCLIB_SINCOS_LUT build"
+#endif
+
+#define TEST_TABLE_MAX_ERROR          (6.0e-8)      /* Half a float step at 1.0 */
+#define TEST_CIRCLE_POINTS            (1UL << 22)   /* Angles over the full circle */
+#define TEST_CIRCLE_MAX_ERROR         (1.0e-6)      /* Interpolation plus sinf/cosf rounding */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Checks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_Table                                                  */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Entry k must hold sin(k * PI / (2 * SINE_TABLE_SIZE)). A      */
+/*              repeated span breaks the rise and the concavity of the table */
+/*              and shifts every entry after it.                              */
+/******************************************************************************/
+static void TEST_Table(void)
+{
+    double expected;
+    double error;
+    double maxError = 0.0;
+    uint32_t k;
+
+    TEST_CHECK(sineTable[0] == 0.0f, "first entry %g", (double)sineTable[0]);
+    TEST_CHECK(sineTable[SINE_TABLE_SIZE] == 1.0f, "last entry %g", (double)sineTable[SINE_TABLE_SIZE]);
+
+    for(k = 0U; k <= SINE_TABLE_SIZE; k++)
+    {
+        expected = sin(((double)k * M_PI) / (2.0 * (double)SINE_TABLE_SIZE));
+        error = fabs((double)sineTable[k] - expected);
+        maxError = fmax(maxError, error);
+        TEST_CHECK(error < TEST_TABLE_MAX_ERROR, "entry %u is %.9g, expected %.9g",
+                   (unsigned)k, (double)sineTable[k], expected);
+        TEST_CHECK(fabs((double)sineTable[k] - (double)sinf((float)(((double)k * M_PI) / (2.0 * (double)SINE_TABLE_SIZE))))
+                   < TEST_TABLE_MAX_ERROR, "entry %u differs from sinf", (unsigned)k);
+
+        if(k > 0U)
+        {
+            TEST_CHECK(sineTable[k] > sineTable[k - 1U], "entry %u does not rise", (unsigned)k);
+        }
+        if(k > 1U)
+        {
+            /* Concave: the steps shrink towards PI/2, within the entry rounding */
+            TEST_CHECK(((double)sineTable[k] - (double)sineTable[k - 1U])
+                       <= (((double)sineTable[k - 1U] - (double)sineTable[k - 2U]) + (4.0 * TEST_TABLE_MAX_ERROR)),
+                       "step to entry %u grows", (unsigned)k);
+        }
+    }
+    printf("  table max error              %.3g\n", maxError);
+}
+
+/******************************************************************************/
+/* Function name: TEST_Circle                                                 */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Interpolated sine/cosine against sinf/cosf over the full      */
+/*              circle, exact at the quadrant boundaries.                     */
+/******************************************************************************/
+static void TEST_Circle(void)
+{
+    MCLIB_POSITION position;
+    double error;
+    double maxError = 0.0;
+    uint32_t i;
+
+    for(i = 0U; i < TEST_CIRCLE_POINTS; i++)
+    {
+        position.angle = (float)((2.0 * M_PI * (double)i) / (double)TEST_CIRCLE_POINTS);
+        MCLIB_SinCosCalc(&position);
+        error = fmax(fabs((double)position.sineAngle - (double)sinf(position.angle)),
+                     fabs((double)position.cosAngle - (double)cosf(position.angle)));
+        maxError = fmax(maxError, error);
+    }
+    printf("  sin/cos max error to sinf    %.3g\n", maxError);
+    TEST_CHECK(maxError < TEST_CIRCLE_MAX_ERROR, "sin/cos error %g", maxError);
+
+    position.angle = 0.0f;
+    MCLIB_SinCosCalc(&position);
+    TEST_CHECK((position.sineAngle == 0.0f) && (position.cosAngle == 1.0f), "sin/cos(0) = %g, %g",
+               (double)position.sineAngle, (double)position.cosAngle);
+    for(i = 1U; i < 4U; i++)
+    {
+        position.angle = (float)i * SINCOS_QUADRANT_ANGLE;
+        MCLIB_SinCosCalc(&position);
+        error = fmax(fabs((double)position.sineAngle - sin((double)i * M_PI_2)),
+                     fabs((double)position.cosAngle - cos((double)i * M_PI_2)));
+        TEST_CHECK(error < TEST_CIRCLE_MAX_ERROR, "sin/cos at quadrant %u error %g", (unsigned)i, error);
+    }
+
+    TEST_BENCH("MCLIB_SinCosCalc", position.angle = (float)(n & 0xFFFU) * (TOTAL_SINE_TABLE_ANGLE / 4096.0f);
+               MCLIB_SinCosCalc(&position); testSink = position.sineAngle + position.cosAngle);
+    TEST_BENCH("sinf + cosf", position.angle = (float)(n & 0xFFFU) * (TOTAL_SINE_TABLE_ANGLE / 4096.0f);
+               testSink = sinf(position.angle) + cosf(position.angle));
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    TEST_Table();
+    TEST_Circle();
+    return TEST_Result("test_sine_table");
+}
+
+/*******************************************************************************
+ End of File
+*/
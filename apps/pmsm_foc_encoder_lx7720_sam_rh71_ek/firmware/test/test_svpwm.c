@@ -0,0 +1,201 @@
+/*******************************************************************************
+  Test Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    test_svpwm.c
+
+  Summary:
+    Equivalence of the sector and the min/max injection SVPWM
+
+  Description:
+    This file runs both SVPWM implementations on an exhaustive grid of the
+    linear modulation range and checks that their duties agree within one
+    PWM count. The Makefile links a second build of the library with
+    SVPWM_METHOD set to MCLIB_SVPWM_MINMAX and its routines renamed. The
+    benchmarks compare a fixed vector with vectors spread over all sectors,
+    which shows the branch dependence of the sector tree.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <math.h>
+#include "test_common.h"
+#include "definitions.h"
+#include "mclib_generic_float.h"
+#include "userparams.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+#if(SVPWM_METHOD != MCLIB_SVPWM_SECTOR)
+#error "test_svpwm compares the MCLIB_SVPWM_SECTOR build with the min/max build"
+#endif
+
+#define TEST_GRID_STEPS               (2000U)       /* Steps per axis over -1 to 1 */
+#define TEST_MAX_DIFFERENCE           (1U)          /* Duty, in timer counts */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/* Min/max injection build of mclib_generic_float.c */
+void MCLIB_SVPWMGen_MinMax( const MCLIB_V_ALPHA_BETA* restrict vAlphaBeta, MCLIB_SVPWM* restrict svm );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Checks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_DutyDifference                                         */
+/* Function parameters: duty1, duty2 - duties in counts, maxDifference -      */
+/*                      largest difference so far                             */
+/* Function return: Largest difference including this pair                    */
+/* Description: Absolute difference of two duties.                            */
+/******************************************************************************/
+static uint32_t TEST_DutyDifference(uint32_t duty1, uint32_t duty2, uint32_t maxDifference)
+{
+    uint32_t difference = (duty1 > duty2) ? (duty1 - duty2) : (duty2 - duty1);
+
+    return (difference > maxDifference) ? difference : maxDifference;
+}
+
+/******************************************************************************/
+/* Function name: TEST_Grid                                                   */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Every grid point inside the unit circle: the duties of both   */
+/*              implementations differ by one count at most.                  */
+/******************************************************************************/
+static void TEST_Grid(void)
+{
+    MCLIB_V_ALPHA_BETA vAlphaBeta;
+    MCLIB_SVPWM sector = {0};
+    MCLIB_SVPWM minMax = {0};
+    uint32_t difference;
+    uint32_t maxDifference = 0U;
+    uint32_t points = 0U;
+    uint32_t exact = 0U;
+    uint32_t i, j;
+
+    sector.period = (float)PWM_PERIOD_COUNT;
+    minMax.period = (float)PWM_PERIOD_COUNT;
+    for(i = 0U; i <= TEST_GRID_STEPS; i++)
+    {
+        for(j = 0U; j <= TEST_GRID_STEPS; j++)
+        {
+            vAlphaBeta.vAlpha = (float)(-1.0 + ((2.0 * (double)i) / (double)TEST_GRID_STEPS));
+            vAlphaBeta.vBeta = (float)(-1.0 + ((2.0 * (double)j) / (double)TEST_GRID_STEPS));
+            if(hypot((double)vAlphaBeta.vAlpha, (double)vAlphaBeta.vBeta) <= 1.0)
+            {
+                MCLIB_SVPWMGen(&vAlphaBeta, &sector);
+                MCLIB_SVPWMGen_MinMax(&vAlphaBeta, &minMax);
+
+                difference = TEST_DutyDifference(sector.dPWM1, minMax.dPWM1, 0U);
+                difference = TEST_DutyDifference(sector.dPWM2, minMax.dPWM2, difference);
+                difference = TEST_DutyDifference(sector.dPWM3, minMax.dPWM3, difference);
+                TEST_CHECK(difference <= TEST_MAX_DIFFERENCE, "duties %u/%u/%u and %u/%u/%u at %g, %g",
+                           (unsigned)sector.dPWM1, (unsigned)sector.dPWM2, (unsigned)sector.dPWM3,
+                           (unsigned)minMax.dPWM1, (unsigned)minMax.dPWM2, (unsigned)minMax.dPWM3,
+                           (double)vAlphaBeta.vAlpha, (double)vAlphaBeta.vBeta);
+                maxDifference = (difference > maxDifference) ? difference : maxDifference;
+                exact += (difference == 0U) ? 1U : 0U;
+                points++;
+            }
+        }
+    }
+    printf("  %u points, %.2f%% identical, max difference %u count\n", (unsigned)points,
+           (100.0 * (double)exact) / (double)points, (unsigned)maxDifference);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Benchmarks
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: TEST_Benchmark                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Host ns/call of both implementations, for one fixed vector    */
+/*              and for vectors in random sectors.                            */
+/******************************************************************************/
+static void TEST_Benchmark(void)
+{
+    static MCLIB_V_ALPHA_BETA vectors[TEST_BENCH_INPUTS];
+    MCLIB_V_ALPHA_BETA fixed = {0.5f, 0.2f};
+    MCLIB_SVPWM svm = {0};
+    double angle;
+    uint32_t i;
+
+    for(i = 0U; i < TEST_BENCH_INPUTS; i++)
+    {
+        angle = 2.0 * M_PI * TEST_Random();
+        vectors[i].vAlpha = (float)(0.9 * cos(angle));
+        vectors[i].vBeta = (float)(0.9 * sin(angle));
+    }
+    svm.period = (float)PWM_PERIOD_COUNT;
+
+    TEST_BENCH("sector, fixed vector", MCLIB_SVPWMGen(&fixed, &svm); testSink = (float)svm.dPWM1);
+    TEST_BENCH("sector, random sectors", MCLIB_SVPWMGen(&vectors[n & (TEST_BENCH_INPUTS - 1U)], &svm);
+               testSink = (float)svm.dPWM1);
+    TEST_BENCH("min/max, fixed vector", MCLIB_SVPWMGen_MinMax(&fixed, &svm); testSink = (float)svm.dPWM1);
+    TEST_BENCH("min/max, random sectors", MCLIB_SVPWMGen_MinMax(&vectors[n & (TEST_BENCH_INPUTS - 1U)], &svm);
+               testSink = (float)svm.dPWM1);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    TEST_Grid();
+    TEST_Benchmark();
+    return TEST_Result("test_svpwm");
+}
+
+/*******************************************************************************
+ End of File
+*/